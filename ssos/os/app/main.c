@@ -4,6 +4,7 @@
 #include "../mem/memory.h"
 #include "../gfx/gfx.h"
 #include "../win/win.h"
+#include "../win/compositor.h"
 #include "../ipc/ipc.h"
 #include "scene.h"
 
@@ -18,9 +19,30 @@ void ss_init(void) {
     ss_work_init(&ss_main_work_queue);
     ss_ipc_init();
     ss_gfx_init();
+    /* Keep the window table on the heap: .data+.bss is the scarce region.
+     * A failed allocation leaves no windows (ss_win_create returns 0). */
+    ss_win_set_storage(ss_alloc(SS_WIN_STORAGE_SIZE(SS_WIN_HEAP_WINDOWS)),
+                       SS_WIN_STORAGE_SIZE(SS_WIN_HEAP_WINDOWS));
     ss_win_init();
 }
 
-void ss_run(void) {
+/* The scene is the compositor: the one task that draws.  It shares the
+ * main task's priority so application tasks started beside it get their
+ * turn while it waits for vsync. */
+#define SS_COMP_PRI 8
+
+static void* compositor_main(void* arg) {
+    (void)arg;
     ss_scene_run(NULL, NULL);
+    return NULL;
+}
+
+void ss_run(void) {
+    if (ss_comp_start(compositor_main, SS_COMP_PRI) != SS_OK) {
+        ss_scene_run(NULL, NULL);
+        return;
+    }
+    /* Application tasks are started from here.  The main task then idles,
+     * so the compositor and the applications can all block. */
+    ss_task_idle();
 }
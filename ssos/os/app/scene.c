@@ -1,30 +1,39 @@
 #include "../kernel/kernel.h"
 #include "../kernel/scheduler.h"
 #include "../kernel/work_queue.h"
+#include "../kernel/input.h"
+#include "../kernel/input_iocs.h"
 #include "../gfx/gfx.h"
 #include "../gfx/palette.h"
+#include "../gfx/cursor.h"
+#include "../gfx/dlist.h"
+#include "../gfx/overlay.h"
 #include "../win/win.h"
+#include "../win/textgrid.h"
+#include "../win/compositor.h"
 #include "../ipc/ipc.h"
 #include "../util/numfmt.h"
 #include "scene.h"
 #include <stdint.h>
 #include <string.h>
-#include <x68k/iocs.h>
 
-/* Drag state. The drag outline is a self-erasing XOR rectangle
- * (ss_gfx_xor_rect): no save buffer, no GVRAM read, and it is redrawn
- * only when the mouse actually moves — the old hot path read+restored
- * the full window perimeter every frame. */
+/* Drag state. An opaque drag moves the window every frame; the fallback
+ * outline is a frame on the text VRAM overlay, or a self-erasing XOR
+ * rectangle (ss_gfx_xor_rect) without it: no save buffer, and it is
+ * redrawn only when the mouse actually moves — the old hot path
+ * read+restored the full window perimeter every frame. */
 static int drag_id = -1;
 static int drag_ox, drag_oy;
 static int drag_w, drag_h;
 static int drag_prev_x = -1, drag_prev_y = -1;
-/* Start above the initial window z range (1..3) so the first dragged
- * window can't share a z with an existing window.  Otherwise ss_win_active_z
- * would match BOTH the dragged window AND the pre-existing top window,
- * painting both as active (gray + hash stripes). */
-static uint16_t next_z = 4;
+static int drag_opaque = 0;
+/* Set when the drag switches to the outline; it is drawn after the frame's
+ * damage flush so the repaint of the exposed strip does not overwrite it. */
+static int drag_outline_pending = 0;
+/* The previous frame's work ran past a vsync. */
+static int frame_missed = 0;
 static uint32_t frame = 0;   /* vsync counter shown in the Timer window */
+static uint32_t frames_rendered, frames_skipped;
 
 /* Previous active window: saved at drag start so we can repaint it on
  * release when its is_fg flips (render_region's small rect won't
@@ -38,7 +47,7 @@ static int prev_active_x, prev_active_y, prev_active_w, prev_active_h;
 #define LINE_H    10
 #define WIN_W     240
 #define WIN_H     (CONTENT_Y + 3 * LINE_H + 4)
-#define LINE_LEN  28
+#define LINE_LEN  SS_TGRID_COLS
 
 /* Keep scene rendering in logical colours: the standalone host may select
  * either a 16- or 256-colour CRTC mode before entering this shared code. */
@@ -54,232 +63,170 @@ const SSSceneWindowSpec ss_scene_default_windows[SS_SCENE_WINDOW_COUNT] = {
 
 typedef struct {
     char title[20];
-    char line[3][30];
-    char prev[3][30];
+    SSTextGrid grid;
 } WinContent;
 static WinContent win_content[SS_SCENE_WINDOW_COUNT];
 
 static int wait_vsync(void) {
     /* Baremetal has no watchdog hook. premain must install V-DISP before
      * entering this scene; a stopped V-DISP is a hard failure here rather
-     * than an attempt at host-specific MFP recovery. */
+     * than an attempt at host-specific MFP recovery.  Other tasks run
+     * while it waits. */
     uint32_t last = ss_vsync_counter;
-    while (ss_vsync_counter == last);
+    while (ss_vsync_counter == last) ss_task_yield();
     return 0;
 }
 
 static int cur_mx = 0, cur_my = 0, cur_btn = 0;
-static void update_mouse(void) {
-    /* MS_CURGT (0x75): high word = X, low word = Y.
-     * MS_GETDT (0x74): button state (bit9 = left, bit0 = right). */
-    int pos = _iocs_ms_curgt();
-    int dt  = _iocs_ms_getdt();
-    cur_mx = (int16_t)((pos >> 16) & 0xFFFF);
-    cur_my = (int16_t)(pos & 0xFFFF);
-    cur_btn = dt;
-}
-
 static int last_key = -1;
-static void update_keyboard(void) {
-    if (_iocs_b_keysns() > 0) {
-        last_key = _iocs_b_keyinp();
-    }
-}
 
-/* Software cursor (6x6) XOR outline position; -1 means "not on screen".
- * Drawing/erasing is done via the shared self-erasing ss_gfx_xor_rect. */
-static int cur_prev_x = -1, cur_prev_y = -1;
+/* Each window is a retained display list, built once at creation in
+ * window-relative coordinates: the frame rects, the hash stripes of the
+ * active title, the title and the three content lines.  The line nodes
+ * point at the rows of win_content[].grid, so a content change only queues
+ * the changed cells and the compositor replays the line node clipped to
+ * them, through the window's visible region. */
+#define SCENE_DL_NODES 24
 
-static void pad_line(char* s, int n) {
-    int l = (int)strlen(s);
-    for (int i = l; i < n; i++) s[i] = ' ';
-    s[n] = '\0';
-}
+static SSDlNode win_nodes[SS_SCENE_WINDOW_COUNT][SCENE_DL_NODES];
+static SSDisplayList win_dl[SS_SCENE_WINDOW_COUNT];
 
-/* Build the visible windows in z order so incremental text updates can skip
- * pixels covered by a higher window.  Direct text writes would otherwise
- * punch through the single-page compositor while windows overlap. */
-static int build_text_clip_windows(uint16_t target,
-                                   int clip_wins[SS_SCENE_WINDOW_COUNT * 4],
-                                   int* target_pos) {
-    uint16_t order[SS_SCENE_WINDOW_COUNT];
-    int n = 0;
-    for (int id = 1; id <= SS_SCENE_WINDOW_COUNT; id++) {
-        SSWindow* w = ss_win_get_ptr((uint16_t)id);
-        if (w == NULL || !(w->flags & SS_WIN_VISIBLE)) continue;
-        int j = n;
-        while (j > 0 && ss_win_get_z(order[j - 1]) > w->z) {
-            order[j] = order[j - 1];
-            j--;
-        }
-        order[j] = (uint16_t)id;
-        n++;
+typedef struct {
+    int8_t bar, title, stripe_first, stripe_count;
+    int8_t line[3];
+    int8_t fg;          /* active look the nodes carry, -1 before the first */
+} WinNodes;
+static WinNodes win_nodes_at[SS_SCENE_WINDOW_COUNT];
+
+static void build_win_list(uint16_t id, int w, int h) {
+    SSDisplayList* dl = &win_dl[id - 1];
+    WinNodes* n = &win_nodes_at[id - 1];
+    WinContent* c = &win_content[id - 1];
+
+    ss_dl_init(dl, win_nodes[id - 1], SCENE_DL_NODES);
+    n->bar = (int8_t)ss_dl_rect(dl, 1, 1, w - 2, TITLE_H - 2, PAL_WHITE);
+    ss_dl_rect(dl, 1, TITLE_H, w - 2, h - TITLE_H - 1, PAL_WHITE);
+    ss_dl_rect(dl, 0, 0, w, 1, PAL_BLACK);
+    ss_dl_rect(dl, 0, h - 1, w, 1, PAL_BLACK);
+    ss_dl_rect(dl, 0, 0, 1, h, PAL_BLACK);
+    ss_dl_rect(dl, w - 1, 0, 1, h, PAL_BLACK);
+    ss_dl_rect(dl, 1, TITLE_H - 1, w - 2, 1, PAL_BLACK);
+
+    /* black hash stripes on both sides of the title (standalone look),
+     * shown only while the window is active */
+    int tw = (int)strlen(c->title) * SS_FONT_ADV;
+    int tx = (w - tw) / 2;
+    n->stripe_first = (int8_t)dl->count;
+    for (int i = 0; i < 5; i++) {
+        int ly = 2 + i * 2;
+        if (tx > 12)
+            ss_dl_rect(dl, 4, ly, tx - 8 - 4 + 1, 1, PAL_BLACK);
+        if (tx + tw + 8 < w - 4)
+            ss_dl_rect(dl, tx + tw + 8, ly, (w - 5) - (tx + tw + 8) + 1, 1, PAL_BLACK);
     }
-    *target_pos = -1;
-    for (int i = 0; i < n; i++) {
-        SSWindow* w = ss_win_get_ptr(order[i]);
-        clip_wins[i * 4] = w->x;
-        clip_wins[i * 4 + 1] = w->y;
-        clip_wins[i * 4 + 2] = w->w;
-        clip_wins[i * 4 + 3] = w->h;
-        if (order[i] == target) *target_pos = i;
+    n->stripe_count = (int8_t)(dl->count - n->stripe_first);
+    n->title = (int8_t)ss_dl_text(dl, tx, 2, c->title, PAL_BLACK, PAL_WHITE);
+    ss_tgrid_init(&c->grid);                /* nodes keep a fixed width */
+    for (int i = 0; i < 3; i++) {
+        n->line[i] = (int8_t)ss_dl_text(dl, 4, CONTENT_Y + i * LINE_H,
+                                        c->grid.cell[i], PAL_BLACK, PAL_WHITE);
     }
-    return n;
+    n->fg = -1;
 }
 
-static void draw_content_dirty(uint16_t id) {
+/* Queue the changed cells of each content line, one rect per run of
+ * adjacent changed cells: "Vsync: 100" -> "Vsync: 101" is a one-cell
+ * repaint, and so is a change at the start of a line.  The grid pads
+ * lines with spaces, so a shrinking value marks the cells it vacates.
+ * Overlapping windows are handled by the compositor. */
+static void queue_content_damage(uint16_t id) {
     if (id == 0 || id > SS_SCENE_WINDOW_COUNT) return;
-    int x = ss_win_get_x(id), y = ss_win_get_y(id);
     WinContent* c = &win_content[id - 1];
-    int clip_wins[SS_SCENE_WINDOW_COUNT * 4];
-    int target_pos;
-    int nclip = build_text_clip_windows(id, clip_wins, &target_pos);
+    WinNodes* n = &win_nodes_at[id - 1];
     for (int i = 0; i < 3; i++) {
-        if (memcmp(c->line[i], c->prev[i], 30) != 0) {
-            /* Redraw only the changed suffix: lines are pad_line'd to
-             * LINE_LEN and left-aligned, so the first differing column
-             * is where the visible change starts. Redrawing from there
-             * to the (space-padded) tail handles both growth and erase.
-             * Turns "Vsync: 100" -> "Vsync: 101" into a 1-char repaint. */
-            int j = 0;
-            while (j < LINE_LEN && c->line[i][j] == c->prev[i][j]) j++;
-            int tx = x + 4 + j * SS_FONT_ADV;
-            int ty = y + CONTENT_Y + i * LINE_H;
-            int tw = (LINE_LEN - j - 1) * SS_FONT_ADV + SS_FONT_W;
-            int covered = 0;
-            for (int k = target_pos + 1; k < nclip; k++) {
-                int* upper = &clip_wins[k * 4];
-                if (tx < upper[0] + upper[2] && tx + tw > upper[0] &&
-                    ty < upper[1] + upper[3] && ty + SS_FONT_H > upper[1]) {
-                    covered = 1;
-                    break;
-                }
-            }
-            if (target_pos >= 0 && covered) {
-                ss_gfx_draw_text_clip(tx, ty, c->line[i] + j,
-                                      PAL_BLACK, PAL_WHITE,
-                                      clip_wins, nclip, target_pos);
-            } else {
-                ss_gfx_draw_text_fast(tx, ty, c->line[i] + j,
-                                      PAL_BLACK, PAL_WHITE);
-            }
-            memcpy(c->prev[i], c->line[i], 30);
+        uint32_t mask = ss_tgrid_take(&c->grid, i);
+        int first, len;
+        for (int from = 0; (len = ss_tgrid_run(mask, from, &first)) > 0; from = first + len) {
+            SSGfxRect r = ss_dl_cells(&win_dl[id - 1], n->line[i], first, len);
+            ss_win_damage(id, r.x, r.y, r.w, r.h);
         }
     }
 }
 
 /*
- * Window render callback: standalone-style frame + content.
+ * Window render callback: replay the window's display list.
  * Active (topmost) window: gray title bar with black hash stripes flanking
  * the title (matches standalone draw_frame).  Inactive: plain white bar.
+ * The look is switched in the nodes only when the active state changes.
  */
-static int rect_contains(const SSGfxRect* outer, int x, int y, int w, int h) {
-    return outer == NULL ||
-           (x >= outer->x && y >= outer->y &&
-            x + w <= outer->x + outer->w && y + h <= outer->y + outer->h);
-}
-
-static void draw_win_rect(int x, int y, int w, int h, uint16_t color,
-                          const SSGfxRect* clip) {
-    if (clip == NULL) ss_gfx_rect(x, y, w, h, color);
-    else ss_gfx_rect_region((SSGfxRect){x, y, w, h}, clip, color);
-}
-
-static void draw_win_text(int x, int y, const char* text, uint16_t fg, uint16_t bg,
-                          const SSGfxRect* clip) {
-    if (clip == NULL) ss_gfx_draw_text_fast(x, y, text, fg, bg);
-    else ss_gfx_draw_text_region(x, y, text, fg, bg, clip);
-}
-
 static void render_win(SSWindow* self, const SSGfxRect* clip) {
     if (self->id == 0 || self->id > SS_SCENE_WINDOW_COUNT) return;
-    WinContent* c = &win_content[self->id - 1];
-    int x = self->x, y = self->y, w = self->w, h = self->h;
+    SSDisplayList* dl = &win_dl[self->id - 1];
+    WinNodes* n = &win_nodes_at[self->id - 1];
     int is_fg = (self->z == ss_win_active_z);
-    uint16_t t_bg = is_fg ? PAL_GRAY : PAL_WHITE;
-
-    draw_win_rect(x + 1, y + 1, w - 2, TITLE_H - 2, t_bg, clip);
-    draw_win_rect(x + 1, y + TITLE_H, w - 2, h - TITLE_H - 1, PAL_WHITE, clip);
-    draw_win_rect(x, y, w, 1, PAL_BLACK, clip);
-    draw_win_rect(x, y + h - 1, w, 1, PAL_BLACK, clip);
-    draw_win_rect(x, y, 1, h, PAL_BLACK, clip);
-    draw_win_rect(x + w - 1, y, 1, h, PAL_BLACK, clip);
-    draw_win_rect(x + 1, y + TITLE_H - 1, w - 2, 1, PAL_BLACK, clip);
 
-    int tw = (int)strlen(c->title) * SS_FONT_ADV;
-    int tx = x + (w - tw) / 2;
-    if (is_fg) {
-        /* black hash stripes on both sides of the title (standalone look) */
-        for (int i = 0; i < 5; i++) {
-            int ly = y + 2 + i * 2;
-            if (tx > x + 12)
-                draw_win_rect(x + 4, ly, tx - 8 - (x + 4) + 1, 1, PAL_BLACK, clip);
-            if (tx + tw + 8 < x + w - 4)
-                draw_win_rect(tx + tw + 8, ly, (x + w - 5) - (tx + tw + 8) + 1, 1, PAL_BLACK, clip);
-        }
-    }
-    draw_win_text(tx, y + 2, c->title, PAL_BLACK, t_bg, clip);
-
-    for (int i = 0; i < 3; i++) {
-        int line_x = x + 4;
-        int line_y = y + CONTENT_Y + i * LINE_H;
-        draw_win_text(line_x, line_y, c->line[i], PAL_BLACK, PAL_WHITE, clip);
-        /* Do not advance the snapshot while any glyph area remains unpainted. */
-        int line_w = (LINE_LEN - 1) * SS_FONT_ADV + SS_FONT_W;
-        if (rect_contains(clip, line_x, line_y, line_w, SS_FONT_H))
-            memcpy(c->prev[i], c->line[i], 30);
+    if (n->fg != is_fg) {
+        uint16_t t_bg = is_fg ? PAL_GRAY : PAL_WHITE;
+        ss_dl_set_color(dl, n->bar, t_bg, 0);
+        ss_dl_set_color(dl, n->title, PAL_BLACK, t_bg);
+        for (int i = 0; i < n->stripe_count; i++)
+            ss_dl_set_hidden(dl, n->stripe_first + i, !is_fg);
+        n->fg = (int8_t)is_fg;
     }
+    ss_dl_replay(dl, self->x, self->y, clip);
 }
 
-static void update_content(uint16_t wt, uint16_t wk, uint16_t wm,
-                           int mx, int my, int left, int right) {
-    char* p;
-    WinContent* t = &win_content[wt - 1];
-    /* Avoid sprintf on the hot path: build counter lines directly. */
-    p = t->line[0]; memcpy(p, "Vsync: ", 7); ss_utoa_dec(frame, p + 7); pad_line(p, LINE_LEN);
-    p = t->line[1]; memcpy(p, "VDisp:", 6); ss_utoa_dec(ss_vdisp_fire_count, p + 6); pad_line(p, LINE_LEN);
-    p = t->line[2]; memcpy(p, "Tick: ", 6); ss_utoa_dec(ss_timerd_fire_count, p + 6); pad_line(p, LINE_LEN);
+/* Window content, each part rebuilt only when its source changed: the
+ * counters on the scene timer, the key and pointer lines on input.
+ * Avoid sprintf on the hot path: build the lines directly.  The grid
+ * pads each line and marks only the cells that changed. */
+static void update_timer_content(uint16_t wt) {
+    char p[LINE_LEN + 1];
+    SSTextGrid* t = &win_content[wt - 1].grid;
+    memcpy(p, "Vsync: ", 7); ss_utoa_dec(frame, p + 7); ss_tgrid_set_line(t, 0, p);
+    memcpy(p, "VDisp:", 6); ss_utoa_dec(ss_vdisp_fire_count, p + 6); ss_tgrid_set_line(t, 1, p);
+    memcpy(p, "Tick: ", 6); ss_utoa_dec(ss_timerd_fire_count, p + 6); ss_tgrid_set_line(t, 2, p);
+}
 
-    WinContent* k = &win_content[wk - 1];
+static void update_key_content(uint16_t wk) {
+    char p[LINE_LEN + 1];
+    SSTextGrid* k = &win_content[wk - 1].grid;
     if (last_key >= 0) {
         int code = last_key & 0xFF;
         char ch = (code >= 0x20 && code < 0x7F) ? (char)code : '.';
-        p = k->line[0];
         memcpy(p, "Code:", 5);                 /* "Code:" */
         ss_utoa_hex((uint32_t)code, p + 5, 2); /* "XX"    */
         p[7] = 'H'; p[8] = ' '; p[9] = '\''; p[10] = ch; p[11] = '\''; p[12] = '\0';
-        pad_line(p, LINE_LEN);
-        p = k->line[1];
+        ss_tgrid_set_line(k, 0, p);
         memcpy(p, "Shift:", 6);
         ss_utoa_hex((uint32_t)((last_key >> 8) & 0xFF), p + 6, 2);
         p[8] = 'H'; p[9] = '\0';
-        pad_line(p, LINE_LEN);
-        k->line[2][0] = '\0';
+        ss_tgrid_set_line(k, 1, p);
     } else {
-        strcpy(k->line[0], "Press any key...");
-        k->line[1][0] = '\0';
-        k->line[2][0] = '\0';
+        ss_tgrid_set_line(k, 0, "Press any key...");
+        ss_tgrid_set_line(k, 1, "");
     }
-    pad_line(k->line[0], LINE_LEN); pad_line(k->line[1], LINE_LEN); pad_line(k->line[2], LINE_LEN);
+    ss_tgrid_set_line(k, 2, "");
+}
 
-    WinContent* m = &win_content[wm - 1];
-    p = m->line[0];
+static void update_mouse_content(uint16_t wm, int mx, int my, int left, int right) {
+    char p[LINE_LEN + 1];
+    SSTextGrid* m = &win_content[wm - 1].grid;
     p[0] = 'X'; p[1] = ':';
     int n = ss_itoa_dec_pad(mx, p + 2, 3);
     int off = 2 + n;
     p[off] = ' '; p[off + 1] = 'Y'; p[off + 2] = ':';
     int n2 = ss_itoa_dec_pad(my, p + off + 3, 3);
     p[off + 3 + n2] = '\0';
-    pad_line(p, LINE_LEN);
+    ss_tgrid_set_line(m, 0, p);
 
-    p = m->line[1];
     p[0] = 'L'; p[1] = '=';
     p[2] = left ? 'D' : 'U'; p[3] = left ? 'N' : 'P';
     p[4] = ' '; p[5] = 'R'; p[6] = '=';
     p[7] = right ? 'D' : 'U'; p[8] = right ? 'N' : 'P';
     p[9] = '\0';
-    pad_line(p, LINE_LEN);
-    m->line[2][0] = '\0';
+    ss_tgrid_set_line(m, 1, p);
+    ss_tgrid_set_line(m, 2, "");
 }
 
 /* ---- drag state machine (split out of ss_run for readability) ----
@@ -290,23 +237,37 @@ static void update_content(uint16_t wt, uint16_t wk, uint16_t wm,
  * window perimeter from GVRAM (slow, wait-stated) every frame the mouse
  * moved and rewrote it every frame for the animation. Now: no save buffer,
  * no GVRAM read, and the outline is touched only when the position changes.
+ *
+ * With the text VRAM overlay active the outline lives on that plane
+ * instead: drawing and erasing are plain word stores that never touch
+ * GVRAM, and repaints underneath cannot disturb it.
+ *
+ * The outline is only the fallback.  A drag starts opaque: each mouse step
+ * blits the window and the frame flush repaints the strip it uncovered, as
+ * long as the step fits SS_SCENE_DRAG_BUDGET_WORDS and frames keep up with
+ * the vsync.
  */
 
+static void drag_outline(int x, int y, int on) {
+    if (ss_overlay_active()) {
+        ss_overlay_frame(x, y, drag_w, drag_h, on);
+    } else {
+        ss_gfx_xor_rect(x, y, drag_w, drag_h);   /* draw and erase alike */
+    }
+}
+
 static void drag_begin(int mx, int my, int hid) {
-    /* Capture the previous active window (z == current active_z) BEFORE
-     * set_z, so we can repaint it on release if it loses the active title.
-     * Skip the dragged window itself. */
+    /* Capture the previous active (top) window BEFORE the raise, so we can
+     * repaint it on release if it loses the active title.  Skip the dragged
+     * window itself. */
+    uint16_t top = ss_win_top();
     prev_active_valid = 0;
-    for (int i = 1; i <= SS_MAX_WINDOWS; i++) {
-        if (i == hid) continue;
-        if (ss_win_get_z(i) == ss_win_active_z) {
-            prev_active_x = ss_win_get_x(i);
-            prev_active_y = ss_win_get_y(i);
-            prev_active_w = ss_win_get_w(i);
-            prev_active_h = ss_win_get_h(i);
-            prev_active_valid = 1;
-            break;
-        }
+    if (top != 0 && top != hid) {
+        prev_active_x = ss_win_get_x(top);
+        prev_active_y = ss_win_get_y(top);
+        prev_active_w = ss_win_get_w(top);
+        prev_active_h = ss_win_get_h(top);
+        prev_active_valid = 1;
     }
     drag_id = hid;
     drag_ox = mx - ss_win_get_x(hid);
@@ -314,35 +275,27 @@ static void drag_begin(int mx, int my, int hid) {
     drag_w  = ss_win_get_w(hid);
     drag_h  = ss_win_get_h(hid);
 
-    /* z is a uint16_t, but this scene reserves the low range for its initial
-     * layout. Renumber after saving the previous active window, before the
-     * counter reaches that range again, so every visible window stays unique. */
-    if (next_z >= 255) {
-        uint16_t order[SS_SCENE_WINDOW_COUNT];
-        int n = 0;
-        for (int id = 1; id <= SS_SCENE_WINDOW_COUNT; id++) {
-            SSWindow* w = ss_win_get_ptr((uint16_t)id);
-            if (w == NULL || !(w->flags & SS_WIN_VISIBLE)) continue;
-            int j = n;
-            while (j > 0 && ss_win_get_z(order[j - 1]) > w->z) {
-                order[j] = order[j - 1];
-                j--;
-            }
-            order[j] = (uint16_t)id;
-            n++;
-        }
-        for (int i = 0; i < n; i++)
-            ss_win_set_z(order[i], (uint16_t)(i + 1));
-        next_z = (uint16_t)(n + 1);
-    }
-    ss_win_set_z(hid, next_z);
-    next_z++;
-
-    int ox = ss_win_get_x(hid), oy = ss_win_get_y(hid);
-    ss_win_hide(hid);
-    ss_win_render_region(ox, oy, drag_w, drag_h);  /* restore the old spot */
-    ss_gfx_xor_rect(ox, oy, drag_w, drag_h);       /* draw XOR outline */
-    drag_prev_x = ox; drag_prev_y = oy;
+    /* The raise gives the window a z above every other one (renumbering
+     * them when z runs out), so ss_win_active_z matches it alone. */
+    ss_win_raise(hid);
+
+    /* The raise queued the window, so the flush repaints it as the active
+     * (top) window.  Until the drag falls back to the outline, drag_prev is the
+     * window's own position. */
+    drag_prev_x = ss_win_get_x(hid);
+    drag_prev_y = ss_win_get_y(hid);
+    drag_opaque = 1;
+}
+
+/* GVRAM words one opaque step costs: the blit plus the L-shaped strip it
+ * exposes. */
+static uint32_t drag_move_cost(int nx, int ny) {
+    int dx = nx > drag_prev_x ? nx - drag_prev_x : drag_prev_x - nx;
+    int dy = ny > drag_prev_y ? ny - drag_prev_y : drag_prev_y - ny;
+    if (dx > drag_w) dx = drag_w;
+    if (dy > drag_h) dy = drag_h;
+    return (uint32_t)drag_w * (uint32_t)drag_h +
+           (uint32_t)dx * (uint32_t)drag_h + (uint32_t)dy * (uint32_t)drag_w;
 }
 
 static void drag_move(int mx, int my) {
@@ -353,31 +306,47 @@ static void drag_move(int mx, int my) {
     if (nx + drag_w > W) nx = W - drag_w;
     if (ny + drag_h > H) ny = H - drag_h;
     if (nx == drag_prev_x && ny == drag_prev_y) return;  /* no redraw when still */
-    ss_gfx_xor_rect(drag_prev_x, drag_prev_y, drag_w, drag_h);  /* erase old */
+    if (drag_opaque) {
+        if (!frame_missed && drag_move_cost(nx, ny) <= SS_SCENE_DRAG_BUDGET_WORDS) {
+            /* The exposed strip is repainted by this frame's flush. */
+            ss_win_move(drag_id, nx, ny);
+            drag_prev_x = nx; drag_prev_y = ny;
+            return;
+        }
+        /* Over budget: leave the window where it is and track the rest of
+         * the drag with the outline. */
+        drag_opaque = 0;
+        drag_prev_x = nx; drag_prev_y = ny;
+        drag_outline_pending = 1;
+        return;
+    }
+    drag_outline(drag_prev_x, drag_prev_y, 0);                  /* erase old */
     drag_prev_x = nx; drag_prev_y = ny;
-    ss_gfx_xor_rect(nx, ny, drag_w, drag_h);                   /* draw new */
+    drag_outline(nx, ny, 1);                                    /* draw new */
 }
 
 static void drag_end(void) {
-    ss_gfx_xor_rect(drag_prev_x, drag_prev_y, drag_w, drag_h);  /* erase outline */
-    ss_win_show(drag_id);
+    if (!drag_opaque && !drag_outline_pending)
+        drag_outline(drag_prev_x, drag_prev_y, 0);              /* erase outline */
+    /* After an outline drag the raised window is unobscured, so the move
+     * blits its pixels and queues only the strip it vacated.  After an
+     * opaque drag it is already in place. */
     ss_win_move(drag_id, drag_prev_x, drag_prev_y);
-    /* Region repaint at new position: paints the window (now active, since
-     * set_z raised it) AND refreshes ss_win_active_z. */
-    ss_win_render_region(drag_prev_x, drag_prev_y, drag_w, drag_h);
-    /* Repaint the previous active window: render_region only touches windows
-     * overlapping the new position, so the window that just lost the active
-     * title would be left painted in the active color. Force its repaint. */
+    /* The window that just lost the active title lies outside the new rect
+     * in general; queue it too so it is not left in the active color.  The
+     * damage list merges it with the new rect when they are close. */
     if (prev_active_valid) {
-        ss_win_render_region(prev_active_x, prev_active_y,
-                             prev_active_w, prev_active_h);
+        ss_win_add_damage(prev_active_x, prev_active_y,
+                          prev_active_w, prev_active_h);
     }
     drag_id = -1;
     drag_prev_x = -1;
+    drag_opaque = 0;
+    drag_outline_pending = 0;
     prev_active_valid = 0;
 }
 
-/* Run one frame of drag handling. Returns 1 while a drag is in progress
+/* Run one step of drag handling. Returns 1 while a drag is in progress
  * (the caller suppresses per-window content redraws during a drag). */
 static int handle_drag(int mx, int my, int left) {
     if (left && drag_id < 0) {
@@ -391,51 +360,209 @@ static int handle_drag(int mx, int my, int left) {
     return drag_id > 0;
 }
 
+/* What a frame has to do.  The scene renders only when one of these is
+ * set; otherwise the frame is skipped without formatting text or
+ * touching GVRAM.  Run as a task, it blocks while none is. */
+#define SCENE_WAKE_INPUT    0x01
+#define SCENE_WAKE_KEY      0x02
+#define SCENE_WAKE_POINTER  0x04
+#define SCENE_WAKE_TIMER    0x08
+#define SCENE_WAKE_DAMAGE   0x10
+#define SCENE_WAKE_WORK     0x20
+#define SCENE_WAKE_MSG      0x40
+
+/* Apply the frame's input events.  A button change is handed to the drag
+ * at its own position, so a press and release inside one frame still
+ * raises the window; moves only update the pointer, and the drag follows
+ * it once per frame.  Returns the SCENE_WAKE_* bits of what arrived. */
+static int drain_input(void) {
+    SSInputEvent ev;
+    int seen = 0;
+    while (ss_input_poll(&ev) == SS_OK) {
+        if (ev.type == SS_INPUT_KEY) {
+            last_key = ev.key;
+            seen |= SCENE_WAKE_KEY;
+            continue;
+        }
+        seen |= SCENE_WAKE_POINTER;
+        cur_mx = ev.x;
+        cur_my = ev.y;
+        if (ev.type == SS_INPUT_BUTTON) {
+            cur_btn = ev.buttons;
+            handle_drag(cur_mx, cur_my, (cur_btn & SS_INPUT_LEFT) != 0);
+        }
+    }
+    return seen;
+}
+
+static uint32_t timer_frame;       /* frame of the last counter refresh */
+
+#ifndef LOCAL_MODE
+/* Text posted by application tasks goes to the same grids the scene
+ * writes, so it is damaged and repainted by the same per-cell path. */
+static SSTextGrid* scene_grid(uint16_t win) {
+    if (win == 0 || win > SS_SCENE_WINDOW_COUNT) return NULL;
+    return &win_content[win - 1].grid;
+}
+#endif
+
+/* What frame `at` would have to do. */
+static int scene_wake(uint32_t at) {
+    int wake = 0;
+    /* A polled source (a replayed trace) posts here; IOCS input is
+     * already in the ring and the pump does nothing. */
+    ss_input_pump();
+    if (ss_input_pending() > 0) wake |= SCENE_WAKE_INPUT;
+    if (at - timer_frame >= SS_SCENE_TIMER_FRAMES) wake |= SCENE_WAKE_TIMER;
+    if (ss_win_pending_damage(NULL, 0) > 0) wake |= SCENE_WAKE_DAMAGE;
+#ifndef LOCAL_MODE
+    if (ss_main_work_queue.count > 0) wake |= SCENE_WAKE_WORK;
+    if (ss_comp_pending() > 0) wake |= SCENE_WAKE_MSG;
+#endif
+    return wake;
+}
+
+/* A vsync is about 18ms and a Timer D tick 5ms: three ticks a vsync
+ * never sleeps past the vsync a wait aims at. */
+#define SCENE_TICKS_PER_VSYNC 3
+
+/* Block until input, damage or a message signals the task, or until the
+ * vsync before the Timer window is due.  Returns 1 if it slept. */
+static int scene_block(uint32_t start_vsync) {
+    int slept = 0;
+    for (;;) {
+        uint32_t next = ss_vsync_counter - start_vsync + 1;
+        if (scene_wake(next) != 0) return slept;
+        /* Positive: scene_wake found the timer not yet due. */
+        uint32_t left = timer_frame + SS_SCENE_TIMER_FRAMES - next;
+        ss_task_wait(left * SCENE_TICKS_PER_VSYNC);
+        slept = 1;
+    }
+}
+
 void ss_scene_run(const SSSceneHooks *hooks, SSSceneStats *stats) {
     uint16_t ids[SS_SCENE_WINDOW_COUNT];
     for (int i = 0; i < SS_SCENE_WINDOW_COUNT; i++) {
         const SSSceneWindowSpec* spec = &ss_scene_default_windows[i];
         ids[i] = ss_win_create(spec->x, spec->y, spec->w, spec->h, spec->z);
         strcpy(win_content[ids[i] - 1].title, spec->title);
+        build_win_list(ids[i], spec->w, spec->h);
         ss_win_set_render(ids[i], render_win);
     }
     uint16_t w_timer = ids[0];
     uint16_t w_key   = ids[1];
     uint16_t w_mouse = ids[2];
 
+    /* Each run starts from the same state, so a replayed trace renders
+     * the same frames every time. */
+    frame = 0;
+    cur_mx = cur_my = cur_btn = 0;
+    last_key = -1;
+    drag_id = -1;
+    drag_prev_x = drag_prev_y = -1;
+    drag_opaque = drag_outline_pending = frame_missed = 0;
+    prev_active_valid = 0;
+    /* Without a source of its own the scene takes IOCS input, posted by
+     * the keyboard and mouse receive interrupts. */
+    int iocs_input = hooks == NULL || hooks->input == NULL;
+    if (iocs_input) ss_input_iocs_attach();
+    else ss_input_init(hooks->input);
+    update_timer_content(w_timer);
+    update_key_content(w_key);
+    update_mouse_content(w_mouse, cur_mx, cur_my, 0, 0);
+    timer_frame = frame;
+    frames_rendered = frames_skipped = 0;
     ss_win_render_all();
-
+    /* The overlay and a sprite cursor live outside GVRAM, so nothing is
+     * XORed into a page and both pages can be composited independently:
+     * present tear-free through the back page when the mode has two. */
+    ss_overlay_init();
+    if (ss_cursor_init() == SS_CURSOR_SPRITE) ss_win_set_double_buffer(1);
+
+    /* A host hook paces every vsync itself.  Otherwise the scene is a task
+     * that sleeps until something signals it: input posts, damage and
+     * messages to it (ss_send) wake it, and the Timer refresh is a
+     * timeout. */
+    int hooked = hooks != NULL && hooks->wait_vsync != NULL;
+    if (!hooked) {
+        ss_input_notify(ss_curr_task);
+        ss_win_notify(ss_curr_task);
+    }
     uint32_t start_vsync = ss_vsync_counter;
+    uint32_t frame_vsync = start_vsync;
     while (1) {
-        int stopped = hooks != NULL && hooks->wait_vsync != NULL
-                          ? hooks->wait_vsync(hooks->ctx) : wait_vsync();
+        int slept = 0, stopped;
+        if (hooked) {
+            stopped = hooks->wait_vsync(hooks->ctx);
+        } else {
+            slept = scene_block(start_vsync);
+            stopped = wait_vsync();
+        }
         if (stopped || (hooks != NULL && hooks->should_stop != NULL &&
                         hooks->should_stop(hooks->ctx)))
             break;
-        frame++;
-        update_mouse();
-        update_keyboard();
-        int mx = cur_mx, my = cur_my, btn = cur_btn;
-        int left = (btn & 0x0200) != 0;
-        int right = (btn & 0x0001) != 0;
-
-        update_content(w_timer, w_key, w_mouse, mx, my, left, right);
+        /* Vsyncs since the last frame.  Those slept through count as
+         * skipped frames; otherwise a frame that finished in time waits
+         * for exactly one. */
+        uint32_t gap = ss_vsync_counter - frame_vsync;
+        if (gap == 0) gap = 1;
+        if (slept) frames_skipped += gap - 1;
+        frame_missed = !slept && gap > 1;
+        frame_vsync = ss_vsync_counter;
+        frame += gap;
+
+        int wake = scene_wake(frame);
+        if (wake == 0) {
+            frames_skipped++;
+            ss_process_wakeups();
+            ss_task_yield();
+            continue;
+        }
+        frames_rendered++;
 
-        /* Erase the previous cursor BEFORE any region repaint, so a repaint
-         * that overwrites cursor pixels does not leave a stray XOR mark. */
-        if (cur_prev_x >= 0) ss_gfx_xor_rect(cur_prev_x, cur_prev_y, 6, 6);
+        /* With the XOR fallback the previous cursor must be erased BEFORE
+         * any region repaint, so a repaint that overwrites cursor pixels
+         * does not leave a stray XOR mark.  The sprite cursor is not in
+         * GVRAM and needs nothing here. */
+        ss_cursor_begin_repaint();
 
-        int dragging = handle_drag(mx, my, left);
+        wake |= drain_input();
+        int dragging = handle_drag(cur_mx, cur_my, (cur_btn & SS_INPUT_LEFT) != 0);
+        int mx = cur_mx, my = cur_my;
 
+        if (wake & SCENE_WAKE_TIMER) {
+            update_timer_content(w_timer);
+            timer_frame = frame;
+        }
+        if (wake & SCENE_WAKE_KEY) update_key_content(w_key);
+#ifndef LOCAL_MODE
+        /* Updates the application tasks posted since the last frame; the
+         * scene runs as the compositor task when the OS started one. */
+        if (wake & SCENE_WAKE_MSG) ss_comp_drain(scene_grid);
+#endif
+        if (wake & SCENE_WAKE_POINTER)
+            update_mouse_content(w_mouse, mx, my, (cur_btn & SS_INPUT_LEFT) != 0,
+                                 (cur_btn & SS_INPUT_RIGHT) != 0);
         if (!dragging) {
-            draw_content_dirty(w_timer);
-            draw_content_dirty(w_key);
-            draw_content_dirty(w_mouse);
+            queue_content_damage(w_timer);
+            queue_content_damage(w_key);
+            queue_content_damage(w_mouse);
         }
 
-        /* Draw cursor (erase happens at the top of the next frame). */
-        ss_gfx_xor_rect(mx, my, 6, 6);
-        cur_prev_x = mx; cur_prev_y = my;
+        /* One repaint of everything damaged this frame, before any XOR
+         * overlay is drawn on top of it. */
+        ss_win_flush_damage();
+        if (drag_outline_pending) {
+            drag_outline(drag_prev_x, drag_prev_y, 1);
+            drag_outline_pending = 0;
+        }
+
+        /* Show the finished back page (double-buffered only). */
+        ss_win_present();
+
+        /* Place the cursor (an XOR box is erased at the top of the next
+         * frame). */
+        ss_cursor_move(mx, my);
 
 #ifndef LOCAL_MODE
         /* Deferred work is posted by baremetal ISR paths.  The standalone
@@ -444,11 +571,24 @@ void ss_scene_run(const SSSceneHooks *hooks, SSSceneStats *stats) {
 #endif
         ss_process_wakeups();
         ss_task_yield();
-        (void)right;
+    }
+    /* The host restores its own screen; do not leave a sprite or an
+     * outline on it (ss_overlay_shutdown leaves the planes untouched). */
+    if (drag_id >= 0 && !drag_opaque && !drag_outline_pending)
+        drag_outline(drag_prev_x, drag_prev_y, 0);
+    ss_win_set_double_buffer(0);
+    ss_cursor_shutdown();
+    ss_overlay_shutdown();
+    if (iocs_input) ss_input_iocs_detach();
+    if (!hooked) {
+        ss_input_notify(NULL);
+        ss_win_notify(NULL);
     }
     if (stats != NULL) {
         stats->frames = frame;
         stats->vsyncs = ss_vsync_counter - start_vsync;
+        stats->rendered = frames_rendered;
+        stats->skipped = frames_skipped;
     }
 }
 
@@ -2,23 +2,36 @@
 #define SS_APP_SCENE_H
 
 #include <stdint.h>
+#include "../kernel/input.h"
 
 /* Host-independent UI scene.  The host owns IOCS/MFP setup and supplies
- * optional wait/stop hooks; rendering, input sampling, drag and content
- * updates live in the shared implementation. */
+ * optional wait/stop hooks and input source; rendering, input sampling,
+ * drag and content updates live in the shared implementation. */
 typedef struct {
     int (*wait_vsync)(void *ctx); /* 0 = frame ready, nonzero = stop */
     int (*should_stop)(void *ctx);
     void *ctx;
+    const SSInputSource *input;   /* NULL = IOCS mouse and keyboard */
 } SSSceneHooks;
 
 typedef struct {
     uint32_t frames;
     uint32_t vsyncs;
+    uint32_t rendered;          /* frames that had work to do */
+    uint32_t skipped;           /* idle frames, or vsyncs slept through */
 } SSSceneStats;
 
 #define SS_SCENE_WINDOW_COUNT 3
 
+/* The Timer window's counters are refreshed every this many vsyncs.
+ * Frames in between with no input, damage or deferred work are skipped. */
+#define SS_SCENE_TIMER_FRAMES 30
+
+/* Dragging moves the window itself (blit plus exposed strip) while one move
+ * costs at most this many GVRAM words and no frame has missed a vsync;
+ * otherwise the drag falls back to the XOR outline until release. */
+#define SS_SCENE_DRAG_BUDGET_WORDS 16384
+
 /* The normal UI and standalone benchmark use the same model layout.  Their
  * renderers deliberately remain separate: the benchmark measures primitive
  * compositor paths while the UI uses its content-aware callback. */
@@ -0,0 +1,300 @@
+		| ============================================================
+		| burst.s - movem.l burst kernels behind the GVRAM fill/copy API
+		|
+		| The 68000 moves up to 13 longs per movem.l, so once a run is
+		| long enough to pay for the register save, filling from a bank
+		| of replicated registers costs about 8 cycles per long against
+		| 12+ for move.l and the loop overhead of the C version.  Short
+		| runs stay in scratch registers (d0-d1/a0-a1) so the small rects
+		| and glyph-sized spans that dominate window chrome do not pay
+		| for a movem.l save/restore at all.
+		|
+		| Remainders are stored by binary decomposition (1, 2, 4 and 8
+		| straight-line stores selected by the low count bits), which
+		| keeps every tail unrolled without a computed jump.
+		|
+		| Host builds (SS_HOST_TEST) use the C versions in vram.c; both
+		| implement the prototypes declared in gfx.h.
+		| ============================================================
+
+		.section .text
+		.align	2
+		.globl	ss_fill_long
+		.globl	ss_fill_long_rows
+		.globl	ss_copy_long
+
+		| Runs shorter than this stay on the scratch-register paths.
+		| Below ~64 longs the 11-register save/restore costs more than
+		| the movem.l bursts win back.
+		.equ	FILL_BURST_MIN, 64
+		.equ	COPY_BURST_MIN, 32
+
+		| ============================================================
+		| void ss_fill_long(volatile uint32_t* dst, uint32_t val,
+		|                   uint32_t count)
+		| ============================================================
+ss_fill_long:
+		move.l	4(sp), a0		| dst
+		move.l	8(sp), d1		| val
+		move.l	12(sp), d0		| count
+		cmp.l	#FILL_BURST_MIN, d0
+		bcc	.fill_burst
+
+		| Short run: 8 stores per iteration, scratch registers only.
+.fill_short8:
+		subq.w	#8, d0
+		bcs	.fill_short_tail
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+		bra	.fill_short8
+.fill_short_tail:
+		| d0.w = remainder - 8; bits 0-2 still hold remainder 0..7
+		lsr.w	#1, d0
+		bcc	1f
+		move.l	d1, (a0)+
+1:		lsr.w	#1, d0
+		bcc	2f
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+2:		lsr.w	#1, d0
+		bcc	3f
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+		move.l	d1, (a0)+
+3:		rts
+
+		| Long run: replicate val into d1-d7/a0-a5 and fill downward
+		| from the end with movem.l -(a6), 13 longs per instruction.
+.fill_burst:
+		movem.l	d2-d7/a2-a6, -(sp)
+		move.l	d0, d2
+		add.l	d2, d2
+		add.l	d2, d2
+		lea	0(a0,d2.l), a6		| a6 = dst + count * 4
+		move.l	d1, d2
+		move.l	d1, d3
+		move.l	d1, d4
+		move.l	d1, d5
+		move.l	d1, d6
+		move.l	d1, d7
+		move.l	d1, a0
+		move.l	d1, a1
+		move.l	d1, a2
+		move.l	d1, a3
+		move.l	d1, a4
+		move.l	d1, a5
+		sub.l	#13, d0			| count >= FILL_BURST_MIN: no borrow
+1:		movem.l	d1-d7/a0-a5, -(a6)
+		sub.l	#13, d0
+		bcc	1b
+		add.l	#13, d0			| remainder 0..12
+		bsr	.fill_down_tail
+		movem.l	(sp)+, d2-d7/a2-a6
+		rts
+
+		| Store d0.w (0..15) copies of d1 downward through a6.
+.fill_down_tail:
+		lsr.w	#1, d0
+		bcc	1f
+		move.l	d1, -(a6)
+1:		lsr.w	#1, d0
+		bcc	2f
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+2:		lsr.w	#1, d0
+		bcc	3f
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+3:		lsr.w	#1, d0
+		bcc	4f
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+		move.l	d1, -(a6)
+4:		rts
+
+		| ============================================================
+		| void ss_fill_long_rows(volatile uint32_t* dst, uint32_t val,
+		|                        uint32_t count, uint32_t rows,
+		|                        uint32_t stride_bytes)
+		|
+		| Fills `count` longs on each of `rows` rows.  The replicated
+		| value bank is loaded once for the whole rectangle instead of
+		| once per scanline.  d1-d7/a0-a3 hold the value (11 longs per
+		| movem.l); a4 is the row start, a5 the row length in bytes.
+		| After the 44-byte save, the arguments sit at 48..64(sp).
+		| ============================================================
+ss_fill_long_rows:
+		tst.l	12(sp)			| count
+		beq	9f
+		tst.l	16(sp)			| rows
+		beq	9f
+		movem.l	d2-d7/a2-a6, -(sp)
+		move.l	48(sp), a4		| dst
+		move.l	52(sp), d1		| val
+		move.l	56(sp), d0
+		add.l	d0, d0
+		add.l	d0, d0
+		move.l	d0, a5			| row length in bytes
+		move.l	d1, d2
+		move.l	d1, d3
+		move.l	d1, d4
+		move.l	d1, d5
+		move.l	d1, d6
+		move.l	d1, d7
+		move.l	d1, a0
+		move.l	d1, a1
+		move.l	d1, a2
+		move.l	d1, a3
+.rows_loop:
+		lea	0(a4,a5.l), a6		| fill this row downward from its end
+		move.l	56(sp), d0
+		sub.l	#11, d0
+		bcs	2f
+1:		movem.l	d1-d7/a0-a3, -(a6)
+		sub.l	#11, d0
+		bcc	1b
+2:		add.l	#11, d0			| remainder 0..10
+		bsr	.fill_down_tail
+		adda.l	64(sp), a4
+		subq.l	#1, 60(sp)
+		bne	.rows_loop
+		movem.l	(sp)+, d2-d7/a2-a6
+9:		rts
+
+		| ============================================================
+		| void ss_copy_long(volatile uint32_t* dst,
+		|                   const volatile uint32_t* src, uint32_t count)
+		|
+		| memmove semantics: when dst is above src the copy runs from
+		| the end so overlapping scrolls and window blits read every
+		| source long before it is overwritten.  Bursts move 12 longs
+		| through d1-d7/a2-a6.
+		| ============================================================
+ss_copy_long:
+		move.l	4(sp), a1		| dst
+		move.l	8(sp), a0		| src
+		move.l	12(sp), d0		| count
+		beq	9f
+		cmpa.l	a0, a1
+		beq	9f
+		bhi	.copy_backward
+
+		cmp.l	#COPY_BURST_MIN, d0
+		bcc	.copy_fwd_burst
+		bsr	.copy_fwd_tail		| count < 32: bits 0-4
+		lsr.w	#1, d0
+		bcc	9f
+		moveq	#15, d1			| the 16-long chunk
+1:		move.l	(a0)+, (a1)+
+		dbra	d1, 1b
+9:		rts
+
+.copy_fwd_burst:
+		movem.l	d2-d7/a2-a6, -(sp)
+		sub.l	#12, d0
+1:		movem.l	(a0)+, d1-d7/a2-a6
+		movem.l	d1-d7/a2-a6, (a1)
+		lea	48(a1), a1
+		sub.l	#12, d0
+		bcc	1b
+		add.l	#12, d0			| remainder 0..11
+		bsr	.copy_fwd_tail
+		movem.l	(sp)+, d2-d7/a2-a6
+		rts
+
+		| Copy the low four bits of d0.w worth of longs forward; the
+		| count is left shifted right by four.
+.copy_fwd_tail:
+		lsr.w	#1, d0
+		bcc	1f
+		move.l	(a0)+, (a1)+
+1:		lsr.w	#1, d0
+		bcc	2f
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+2:		lsr.w	#1, d0
+		bcc	3f
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+3:		lsr.w	#1, d0
+		bcc	4f
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+		move.l	(a0)+, (a1)+
+4:		rts
+
+.copy_backward:
+		move.l	d0, d1
+		add.l	d1, d1
+		add.l	d1, d1
+		adda.l	d1, a0			| both pointers to the end
+		adda.l	d1, a1
+		cmp.l	#COPY_BURST_MIN, d0
+		bcc	.copy_bwd_burst
+		bsr	.copy_bwd_tail
+		lsr.w	#1, d0
+		bcc	9f
+		moveq	#15, d1
+1:		move.l	-(a0), -(a1)
+		dbra	d1, 1b
+9:		rts
+
+.copy_bwd_burst:
+		movem.l	d2-d7/a2-a6, -(sp)
+		sub.l	#12, d0
+1:		lea	-48(a0), a0
+		movem.l	(a0), d1-d7/a2-a6
+		movem.l	d1-d7/a2-a6, -(a1)
+		sub.l	#12, d0
+		bcc	1b
+		add.l	#12, d0
+		bsr	.copy_bwd_tail
+		movem.l	(sp)+, d2-d7/a2-a6
+		rts
+
+.copy_bwd_tail:
+		lsr.w	#1, d0
+		bcc	1f
+		move.l	-(a0), -(a1)
+1:		lsr.w	#1, d0
+		bcc	2f
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+2:		lsr.w	#1, d0
+		bcc	3f
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+3:		lsr.w	#1, d0
+		bcc	4f
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+		move.l	-(a0), -(a1)
+4:		rts
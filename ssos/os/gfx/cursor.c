@@ -0,0 +1,97 @@
+#include "cursor.h"
+#include "gfx.h"
+
+#ifdef SS_HOST_TEST
+volatile uint16_t ss_cursor_test_sprite[128 * SS_SPRITE_REG_WORDS];
+volatile uint16_t ss_cursor_test_pcg[256 * SS_PCG_WORDS];
+volatile uint16_t ss_cursor_test_palette[16 * 16];
+#endif
+
+#define SPRITE_X    0
+#define SPRITE_Y    1
+#define SPRITE_CODE 2
+#define SPRITE_PRW  3
+#define PRW_FRONT   3             /* above text and graphics */
+
+#define CURSOR_EDGE 1             /* palette entries within the block */
+#define CURSOR_FILL 2
+
+static SSCursorBackend backend;
+static int xor_x = -1, xor_y = -1;   /* -1: XOR box not on screen */
+
+static volatile uint16_t* cursor_sprite(void) {
+    return SS_SPRITE_REG_BASE + SS_CURSOR_SPRITE_NO * SS_SPRITE_REG_WORDS;
+}
+
+/* A 16x16 PCG is four 8x8 cells stored top-left, bottom-left, top-right,
+ * bottom-right; each cell row is two words of four 4-bit pixels, leftmost
+ * pixel in the high nibble. */
+static void define_cursor_pcg(void) {
+    volatile uint16_t* pcg = SS_PCG_BASE + SS_CURSOR_PCG_NO * SS_PCG_WORDS;
+    for (int i = 0; i < SS_PCG_WORDS; i++) pcg[i] = 0;
+    for (int y = 0; y < SS_CURSOR_SIZE; y++) {
+        for (int x = 0; x < SS_CURSOR_SIZE; x++) {
+            int edge = x == 0 || y == 0 ||
+                       x == SS_CURSOR_SIZE - 1 || y == SS_CURSOR_SIZE - 1;
+            uint16_t c = edge ? CURSOR_EDGE : CURSOR_FILL;
+            int cell = (x >> 3) * 2 + (y >> 3);
+            int word = cell * 16 + (y & 7) * 2 + ((x & 7) >> 2);
+            int shift = (3 - (x & 3)) * 4;
+            pcg[word] |= (uint16_t)(c << shift);
+        }
+    }
+    volatile uint16_t* pal = SS_SPRITE_PAL_BASE + SS_CURSOR_PALETTE * 16;
+    pal[CURSOR_EDGE] = 0x0001;    /* black; 0 would be transparent */
+    pal[CURSOR_FILL] = 0xFFFE;    /* white */
+}
+
+SSCursorBackend ss_cursor_init(void) {
+    xor_x = -1;
+    xor_y = -1;
+    backend = SS_CURSOR_XOR;
+    /* The sprite controller only has 256/512-line timings of width <= 512. */
+    if (ss_current_mode->display_w > 512) return backend;
+    if (ss_sprite_hw_begin() != 0) return backend;
+
+    define_cursor_pcg();
+    volatile uint16_t* spr = cursor_sprite();
+    spr[SPRITE_CODE] = (uint16_t)((SS_CURSOR_PALETTE << 8) | SS_CURSOR_PCG_NO);
+    spr[SPRITE_PRW] = 0;          /* hidden until the first move */
+    ss_sprite_hw_on();
+    backend = SS_CURSOR_SPRITE;
+    return backend;
+}
+
+SSCursorBackend ss_cursor_backend(void) {
+    return backend;
+}
+
+void ss_cursor_begin_repaint(void) {
+    if (backend != SS_CURSOR_XOR || xor_x < 0) return;
+    ss_gfx_xor_rect(xor_x, xor_y, SS_CURSOR_SIZE, SS_CURSOR_SIZE);
+    xor_x = -1;
+}
+
+void ss_cursor_move(int x, int y) {
+    if (backend == SS_CURSOR_SPRITE) {
+        volatile uint16_t* spr = cursor_sprite();
+        spr[SPRITE_X] = (uint16_t)(x + SS_SPRITE_ORIGIN);
+        spr[SPRITE_Y] = (uint16_t)(y + SS_SPRITE_ORIGIN);
+        spr[SPRITE_PRW] = PRW_FRONT;
+        return;
+    }
+    ss_cursor_begin_repaint();
+    ss_gfx_xor_rect(x, y, SS_CURSOR_SIZE, SS_CURSOR_SIZE);
+    xor_x = x;
+    xor_y = y;
+}
+
+void ss_cursor_shutdown(void) {
+    if (backend == SS_CURSOR_SPRITE) {
+        cursor_sprite()[SPRITE_PRW] = 0;
+        ss_sprite_hw_off();
+    } else {
+        ss_cursor_begin_repaint();
+    }
+    backend = SS_CURSOR_XOR;
+}
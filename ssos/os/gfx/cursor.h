@@ -0,0 +1,64 @@
+#ifndef SS_CURSOR_H
+#define SS_CURSOR_H
+
+#include <stdint.h>
+
+/* Mouse cursor with two backends.  The sprite backend shows a 16x16 PCG
+ * through the sprite controller, so a move is two register writes and never
+ * touches GVRAM; repaints cannot damage it.  The sprite controller has no
+ * 768x512 timing, so mode 16 falls back to the self-erasing XOR box, which
+ * must be erased before any repaint of the pixels under it.
+ *
+ * Frame protocol for both backends:
+ *   ss_cursor_begin_repaint();   before the frame touches GVRAM
+ *   ...repaints...
+ *   ss_cursor_move(x, y);        after the last repaint of the frame */
+typedef enum {
+    SS_CURSOR_XOR = 0,
+    SS_CURSOR_SPRITE,
+} SSCursorBackend;
+
+#define SS_CURSOR_SIZE    6
+#define SS_CURSOR_SPRITE_NO 0     /* sprite scroll register set used */
+#define SS_CURSOR_PCG_NO    0     /* 16x16 PCG pattern used */
+#define SS_CURSOR_PALETTE   1     /* sprite palette block (0 is the text palette) */
+/* Sprite coordinates place the screen origin at (16, 16). */
+#define SS_SPRITE_ORIGIN  16
+
+/* Sprite controller registers (word-accessible).  Native tests replace the
+ * MMIO with RAM like SS_CRTC_BASE; target builds keep the X68000 addresses. */
+#ifdef SS_HOST_TEST
+extern volatile uint16_t ss_cursor_test_sprite[];
+extern volatile uint16_t ss_cursor_test_pcg[];
+extern volatile uint16_t ss_cursor_test_palette[];
+#define SS_SPRITE_REG_BASE  ss_cursor_test_sprite
+#define SS_PCG_BASE         ss_cursor_test_pcg
+#define SS_SPRITE_PAL_BASE  ss_cursor_test_palette
+#else
+#define SS_SPRITE_REG_BASE  ((volatile uint16_t*)0xEB0000)
+#define SS_PCG_BASE         ((volatile uint16_t*)0xEB8000)
+#define SS_SPRITE_PAL_BASE  ((volatile uint16_t*)0xE82200)
+#endif
+/* Per sprite: x, y, code (palette block << 8 | PCG), priority. */
+#define SS_SPRITE_REG_WORDS 4
+#define SS_PCG_WORDS        64    /* one 16x16 4bpp pattern */
+
+/* Picks the backend for ss_current_mode and defines the sprite pattern.
+ * The cursor starts hidden. */
+SSCursorBackend ss_cursor_init(void);
+SSCursorBackend ss_cursor_backend(void);
+/* XOR: erase the box if drawn.  Sprite: nothing to do. */
+void ss_cursor_begin_repaint(void);
+/* Show the cursor with its top-left at (x, y). */
+void ss_cursor_move(int x, int y);
+/* Remove the cursor and release the sprite controller. */
+void ss_cursor_shutdown(void);
+
+/* Sprite controller setup (sprite.c; IOCS on target, stubbed natively).
+ * begin() stops the sprite display so PCG RAM may be written; on() starts
+ * it again.  begin() returns 0 when the controller is usable. */
+int  ss_sprite_hw_begin(void);
+void ss_sprite_hw_on(void);
+void ss_sprite_hw_off(void);
+
+#endif /* SS_CURSOR_H */
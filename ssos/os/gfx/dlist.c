@@ -0,0 +1,149 @@
+#include "dlist.h"
+#include "profile.h"
+#include <string.h>
+
+void ss_dl_init(SSDisplayList* dl, SSDlNode* nodes, int cap) {
+    dl->nodes = nodes;
+    dl->cap = (uint16_t)cap;
+    dl->count = 0;
+}
+
+void ss_dl_clear(SSDisplayList* dl) {
+    dl->count = 0;
+}
+
+static SSDlNode* dl_append(SSDisplayList* dl, uint8_t kind, int x, int y) {
+    if (dl->count >= dl->cap) return NULL;
+    SSDlNode* n = &dl->nodes[dl->count++];
+    memset(n, 0, sizeof(*n));
+    n->kind = kind;
+    n->x = (int16_t)x;
+    n->y = (int16_t)y;
+    return n;
+}
+
+int ss_dl_rect(SSDisplayList* dl, int x, int y, int w, int h, uint16_t color) {
+    SSDlNode* n = dl_append(dl, SS_DL_RECT, x, y);
+    if (n == NULL) return -1;
+    n->w = (int16_t)w;
+    n->h = (int16_t)h;
+    n->fg = color;
+    return dl->count - 1;
+}
+
+int ss_dl_text(SSDisplayList* dl, int x, int y, const char* text,
+               uint16_t fg, uint16_t bg) {
+    SSDlNode* n = dl_append(dl, SS_DL_TEXT, x, y);
+    if (n == NULL) return -1;
+    n->fg = fg;
+    n->bg = bg;
+    ss_dl_set_text(dl, dl->count - 1, text);
+    return dl->count - 1;
+}
+
+void ss_dl_set_color(SSDisplayList* dl, int idx, uint16_t fg, uint16_t bg) {
+    if (idx < 0 || idx >= dl->count) return;
+    dl->nodes[idx].fg = fg;
+    dl->nodes[idx].bg = bg;
+}
+
+/* A text run covers n * SS_FONT_ADV columns: each glyph's gap column is
+ * painted with bg. */
+void ss_dl_set_text(SSDisplayList* dl, int idx, const char* text) {
+    if (idx < 0 || idx >= dl->count || dl->nodes[idx].kind != SS_DL_TEXT) return;
+    SSDlNode* n = &dl->nodes[idx];
+    n->text = text;
+    n->w = (int16_t)(strlen(text) * SS_FONT_ADV);
+    n->h = SS_FONT_H;
+}
+
+void ss_dl_set_hidden(SSDisplayList* dl, int idx, int hidden) {
+    if (idx < 0 || idx >= dl->count) return;
+    if (hidden) dl->nodes[idx].flags |= SS_DL_HIDDEN;
+    else dl->nodes[idx].flags &= (uint8_t)~SS_DL_HIDDEN;
+}
+
+SSGfxRect ss_dl_bounds(const SSDisplayList* dl, int idx) {
+    if (idx < 0 || idx >= dl->count) return (SSGfxRect){ 0, 0, 0, 0 };
+    const SSDlNode* n = &dl->nodes[idx];
+    return (SSGfxRect){ n->x, n->y, n->w, n->h };
+}
+
+SSGfxRect ss_dl_cells(const SSDisplayList* dl, int idx, int first, int count) {
+    if (idx < 0 || idx >= dl->count || count <= 0) return (SSGfxRect){ 0, 0, 0, 0 };
+    const SSDlNode* n = &dl->nodes[idx];
+    return (SSGfxRect){ n->x + first * SS_FONT_ADV, n->y,
+                        count * SS_FONT_ADV, n->h };
+}
+
+static int node_hits(const SSDlNode* n, int ox, int oy, const SSGfxRect* clip) {
+    int x = ox + n->x, y = oy + n->y;
+    return n->w > 0 && n->h > 0 &&
+           x < clip->x + clip->w && clip->x < x + n->w &&
+           y < clip->y + clip->h && clip->y < y + n->h;
+}
+
+static int node_covers(const SSDlNode* n, int ox, int oy, const SSGfxRect* clip) {
+    int x = ox + n->x, y = oy + n->y;
+    return x <= clip->x && y <= clip->y &&
+           x + n->w >= clip->x + clip->w && y + n->h >= clip->y + clip->h;
+}
+
+/* First node a replay of clip has to draw: the last visible node that
+ * covers the whole clip hides everything recorded before it. */
+static int replay_start(const SSDisplayList* dl, int ox, int oy, const SSGfxRect* clip) {
+    if (clip == NULL) return 0;
+    for (int i = dl->count - 1; i > 0; i--) {
+        const SSDlNode* n = &dl->nodes[i];
+        if (!(n->flags & SS_DL_HIDDEN) && node_covers(n, ox, oy, clip)) return i;
+    }
+    return 0;
+}
+
+int ss_dl_query(const SSDisplayList* dl, int ox, int oy, const SSGfxRect* clip,
+                uint8_t* out, int max) {
+    int found = 0;
+    for (int i = replay_start(dl, ox, oy, clip); i < dl->count; i++) {
+        const SSDlNode* n = &dl->nodes[i];
+        if (n->flags & SS_DL_HIDDEN) continue;
+        if (clip != NULL && !node_hits(n, ox, oy, clip)) continue;
+        if (out != NULL && found < max) out[found] = (uint8_t)i;
+        found++;
+    }
+    return found;
+}
+
+/* Runs of rect nodes go out as one ss_gfx_rect_batch: one clip, merged
+ * same-colour neighbours, address order. */
+void ss_dl_replay(const SSDisplayList* dl, int ox, int oy, const SSGfxRect* clip) {
+    SSGfxRect rects[SS_GFX_BATCH_MAX];
+    uint16_t colors[SS_GFX_BATCH_MAX];
+    int nrects = 0;
+    int start = replay_start(dl, ox, oy, clip);
+    SS_PROFILE_DL_SKIPPED(start);
+    for (int i = start; i < dl->count; i++) {
+        const SSDlNode* n = &dl->nodes[i];
+        if (n->flags & SS_DL_HIDDEN) continue;
+        if (clip != NULL && !node_hits(n, ox, oy, clip)) {
+            SS_PROFILE_DL_SKIPPED(1);
+            continue;
+        }
+        SS_PROFILE_DL_REPLAYED();
+        int x = ox + n->x, y = oy + n->y;
+        if (n->kind == SS_DL_RECT) {
+            if (nrects == SS_GFX_BATCH_MAX) {
+                ss_gfx_rect_batch(rects, colors, nrects, clip);
+                nrects = 0;
+            }
+            rects[nrects] = (SSGfxRect){ x, y, n->w, n->h };
+            colors[nrects++] = n->fg;
+            continue;
+        }
+        if (nrects > 0) {
+            ss_gfx_rect_batch(rects, colors, nrects, clip);
+            nrects = 0;
+        }
+        ss_gfx_draw_text_region(x, y, n->text, n->fg, n->bg, clip);
+    }
+    if (nrects > 0) ss_gfx_rect_batch(rects, colors, nrects, clip);
+}
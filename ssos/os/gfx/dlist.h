@@ -0,0 +1,62 @@
+#ifndef SS_DLIST_H
+#define SS_DLIST_H
+
+#include <stdint.h>
+#include "gfx.h"
+
+/* Retained display list: the draw commands of one window, recorded once in
+ * window-relative coordinates and replayed at the window's position.  A
+ * content change updates its node in place (a colour, a text pointer) and
+ * queues damage for the affected cells; the compositor then replays only
+ * the nodes that intersect the damaged clip.
+ *
+ * Every node is opaque (rects are fills, text runs paint their bg), so a
+ * replay starts at the last node that covers the whole clip: nothing below
+ * it can show.  The node array belongs to the caller; text is not copied,
+ * the node points at the caller's string. */
+
+#define SS_DL_RECT    1
+#define SS_DL_TEXT    2
+
+#define SS_DL_HIDDEN  0x01
+
+typedef struct {
+    uint8_t  kind;
+    uint8_t  flags;
+    int16_t  x, y, w, h;    /* bounds, relative to the list origin */
+    uint16_t fg, bg;        /* a rect uses fg */
+    const char* text;
+} SSDlNode;
+
+typedef struct {
+    SSDlNode* nodes;
+    uint16_t  count;
+    uint16_t  cap;
+} SSDisplayList;
+
+void ss_dl_init(SSDisplayList* dl, SSDlNode* nodes, int cap);
+void ss_dl_clear(SSDisplayList* dl);
+
+/* Append a node; returns its index, or -1 when the list is full. */
+int  ss_dl_rect(SSDisplayList* dl, int x, int y, int w, int h, uint16_t color);
+int  ss_dl_text(SSDisplayList* dl, int x, int y, const char* text,
+                uint16_t fg, uint16_t bg);
+
+/* In-place updates.  They do not draw or queue damage: the caller queues
+ * ss_dl_bounds() or ss_dl_cells() for the window. */
+void ss_dl_set_color(SSDisplayList* dl, int idx, uint16_t fg, uint16_t bg);
+void ss_dl_set_text(SSDisplayList* dl, int idx, const char* text);
+void ss_dl_set_hidden(SSDisplayList* dl, int idx, int hidden);
+SSGfxRect ss_dl_bounds(const SSDisplayList* dl, int idx);
+/* Relative rect of `count` glyph cells of a text node from cell `first`. */
+SSGfxRect ss_dl_cells(const SSDisplayList* dl, int idx, int first, int count);
+
+/* Draw the list with its origin at (ox, oy).  clip == NULL draws every
+ * visible node; otherwise only nodes intersecting clip, clipped to it. */
+void ss_dl_replay(const SSDisplayList* dl, int ox, int oy, const SSGfxRect* clip);
+/* The nodes ss_dl_replay would draw for clip, without drawing: stores up
+ * to max indices in out (which may be NULL) and returns the full count. */
+int  ss_dl_query(const SSDisplayList* dl, int ox, int oy, const SSGfxRect* clip,
+                 uint8_t* out, int max);
+
+#endif /* SS_DLIST_H */
@@ -105,23 +105,47 @@ extern const uint8_t ss_font_data[][SS_FONT_H];
 
 void ss_gfx_init(void);
 void ss_gfx_flip(void);
+/* Draw on the displayed page again (leaves double buffering). */
+void ss_gfx_draw_on_display(void);
 void ss_gfx_clear(uint16_t color);
 void ss_gfx_rect(int x, int y, int w, int h, uint16_t color);
 void ss_gfx_rect_region(SSGfxRect rect, const SSGfxRect* clip, uint16_t color);
+/* Fill n rects (rects[i] in colors[i]) as one submission: clipped once to
+ * clip (NULL = screen), empty rects dropped, touching same-colour rects
+ * merged, and the rest emitted in address order.  Later rects still paint
+ * over earlier ones they overlap, as with n separate ss_gfx_rect calls. */
+#define SS_GFX_BATCH_MAX 32
+void ss_gfx_rect_batch(const SSGfxRect* rects, const uint16_t* colors, int n,
+                       const SSGfxRect* clip);
 void ss_gfx_hline(int x, int y, int w, uint16_t color);
+/* Long-word kernels (burst.s on target, C in vram.c for SS_HOST_TEST).
+ * ss_fill_long_rows fills `count` longs on each of `rows` rows spaced
+ * `stride_bytes` apart; ss_copy_long has memmove semantics. */
 void ss_fill_long(volatile uint32_t* dst, uint32_t val, uint32_t count);
+void ss_fill_long_rows(volatile uint32_t* dst, uint32_t val, uint32_t count,
+                       uint32_t rows, uint32_t stride_bytes);
+void ss_copy_long(volatile uint32_t* dst, const volatile uint32_t* src,
+                  uint32_t count);
 void ss_gfx_fill_stipple(int x, int y, int w, int h, uint16_t c1, uint16_t c2);
+/* Copy the w x h block at (sx,sy) to (dx,dy) on the draw page.  Overlap
+ * safe in any direction; both rects are clipped to the screen. */
+void ss_gfx_blit(int sx, int sy, int dx, int dy, int w, int h);
 void ss_gfx_char(int x, int y, char ch, uint16_t fg, uint16_t bg);
-void ss_gfx_draw_text(int x, int y, const char* str, uint16_t fg, uint16_t bg);
 /* Unclipped, unrolled glyph blit. The caller MUST guarantee the glyph is
- * fully on-screen (0 <= x, x+SS_FONT_W <= display_w, same for y). Used on
- * hot text paths where the bounding rect is already known in-bounds. */
+ * fully on-screen (0 <= x, x+SS_FONT_W <= display_w, same for y). */
 void ss_gfx_char_fast(int x, int y, char ch, uint16_t fg, uint16_t bg);
+void ss_gfx_char_clip(int x, int y, char ch, uint16_t fg, uint16_t bg,
+                      const int* clip_wins, int nclip, int zpos);
+
+/* Text runs.  A string of n glyphs covers [x, x + n*SS_FONT_ADV) and is
+ * drawn scanline by scanline; each glyph's advance gap column is painted
+ * with bg.  _fast is unclipped: the caller MUST guarantee the whole run is
+ * on-screen.  The others clip to the screen, and to `clip` (_region) or to
+ * the windows above clip_wins[zpos] (_clip). */
+void ss_gfx_draw_text(int x, int y, const char* str, uint16_t fg, uint16_t bg);
 void ss_gfx_draw_text_fast(int x, int y, const char* str, uint16_t fg, uint16_t bg);
 void ss_gfx_draw_text_region(int x, int y, const char* str, uint16_t fg, uint16_t bg,
                              const SSGfxRect* clip);
-void ss_gfx_char_clip(int x, int y, char ch, uint16_t fg, uint16_t bg,
-                      const int* clip_wins, int nclip, int zpos);
 void ss_gfx_draw_text_clip(int x, int y, const char* str, uint16_t fg, uint16_t bg,
                            const int* clip_wins, int nclip, int zpos);
 
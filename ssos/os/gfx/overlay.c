@@ -0,0 +1,146 @@
+#include "overlay.h"
+#include "gfx.h"
+#include "profile.h"
+
+#ifdef SS_HOST_TEST
+volatile uint16_t ss_overlay_test_tvram[SS_TVRAM_PLANES * SS_TVRAM_PLANE_WORDS];
+volatile uint16_t ss_overlay_test_vc[2];
+volatile uint16_t ss_overlay_test_tpal[16];
+#endif
+
+/* R2: text layer enable.  R1: two-bit layer priorities, 0 = frontmost,
+ * SP in bits 13-12, TX in 11-10, GR in 9-8; the low byte orders the
+ * graphic pages and is kept. */
+#define VC_TEXT_ON       0x0020
+#define VC_LAYER_MASK    0x3F00
+#define VC_SP_TX_GR      ((0 << 12) | (1 << 10) | (2 << 8))
+#define OVERLAY_COLOR    0xFFFE    /* white, palette entry 1 (plane 0) */
+
+static int active;
+static uint16_t saved_priority, saved_layers, saved_color;
+
+static volatile uint16_t* line_ptr(int y) {
+    return SS_TVRAM_BASE + (uint32_t)y * SS_TVRAM_WORDS_PER_LINE;
+}
+
+/* Pixels from x to the end of its word (leftmost pixel in bit 15). */
+static uint16_t mask_from(int x) {
+    return (uint16_t)(0xFFFFu >> (x & 15));
+}
+
+/* Mask of pixels strictly left of x within its word; x & 15 == 0 means
+ * the whole word. */
+static uint16_t mask_before(int x) {
+    int n = x & 15;
+    return n == 0 ? 0xFFFF : (uint16_t)~(0xFFFFu >> n);
+}
+
+void ss_overlay_fill(int x, int y, int w, int h, int on) {
+    int x1 = x + w, y1 = y + h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 > ss_current_mode->display_w) x1 = ss_current_mode->display_w;
+    if (y1 > ss_current_mode->display_h) y1 = ss_current_mode->display_h;
+    if (x >= x1 || y >= y1) return;
+    SS_PROFILE_OVERLAY_CALL();
+
+    int w0 = x >> 4, w1 = (x1 - 1) >> 4;
+    uint16_t lm = mask_from(x), rm = mask_before(x1);
+    uint16_t fill = on ? 0xFFFF : 0;
+    if (w0 == w1) lm &= rm;
+    for (int yy = y; yy < y1; yy++) {
+        volatile uint16_t* p = line_ptr(yy) + w0;
+        /* Partial edge words are read-modify-write; interior words are
+         * plain stores. */
+        if (lm == 0xFFFF) {
+            *p = fill;
+        } else {
+            *p = (uint16_t)((*p & ~lm) | (fill & lm));
+            SS_PROFILE_OVERLAY_READ(1);
+        }
+        SS_PROFILE_OVERLAY_WRITE(1);
+        if (w0 == w1) continue;
+        for (int i = w0 + 1; i < w1; i++) *++p = fill;
+        p++;
+        if (rm == 0xFFFF) {
+            *p = fill;
+        } else {
+            *p = (uint16_t)((*p & ~rm) | (fill & rm));
+            SS_PROFILE_OVERLAY_READ(1);
+        }
+        SS_PROFILE_OVERLAY_WRITE(w1 - w0);
+    }
+}
+
+void ss_overlay_frame(int x, int y, int w, int h, int on) {
+    if (w <= 0 || h <= 0) return;
+    ss_overlay_fill(x, y, w, 1, on);
+    if (h > 1) ss_overlay_fill(x, y + h - 1, w, 1, on);
+    if (h > 2) {
+        ss_overlay_fill(x, y + 1, 1, h - 2, on);
+        if (w > 1) ss_overlay_fill(x + w - 1, y + 1, 1, h - 2, on);
+    }
+}
+
+/* OR one word of glyph pixels into the plane; words outside the screen
+ * are dropped (display widths are multiples of 16). */
+static void or_word(int y, int word, uint16_t bits) {
+    if (bits == 0 || word < 0 || word >= ss_current_mode->display_w >> 4) return;
+    line_ptr(y)[word] |= bits;
+    SS_PROFILE_OVERLAY_READ(1);
+    SS_PROFILE_OVERLAY_WRITE(1);
+}
+
+void ss_overlay_text(int x, int y, const char* str) {
+    SS_PROFILE_OVERLAY_CALL();
+    for (; *str != '\0'; str++, x += SS_FONT_ADV) {
+        if (x >= ss_current_mode->display_w) break;
+        unsigned char c = (unsigned char)*str;
+        if (x + SS_FONT_W <= 0 || c < 0x20 || c > 0x7E) continue;
+        const uint8_t* g = ss_font_data[c - 0x20];
+        int word = x >> 4;      /* arithmetic: -1 for x in [-16, 0) */
+        for (int r = 0; r < SS_FONT_H; r++) {
+            int yy = y + r;
+            if (yy < 0 || yy >= ss_current_mode->display_h) continue;
+            /* Glyph columns sit in bits 7..3, leftmost first; place them
+             * at x across one or two plane words. */
+            uint32_t span = (uint32_t)g[r] << (24 - (x & 15));
+            or_word(yy, word, (uint16_t)(span >> 16));
+            or_word(yy, word + 1, (uint16_t)span);
+        }
+    }
+}
+
+/* Zero the visible words of one plane. */
+static void clear_plane(int plane) {
+    int words = ss_current_mode->display_w >> 4;
+    volatile uint16_t* base = SS_TVRAM_BASE + (uint32_t)plane * SS_TVRAM_PLANE_WORDS;
+    for (int y = 0; y < ss_current_mode->display_h; y++) {
+        volatile uint16_t* p = base + (uint32_t)y * SS_TVRAM_WORDS_PER_LINE;
+        for (int i = 0; i < words; i++) p[i] = 0;
+    }
+    SS_PROFILE_OVERLAY_WRITE((uint32_t)words * (uint32_t)ss_current_mode->display_h);
+}
+
+void ss_overlay_init(void) {
+    for (int plane = 0; plane < SS_TVRAM_PLANES; plane++) clear_plane(plane);
+    saved_color = SS_TEXT_PAL_BASE[1];
+    SS_TEXT_PAL_BASE[1] = OVERLAY_COLOR;
+    saved_priority = *SS_VC_PRIORITY;
+    saved_layers = *SS_VC_LAYERS;
+    *SS_VC_PRIORITY = (uint16_t)((saved_priority & ~VC_LAYER_MASK) | VC_SP_TX_GR);
+    *SS_VC_LAYERS = (uint16_t)(saved_layers | VC_TEXT_ON);
+    active = 1;
+}
+
+void ss_overlay_shutdown(void) {
+    if (!active) return;
+    SS_TEXT_PAL_BASE[1] = saved_color;
+    *SS_VC_PRIORITY = saved_priority;
+    *SS_VC_LAYERS = saved_layers;
+    active = 0;
+}
+
+int ss_overlay_active(void) {
+    return active;
+}
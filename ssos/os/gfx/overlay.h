@@ -0,0 +1,51 @@
+#ifndef SS_OVERLAY_H
+#define SS_OVERLAY_H
+
+#include <stdint.h>
+
+/* Transient UI (drag outlines, selection boxes, tooltips) drawn into text
+ * VRAM plane 0, which the video controller shows above the graphics.  The
+ * plane is 1 bit per pixel, 16 pixels per word with the leftmost pixel in
+ * bit 15, so an aligned 16-pixel span is one word write and erasing a
+ * shape is a plain clear: GVRAM underneath is never read or rewritten.
+ * Set bits show text palette entry 1; clear bits are transparent. */
+
+/* Text VRAM planes 0-3 (1024x1024 each, 128 bytes per line, plane 1
+ * follows plane 0 and so on) and the video controller.  Native tests
+ * replace the MMIO with RAM like SS_CRTC_BASE. */
+#ifdef SS_HOST_TEST
+extern volatile uint16_t ss_overlay_test_tvram[];
+extern volatile uint16_t ss_overlay_test_vc[];
+extern volatile uint16_t ss_overlay_test_tpal[];
+#define SS_TVRAM_BASE      ss_overlay_test_tvram
+#define SS_VC_PRIORITY     (&ss_overlay_test_vc[0])
+#define SS_VC_LAYERS       (&ss_overlay_test_vc[1])
+#define SS_TEXT_PAL_BASE   ss_overlay_test_tpal
+#else
+#define SS_TVRAM_BASE      ((volatile uint16_t*)0xE00000)
+#define SS_VC_PRIORITY     ((volatile uint16_t*)0xE82500)   /* R1 */
+#define SS_VC_LAYERS       ((volatile uint16_t*)0xE82600)   /* R2 */
+#define SS_TEXT_PAL_BASE   ((volatile uint16_t*)0xE82200)
+#endif
+#define SS_TVRAM_WORDS_PER_LINE 64
+#define SS_TVRAM_PLANE_WORDS    (1024 * SS_TVRAM_WORDS_PER_LINE)
+#define SS_TVRAM_PLANES         4
+
+/* Clears the visible part of all four planes (whatever the host left in
+ * planes 1-3 would otherwise show over the graphics), sets the overlay
+ * colour and puts the text layer on top of graphics (sprites stay in
+ * front of it). */
+void ss_overlay_init(void);
+/* Restores the saved palette entry and layer/priority registers.  The
+ * planes are left as they are: callers erase their own shapes. */
+void ss_overlay_shutdown(void);
+int  ss_overlay_active(void);
+
+/* Set (on != 0) or clear every pixel of the rect. */
+void ss_overlay_fill(int x, int y, int w, int h, int on);
+/* One-pixel frame: set to draw, clear to erase. */
+void ss_overlay_frame(int x, int y, int w, int h, int on);
+/* Glyph pixels only; the text background stays transparent. */
+void ss_overlay_text(int x, int y, const char* str);
+
+#endif /* SS_OVERLAY_H */
@@ -10,6 +10,8 @@
 typedef struct {
     uint32_t primitive_calls;
     uint32_t rect_calls;
+    uint32_t rect_batch_calls;
+    uint32_t rect_batch_merges;
     uint32_t hline_calls;
     uint32_t stipple_calls;
     uint32_t xor_rect_calls;
@@ -17,6 +19,8 @@ typedef struct {
     uint32_t glyph_fast;
     uint32_t glyph_clip;
     uint32_t text_calls;
+    uint32_t glyph_stores;
+    uint32_t glyph_table_builds;
     uint32_t gvram_words_read;
     uint32_t gvram_words_written;
     uint32_t submitted_area;
@@ -47,8 +51,16 @@ typedef struct {
     uint32_t dirty_marks;
     uint32_t dirty_area_submitted;
     uint32_t dirty_area_clipped;
+    uint32_t damage_rects;
+    uint32_t damage_merges;
+    uint32_t damage_flushes;
     uint32_t drag_save_words;
     uint32_t drag_restore_words;
+    uint32_t overlay_calls;
+    uint32_t overlay_words_read;
+    uint32_t overlay_words_written;
+    uint32_t dl_nodes_replayed;
+    uint32_t dl_nodes_skipped;
 } SSGfxProfile;
 
 void ss_gfx_profile_reset(void);
@@ -59,6 +71,8 @@ extern SSGfxProfile ss_gfx_profile;
 
 #define SS_PROFILE_PRIMITIVE_CALL()     do { ss_gfx_profile.primitive_calls++; } while (0)
 #define SS_PROFILE_RECT_CALL()          do { ss_gfx_profile.rect_calls++; } while (0)
+#define SS_PROFILE_RECT_BATCH_CALL()    do { ss_gfx_profile.rect_batch_calls++; } while (0)
+#define SS_PROFILE_RECT_BATCH_MERGE()   do { ss_gfx_profile.rect_batch_merges++; } while (0)
 #define SS_PROFILE_HLINE_CALL()         do { ss_gfx_profile.hline_calls++; } while (0)
 #define SS_PROFILE_STIPPLE_CALL()       do { ss_gfx_profile.stipple_calls++; } while (0)
 #define SS_PROFILE_XOR_RECT_CALL()      do { ss_gfx_profile.xor_rect_calls++; } while (0)
@@ -66,6 +80,8 @@ extern SSGfxProfile ss_gfx_profile;
 #define SS_PROFILE_GLYPH_FAST()         do { ss_gfx_profile.glyph_fast++; } while (0)
 #define SS_PROFILE_GLYPH_CLIP()         do { ss_gfx_profile.glyph_clip++; } while (0)
 #define SS_PROFILE_TEXT_CALL()          do { ss_gfx_profile.text_calls++; } while (0)
+#define SS_PROFILE_GLYPH_STORES(n)      do { ss_gfx_profile.glyph_stores += (uint32_t)(n); } while (0)
+#define SS_PROFILE_GLYPH_TABLE_BUILD()  do { ss_gfx_profile.glyph_table_builds++; } while (0)
 #define SS_PROFILE_GVRAM_READ(words)     do { ss_gfx_profile.gvram_words_read += (uint32_t)(words); } while (0)
 #define SS_PROFILE_GVRAM_WRITE(words)    do { ss_gfx_profile.gvram_words_written += (uint32_t)(words); } while (0)
 #define SS_PROFILE_SUBMITTED_AREA(area)  do { ss_gfx_profile.submitted_area += (uint32_t)(area); } while (0)
@@ -102,11 +118,21 @@ extern SSGfxProfile ss_gfx_profile;
 #define SS_PROFILE_DIRTY_MARK()          do { ss_gfx_profile.dirty_marks++; } while (0)
 #define SS_PROFILE_DIRTY_AREA(area)      do { ss_gfx_profile.dirty_area_submitted += (uint32_t)(area); } while (0)
 #define SS_PROFILE_DIRTY_CLIPPED_AREA(area) do { ss_gfx_profile.dirty_area_clipped += (uint32_t)(area); } while (0)
+#define SS_PROFILE_DAMAGE_RECT()         do { ss_gfx_profile.damage_rects++; } while (0)
+#define SS_PROFILE_DAMAGE_MERGE()        do { ss_gfx_profile.damage_merges++; } while (0)
+#define SS_PROFILE_DAMAGE_FLUSH()        do { ss_gfx_profile.damage_flushes++; } while (0)
 #define SS_PROFILE_DRAG_SAVE(words)      do { ss_gfx_profile.drag_save_words += (uint32_t)(words); } while (0)
 #define SS_PROFILE_DRAG_RESTORE(words)   do { ss_gfx_profile.drag_restore_words += (uint32_t)(words); } while (0)
+#define SS_PROFILE_OVERLAY_CALL()        do { ss_gfx_profile.overlay_calls++; } while (0)
+#define SS_PROFILE_OVERLAY_READ(words)   do { ss_gfx_profile.overlay_words_read += (uint32_t)(words); } while (0)
+#define SS_PROFILE_OVERLAY_WRITE(words)  do { ss_gfx_profile.overlay_words_written += (uint32_t)(words); } while (0)
+#define SS_PROFILE_DL_REPLAYED()         do { ss_gfx_profile.dl_nodes_replayed++; } while (0)
+#define SS_PROFILE_DL_SKIPPED(n)         do { ss_gfx_profile.dl_nodes_skipped += (uint32_t)(n); } while (0)
 #else
 #define SS_PROFILE_PRIMITIVE_CALL()      do { } while (0)
 #define SS_PROFILE_RECT_CALL()           do { } while (0)
+#define SS_PROFILE_RECT_BATCH_CALL()     do { } while (0)
+#define SS_PROFILE_RECT_BATCH_MERGE()    do { } while (0)
 #define SS_PROFILE_HLINE_CALL()          do { } while (0)
 #define SS_PROFILE_STIPPLE_CALL()        do { } while (0)
 #define SS_PROFILE_XOR_RECT_CALL()       do { } while (0)
@@ -114,6 +140,8 @@ extern SSGfxProfile ss_gfx_profile;
 #define SS_PROFILE_GLYPH_FAST()          do { } while (0)
 #define SS_PROFILE_GLYPH_CLIP()          do { } while (0)
 #define SS_PROFILE_TEXT_CALL()           do { } while (0)
+#define SS_PROFILE_GLYPH_STORES(n)       do { } while (0)
+#define SS_PROFILE_GLYPH_TABLE_BUILD()   do { } while (0)
 #define SS_PROFILE_GVRAM_READ(words)     do { } while (0)
 #define SS_PROFILE_GVRAM_WRITE(words)    do { } while (0)
 #define SS_PROFILE_SUBMITTED_AREA(area)  do { } while (0)
@@ -136,8 +164,16 @@ extern SSGfxProfile ss_gfx_profile;
 #define SS_PROFILE_DIRTY_MARK()          do { } while (0)
 #define SS_PROFILE_DIRTY_AREA(area)      do { } while (0)
 #define SS_PROFILE_DIRTY_CLIPPED_AREA(area) do { } while (0)
+#define SS_PROFILE_DAMAGE_RECT()         do { } while (0)
+#define SS_PROFILE_DAMAGE_MERGE()        do { } while (0)
+#define SS_PROFILE_DAMAGE_FLUSH()        do { } while (0)
 #define SS_PROFILE_DRAG_SAVE(words)      do { } while (0)
 #define SS_PROFILE_DRAG_RESTORE(words)   do { } while (0)
+#define SS_PROFILE_OVERLAY_CALL()        do { } while (0)
+#define SS_PROFILE_OVERLAY_READ(words)   do { } while (0)
+#define SS_PROFILE_OVERLAY_WRITE(words)  do { } while (0)
+#define SS_PROFILE_DL_REPLAYED()         do { } while (0)
+#define SS_PROFILE_DL_SKIPPED(n)         do { } while (0)
 #endif
 
 #endif /* SS_GFX_PROFILE_H */
@@ -0,0 +1,241 @@
+#include "region.h"
+#include <string.h>
+
+enum {
+    REGION_UNION,
+    REGION_INTERSECT,
+    REGION_SUBTRACT
+};
+
+void ss_region_init(SSRegion* r) {
+    r->count = 0;
+    r->overflow = 0;
+}
+
+void ss_region_set_rect(SSRegion* r, SSGfxRect rect) {
+    ss_region_init(r);
+    if (rect.w <= 0 || rect.h <= 0) return;
+    r->box[0].x0 = (int16_t)rect.x;
+    r->box[0].y0 = (int16_t)rect.y;
+    r->box[0].x1 = (int16_t)(rect.x + rect.w);
+    r->box[0].y1 = (int16_t)(rect.y + rect.h);
+    r->count = 1;
+}
+
+void ss_region_copy(SSRegion* dst, const SSRegion* src) {
+    if (dst == src) return;
+    dst->count = src->count;
+    dst->overflow = src->overflow;
+    memcpy(dst->box, src->box, src->count * sizeof(SSRegionBox));
+}
+
+/* One past the last box of the band starting at box i. */
+static int band_end(const SSRegion* r, int i) {
+    int j = i + 1;
+    while (j < r->count && r->box[j].y0 == r->box[i].y0) j++;
+    return j;
+}
+
+static int band_edge(const SSRegionBox* band, int e) {
+    return (e & 1) ? band[e >> 1].x1 : band[e >> 1].x0;
+}
+
+/* Emit band [y0, y1) of `op` applied to the x spans of a and b (either may
+ * be empty).  A sweep over the merged span edges yields maximal output
+ * spans, so bands come out canonical.  When the band repeats the previous
+ * one's spans directly below it, the previous band is extended instead.
+ * Returns 0 on box overflow. */
+static int emit_band(SSRegion* out, int* prev, int y0, int y1,
+                     const SSRegionBox* a, int na, const SSRegionBox* b, int nb,
+                     int op) {
+    int start = out->count;
+    int ea = 0, eb = 0;
+    int in_a = 0, in_b = 0, open = 0, sx = 0;
+    na *= 2;
+    nb *= 2;
+    while (ea < na || eb < nb) {
+        int x;
+        if (eb >= nb || (ea < na && band_edge(a, ea) <= band_edge(b, eb))) {
+            x = band_edge(a, ea);
+        } else {
+            x = band_edge(b, eb);
+        }
+        while (ea < na && band_edge(a, ea) == x) { in_a ^= 1; ea++; }
+        while (eb < nb && band_edge(b, eb) == x) { in_b ^= 1; eb++; }
+        int on;
+        if (op == REGION_UNION) on = in_a | in_b;
+        else if (op == REGION_INTERSECT) on = in_a & in_b;
+        else on = in_a & !in_b;
+        if (on && !open) {
+            sx = x;
+            open = 1;
+        } else if (!on && open) {
+            if (out->count >= SS_REGION_MAX_BOXES) return 0;
+            SSRegionBox* o = &out->box[out->count++];
+            o->x0 = (int16_t)sx;
+            o->x1 = (int16_t)x;
+            o->y0 = (int16_t)y0;
+            o->y1 = (int16_t)y1;
+            open = 0;
+        }
+    }
+
+    int n = out->count - start;
+    if (n == 0) return 1;
+    if (*prev >= 0 && start - *prev == n && out->box[*prev].y1 == y0) {
+        int same = 1;
+        for (int k = 0; k < n && same; k++) {
+            same = out->box[*prev + k].x0 == out->box[start + k].x0 &&
+                   out->box[*prev + k].x1 == out->box[start + k].x1;
+        }
+        if (same) {
+            for (int k = 0; k < n; k++) out->box[*prev + k].y1 = (int16_t)y1;
+            out->count = (uint16_t)start;
+            return 1;
+        }
+    }
+    *prev = start;
+    return 1;
+}
+
+static SSGfxRect rect_intersect(SSGfxRect a, SSGfxRect b) {
+    int x0 = a.x > b.x ? a.x : b.x;
+    int y0 = a.y > b.y ? a.y : b.y;
+    int x1 = a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w;
+    int y1 = a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h;
+    return (SSGfxRect){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+static SSGfxRect rect_bound(SSGfxRect a, SSGfxRect b) {
+    if (a.w <= 0 || a.h <= 0) return b;
+    if (b.w <= 0 || b.h <= 0) return a;
+    int x0 = a.x < b.x ? a.x : b.x;
+    int y0 = a.y < b.y ? a.y : b.y;
+    int x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+    int y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+    return (SSGfxRect){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+/* Band sweep over both operands.  y walks the union of band edges; at each
+ * step the bands of a and b that cover y (if any) stay constant until the
+ * next edge, so each step is one emit_band().  The result is built in a
+ * local so dst may alias an operand. */
+static void region_op(SSRegion* dst, const SSRegion* a, const SSRegion* b, int op) {
+    SSRegion out;
+    int prev = -1;
+    int ia = 0, ib = 0;
+    int na = a->count, nb = b->count;
+    int y = 0;
+
+    ss_region_init(&out);
+    if (na > 0) y = a->box[0].y0;
+    if (nb > 0 && (na == 0 || b->box[0].y0 < y)) y = b->box[0].y0;
+
+    while (ia < na || ib < nb) {
+        int ja = ia < na ? band_end(a, ia) : ia;
+        int jb = ib < nb ? band_end(b, ib) : ib;
+        int a_on = ia < na && a->box[ia].y0 <= y;
+        int b_on = ib < nb && b->box[ib].y0 <= y;
+        int next = 0x7FFFFFFF;
+        if (ia < na) next = a_on ? a->box[ia].y1 : a->box[ia].y0;
+        if (ib < nb) {
+            int e = b_on ? b->box[ib].y1 : b->box[ib].y0;
+            if (e < next) next = e;
+        }
+        if (a_on || b_on) {
+            if (!emit_band(&out, &prev, y, next,
+                           &a->box[ia], a_on ? ja - ia : 0,
+                           &b->box[ib], b_on ? jb - ib : 0, op)) {
+                out.overflow = 1;
+                break;
+            }
+        }
+        y = next;
+        if (ia < na && a->box[ia].y1 <= y) ia = ja;
+        if (ib < nb && b->box[ib].y1 <= y) ib = jb;
+    }
+
+    if (out.overflow) {
+        SSGfxRect ea = ss_region_extents(a);
+        SSGfxRect eb = ss_region_extents(b);
+        if (op == REGION_UNION) ss_region_set_rect(&out, rect_bound(ea, eb));
+        else if (op == REGION_INTERSECT) ss_region_set_rect(&out, rect_intersect(ea, eb));
+        else ss_region_set_rect(&out, ea);
+        out.overflow = 1;
+    }
+    out.overflow |= a->overflow | b->overflow;
+    ss_region_copy(dst, &out);
+}
+
+void ss_region_union(SSRegion* dst, const SSRegion* a, const SSRegion* b) {
+    region_op(dst, a, b, REGION_UNION);
+}
+
+void ss_region_intersect(SSRegion* dst, const SSRegion* a, const SSRegion* b) {
+    region_op(dst, a, b, REGION_INTERSECT);
+}
+
+void ss_region_subtract(SSRegion* dst, const SSRegion* a, const SSRegion* b) {
+    region_op(dst, a, b, REGION_SUBTRACT);
+}
+
+void ss_region_union_rect(SSRegion* r, SSGfxRect rect) {
+    SSRegion t;
+    ss_region_set_rect(&t, rect);
+    region_op(r, r, &t, REGION_UNION);
+}
+
+void ss_region_intersect_rect(SSRegion* r, SSGfxRect rect) {
+    SSRegion t;
+    ss_region_set_rect(&t, rect);
+    region_op(r, r, &t, REGION_INTERSECT);
+}
+
+void ss_region_subtract_rect(SSRegion* r, SSGfxRect rect) {
+    SSRegion t;
+    ss_region_set_rect(&t, rect);
+    region_op(r, r, &t, REGION_SUBTRACT);
+}
+
+void ss_region_translate(SSRegion* r, int dx, int dy) {
+    for (int i = 0; i < r->count; i++) {
+        r->box[i].x0 = (int16_t)(r->box[i].x0 + dx);
+        r->box[i].x1 = (int16_t)(r->box[i].x1 + dx);
+        r->box[i].y0 = (int16_t)(r->box[i].y0 + dy);
+        r->box[i].y1 = (int16_t)(r->box[i].y1 + dy);
+    }
+}
+
+int ss_region_is_empty(const SSRegion* r) {
+    return r->count == 0;
+}
+
+int ss_region_contains(const SSRegion* r, int x, int y) {
+    for (int i = 0; i < r->count; i++) {
+        const SSRegionBox* b = &r->box[i];
+        if (b->y0 > y) break;
+        if (y < b->y1 && x >= b->x0 && x < b->x1) return 1;
+    }
+    return 0;
+}
+
+uint32_t ss_region_area(const SSRegion* r) {
+    uint32_t area = 0;
+    for (int i = 0; i < r->count; i++) {
+        const SSRegionBox* b = &r->box[i];
+        area += (uint32_t)(b->x1 - b->x0) * (uint32_t)(b->y1 - b->y0);
+    }
+    return area;
+}
+
+SSGfxRect ss_region_extents(const SSRegion* r) {
+    if (r->count == 0) return (SSGfxRect){ 0, 0, 0, 0 };
+    int x0 = r->box[0].x0, x1 = r->box[0].x1;
+    for (int i = 1; i < r->count; i++) {
+        if (r->box[i].x0 < x0) x0 = r->box[i].x0;
+        if (r->box[i].x1 > x1) x1 = r->box[i].x1;
+    }
+    int y0 = r->box[0].y0;
+    int y1 = r->box[r->count - 1].y1;
+    return (SSGfxRect){ x0, y0, x1 - x0, y1 - y0 };
+}
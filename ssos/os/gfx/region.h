@@ -0,0 +1,62 @@
+#ifndef SS_REGION_H
+#define SS_REGION_H
+
+#include <stdint.h>
+#include "gfx.h"
+
+/* Rectangle-list regions in the X11 style.  Boxes are half-open
+ * [x0, x1) x [y0, y1) and kept y-x banded: sorted by y0 then x0, every
+ * box of a band shares the same y0/y1, boxes in a band never touch, and
+ * vertically adjacent bands with identical x spans are coalesced.  That
+ * canonical form makes every operation a single linear band sweep.
+ *
+ * Storage is fixed so regions can live on the stack or inside window
+ * slots.  An operation whose result does not fit falls back to a bounding
+ * box that contains the exact result (it only repaints more) and sets
+ * `overflow`.  The flag propagates through later operations; callers that
+ * need exactness (a subtract of an overflowed region is no longer a
+ * superset) check it and fall back to their rectangle path. */
+#define SS_REGION_MAX_BOXES 48
+
+typedef struct {
+    int16_t x0, y0, x1, y1;
+} SSRegionBox;
+
+typedef struct {
+    uint16_t count;
+    uint8_t  overflow;
+    SSRegionBox box[SS_REGION_MAX_BOXES];
+} SSRegion;
+
+void ss_region_init(SSRegion* r);
+void ss_region_set_rect(SSRegion* r, SSGfxRect rect);
+void ss_region_copy(SSRegion* dst, const SSRegion* src);
+/* dst may alias a or b. */
+void ss_region_union(SSRegion* dst, const SSRegion* a, const SSRegion* b);
+void ss_region_intersect(SSRegion* dst, const SSRegion* a, const SSRegion* b);
+void ss_region_subtract(SSRegion* dst, const SSRegion* a, const SSRegion* b);
+void ss_region_union_rect(SSRegion* r, SSGfxRect rect);
+void ss_region_intersect_rect(SSRegion* r, SSGfxRect rect);
+void ss_region_subtract_rect(SSRegion* r, SSGfxRect rect);
+void ss_region_translate(SSRegion* r, int dx, int dy);
+int  ss_region_is_empty(const SSRegion* r);
+int  ss_region_contains(const SSRegion* r, int x, int y);
+uint32_t ss_region_area(const SSRegion* r);
+/* Bounding box; {0,0,0,0} when empty. */
+SSGfxRect ss_region_extents(const SSRegion* r);
+
+/* Iteration: boxes 0..count-1 in band order. */
+static inline SSGfxRect ss_region_rect(const SSRegion* r, int i) {
+    const SSRegionBox* b = &r->box[i];
+    return (SSGfxRect){ b->x0, b->y0, b->x1 - b->x0, b->y1 - b->y0 };
+}
+
+/* Region-clipped primitives (vram.c).  Each box is drawn with the matching
+ * rect-clipped primitive, so NULL or empty clip regions draw nothing. */
+void ss_gfx_rect_rgn(SSGfxRect rect, const SSRegion* clip, uint16_t color);
+void ss_gfx_fill_stipple_rgn(SSGfxRect rect, const SSRegion* clip,
+                             uint16_t c1, uint16_t c2);
+void ss_gfx_draw_text_rgn(int x, int y, const char* str, uint16_t fg, uint16_t bg,
+                          const SSRegion* clip);
+
+#endif /* SS_REGION_H */
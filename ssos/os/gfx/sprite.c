@@ -0,0 +1,19 @@
+#include "cursor.h"
+
+#include <x68k/iocs.h>
+
+/* SP_INIT turns the sprite display off, clears every scroll register and
+ * programs the sprite/BG timing for the current CRT mode; it returns -1
+ * when that mode has no sprite screen.  PCG RAM may only be written while
+ * the display is off. */
+int ss_sprite_hw_begin(void) {
+    return _iocs_sp_init() < 0 ? -1 : 0;
+}
+
+void ss_sprite_hw_on(void) {
+    _iocs_sp_on();
+}
+
+void ss_sprite_hw_off(void) {
+    _iocs_sp_off();
+}
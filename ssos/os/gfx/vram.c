@@ -1,5 +1,6 @@
 #include "gfx.h"
 #include "profile.h"
+#include "region.h"
 #include <stdint.h>
 #include <string.h>
 
@@ -17,27 +18,37 @@ volatile uint16_t ss_gfx_test_crtc[32];
 #define SS_GFX_PAGE1 ((volatile uint16_t*)0xC80000)
 #endif
 
+/* Geometry the per-mode kernels are compiled for; the mode table below is
+ * built from the same numbers.  Strides are in words. */
+#define MODE8_W        512
+#define MODE8_H        512
+#define MODE8_STRIDE   512
+#define MODE16_W       768
+#define MODE16_H       512
+#define MODE16_STRIDE  1024
+#define PAGE_LINES     512
+
 /* Graphics Mode Table */
 static const SSGfxMode mode_table[] = {
     [SS_CRTMOD_8] = {
         .crtmod = 8,
         .screen_w = 512, .screen_h = 512,
-        .display_w = 512, .display_h = 512,
+        .display_w = MODE8_W, .display_h = MODE8_H,
         .color_count = 256,
         .page_count = 2,
-        .bytes_per_line = 1024,
-        .page_size = 1024 * 512,
+        .bytes_per_line = MODE8_STRIDE * 2,
+        .page_size = MODE8_STRIDE * 2 * PAGE_LINES,
         .page0 = SS_GFX_PAGE0,
         .page1 = SS_GFX_PAGE1,
     },
     [SS_CRTMOD_16] = {
         .crtmod = 16,
         .screen_w = 1024, .screen_h = 1024,
-        .display_w = 768, .display_h = 512,
+        .display_w = MODE16_W, .display_h = MODE16_H,
         .color_count = 16,
         .page_count = 1,
-        .bytes_per_line = 2048,
-        .page_size = 2048 * 512,
+        .bytes_per_line = MODE16_STRIDE * 2,
+        .page_size = MODE16_STRIDE * 2 * PAGE_LINES,
         .page0 = SS_GFX_PAGE0,
         .page1 = NULL,
     },
@@ -46,13 +57,6 @@ static const SSGfxMode mode_table[] = {
 /* Current graphics mode pointer (default: mode 16) */
 const SSGfxMode* ss_current_mode = &mode_table[SS_CRTMOD_16];
 
-/* Mode Selection Function */
-void ss_gfx_set_mode(int mode) {
-    if (mode == SS_CRTMOD_8 || mode == SS_CRTMOD_16) {
-        ss_current_mode = &mode_table[mode];
-    }
-}
-
 volatile uint16_t* ss_draw_page;
 volatile uint16_t* ss_display_page;
 uint8_t ss_draw_idx;
@@ -180,6 +184,9 @@ const uint8_t ss_font_data[][SS_FONT_H] = {
     {0x00, 0x00, 0x00, 0x48, 0xB0, 0x00, 0x00, 0x00}, /* 0x7E ~ */
 };
 
+/* Portable kernels for host builds.  Target builds link the movem.l burst
+ * versions in burst.s; the QEMU gfx tests cross-check the two. */
+#if defined(SS_HOST_TEST) && !defined(SS_GFX_ASM_KERNELS)
 void ss_fill_long(volatile uint32_t* dst, uint32_t val, uint32_t count) {
     while (count >= 4) {
         *dst++ = val; *dst++ = val;
@@ -189,6 +196,26 @@ void ss_fill_long(volatile uint32_t* dst, uint32_t val, uint32_t count) {
     while (count--) *dst++ = val;
 }
 
+void ss_fill_long_rows(volatile uint32_t* dst, uint32_t val, uint32_t count,
+                       uint32_t rows, uint32_t stride_bytes) {
+    while (rows--) {
+        ss_fill_long(dst, val, count);
+        dst = (volatile uint32_t*)((volatile uint8_t*)dst + stride_bytes);
+    }
+}
+
+void ss_copy_long(volatile uint32_t* dst, const volatile uint32_t* src,
+                  uint32_t count) {
+    if (dst > src) {
+        dst += count;
+        src += count;
+        while (count--) *--dst = *--src;
+    } else {
+        while (count--) *dst++ = *src++;
+    }
+}
+#endif
+
 static void dma_fill_init(void) {
     const uint8_t dcr = 0x08;
     const uint8_t ocr = 0x19; /* MAR=RAM (dma_fill_buf) -> DAR=GVRAM */
@@ -208,10 +235,19 @@ static void dma_fill_init(void) {
     SS_PROFILE_DMA_CONFIG(dcr, ocr, scr, mfc, dfc, bfc);
 }
 
+/* Words of dma_fill_buf already holding dma_fill_value.  Consecutive fills
+ * of one colour (a batch emits them together) reuse the buffer. */
+static uint16_t dma_fill_value;
+static int dma_fill_count;
+
 void ss_dma_fill_setup(uint16_t value, int count) {
-    for (int i = 0; i < count && i < 512; i++) {
+    if (count > 512) count = 512;
+    if (value == dma_fill_value && count <= dma_fill_count) return;
+    for (int i = 0; i < count; i++) {
         dma_fill_buf[i] = value;
     }
+    dma_fill_value = value;
+    dma_fill_count = count;
 }
 
 int ss_dma_fill_row(volatile uint16_t* dst, int count) {
@@ -268,6 +304,11 @@ void ss_gfx_flip(void) {
     SS_CRTC_BASE[SS_CRTC_SCROLL_Y] = ss_display_idx ? (uint16_t)ss_current_mode->screen_h : 0;
 }
 
+void ss_gfx_draw_on_display(void) {
+    ss_draw_idx = ss_display_idx;
+    ss_draw_page = ss_display_page;
+}
+
 void ss_gfx_clear(uint16_t color) {
     uint32_t c2 = ((uint32_t)color << 16) | color;
     uint32_t n = (uint32_t)(ss_current_mode->page_size / 4);
@@ -276,84 +317,20 @@ void ss_gfx_clear(uint16_t color) {
     SS_PROFILE_GVRAM_WRITE(ss_current_mode->page_size / 2);
 }
 
-void ss_gfx_rect(int x, int y, int w, int h, uint16_t color) {
-    int submitted_w = w;
-    int submitted_h = h;
-    SS_PROFILE_PRIMITIVE_CALL();
-    SS_PROFILE_RECT_CALL();
-    if (submitted_w > 0 && submitted_h > 0)
-        SS_PROFILE_SUBMITTED_AREA((uint32_t)submitted_w * (uint32_t)submitted_h);
-    if (x < 0) { w += x; x = 0; }
-    if (y < 0) { h += y; y = 0; }
-    if (x + w > ss_current_mode->display_w) w = ss_current_mode->display_w - x;
-    if (y + h > ss_current_mode->display_h) h = ss_current_mode->display_h - y;
-    if (w <= 0 || h <= 0) return;
-    SS_PROFILE_CLIPPED_AREA((uint32_t)w * (uint32_t)h);
-    SS_PROFILE_GVRAM_WRITE((uint32_t)w * (uint32_t)h);
-
-    uint32_t c2 = ((uint32_t)color << 16) | color;
-    uint32_t stride = ss_current_mode->bytes_per_line / 2;  /* words per line */
+/* Two pixels as one long in GVRAM memory order (left pixel at the lower
+ * address).  Going through memory keeps little-endian host builds producing
+ * the same pixels as the big-endian target. */
+static uint32_t pixel_pair(uint16_t left, uint16_t right) {
+    union { uint16_t w[2]; uint32_t l; } u;
+    u.w[0] = left;
+    u.w[1] = right;
+    return u.l;
+}
 
-    /* Validate VRAM pointer range */
-    volatile uint16_t* vram_start = ss_draw_page;
-    volatile uint16_t* vram_end = ss_draw_page + ss_current_mode->page_size / 2;
-
-    if (w > SS_DMA_FILL_THRESHOLD && w <= 512 && h > 4 &&
-        !dma_disabled_after_timeout) {
-        ss_dma_fill_setup(color, w);
-        dma_fill_init();
-        int ok = 1;
-        int dma_rows = 0;
-        for (int row = y; row < y + h && ok; row++) {
-            volatile uint16_t* b = ss_draw_page + row * stride + x;
-            /* Check if pointer is within valid VRAM range */
-            if (b < vram_start || b + w > vram_end) {
-                ok = 0;
-                break;
-            }
-            SS_PROFILE_DMA_ATTEMPT();
-            int dma_result = ss_dma_fill_row(b, w);
-            if (dma_result == 0) {
-                SS_PROFILE_DMA_OK();
-                dma_rows++;
-            } else {
-                if (dma_result == -2) {
-                    SS_PROFILE_DMA_TIMEOUT();
-                    dma_disabled_after_timeout = 1;
-                } else {
-                    SS_PROFILE_DMA_ERROR();
-                }
-                ok = 0;
-            }
-        }
-        dma_ch2->ccr = 0x00;
-        if (ok) return;
-        /* Completed DMA rows are already correct.  Starting CPU fallback at
-         * the failed row avoids redundant GVRAM writes after a partial DMA
-         * sequence while still rewriting a row whose transfer failed. */
-        y += dma_rows;
-        h -= dma_rows;
-        SS_PROFILE_DMA_FALLBACK_ROWS(h);
-    }
-
-    for (int row = y; row < y + h; row++) {
-        volatile uint16_t* b = ss_draw_page + row * stride;
-        /* Check if pointer is within valid VRAM range */
-        if (b < vram_start || b + x + w > vram_end) break;
-        
-        int cx = x;
-        if (cx & 1) {
-            b[cx++] = color;
-        }
-        int n = (x + w - cx) / 2;
-        /* Additional check before ss_fill_long */
-        volatile uint32_t* dst = (volatile uint32_t*)(b + cx);
-        if ((volatile uint16_t*)dst + n * 2 > vram_end) break;
-        
-        ss_fill_long(dst, c2, (uint32_t)n);
-        if ((x + w - cx) & 1) {
-            b[x + w - 1] = color;
-        }
+static void fill_column(volatile uint16_t* p, uint32_t stride, int h, uint16_t color) {
+    while (h-- > 0) {
+        *p = color;
+        p += stride;
     }
 }
 
@@ -379,41 +356,11 @@ void ss_gfx_hline(int x, int y, int w, uint16_t color) {
     ss_gfx_rect(x, y, w, 1, color);
 }
 
-void ss_gfx_fill_stipple(int x, int y, int w, int h, uint16_t c1, uint16_t c2) {
-    int submitted_w = w;
-    int submitted_h = h;
-    SS_PROFILE_PRIMITIVE_CALL();
-    SS_PROFILE_STIPPLE_CALL();
-    if (submitted_w > 0 && submitted_h > 0)
-        SS_PROFILE_SUBMITTED_AREA((uint32_t)submitted_w * (uint32_t)submitted_h);
-    if (x < 0) { w += x; x = 0; }
-    if (y < 0) { h += y; y = 0; }
-    if (x + w > ss_current_mode->display_w) w = ss_current_mode->display_w - x;
-    if (y + h > ss_current_mode->display_h) h = ss_current_mode->display_h - y;
-    if (w <= 0 || h <= 0) return;
-    SS_PROFILE_CLIPPED_AREA((uint32_t)w * (uint32_t)h);
-    SS_PROFILE_GVRAM_WRITE((uint32_t)w * (uint32_t)h);
-
-    int x1 = x + w - 1;
-    int y1 = y + h - 1;
-    uint32_t stride = ss_current_mode->bytes_per_line / 2;  /* words per line */
-
-    uint32_t pat[2];
-    pat[0] = ((uint32_t)c2 << 16) | c1;
-    pat[1] = ((uint32_t)c1 << 16) | c2;
-
-    for (int yy = y; yy <= y1; yy++) {
-        volatile uint16_t* b = ss_draw_page + yy * stride;
-        int xx = x;
-        if (xx & 1) {
-            b[xx] = ((xx + yy) & 1) ? c1 : c2;
-            xx++;
-        }
-        int n = (x1 - xx + 1) / 2;
-        ss_fill_long((volatile uint32_t*)(b + xx), pat[yy & 1], (uint32_t)n);
-        if ((x1 - xx + 1) & 1) {
-            b[x1] = ((x1 + yy) & 1) ? c1 : c2;
-        }
+static void stipple_column(volatile uint16_t* p, uint32_t stride, int h, int parity,
+                           uint16_t c1, uint16_t c2) {
+    for (int r = 0; r < h; r++) {
+        *p = ((parity + r) & 1) ? c1 : c2;
+        p += stride;
     }
 }
 
@@ -439,84 +386,140 @@ void ss_gfx_char(int x, int y, char ch, uint16_t fg, uint16_t bg) {
         }
     }
     SS_PROFILE_GVRAM_WRITE(writes);
+    SS_PROFILE_GLYPH_STORES(writes);
 }
 
-void ss_gfx_draw_text(int x, int y, const char* str, uint16_t fg, uint16_t bg) {
-    SS_PROFILE_TEXT_CALL();
-    while (*str) {
-        ss_gfx_char(x, y, *str++, fg, bg);
-        x += SS_FONT_ADV;
+/* Expanded glyph rows for the current fg/bg pair.  Index is the five font
+ * bits (column 0 in bit 4).  Each entry holds the 6-pixel slice (five
+ * columns plus the bg advance gap) as words and as memory-order pairs for
+ * both x parities, so a row is three stores instead of per-bit tests. */
+typedef struct {
+    uint32_t even[3];   /* (px0,px1) (px2,px3) (px4,gap) when x is even */
+    uint32_t odd[2];    /* (px1,px2) (px3,px4) when x is odd */
+    uint32_t join;      /* (gap of the previous glyph, px0) */
+    uint16_t px[SS_FONT_ADV];
+} SSGlyphRow;
+
+static SSGlyphRow glyph_rows[32];
+static uint16_t glyph_rows_fg;
+static uint16_t glyph_rows_bg;
+static uint8_t glyph_rows_valid;
+
+static const SSGlyphRow* glyph_rows_for(uint16_t fg, uint16_t bg) {
+    if (glyph_rows_valid && glyph_rows_fg == fg && glyph_rows_bg == bg) {
+        return glyph_rows;
     }
+    for (int v = 0; v < 32; v++) {
+        SSGlyphRow* e = &glyph_rows[v];
+        for (int b = 0; b < SS_FONT_W; b++) {
+            e->px[b] = (v & (0x10 >> b)) ? fg : bg;
+        }
+        e->px[SS_FONT_W] = bg;
+        e->even[0] = pixel_pair(e->px[0], e->px[1]);
+        e->even[1] = pixel_pair(e->px[2], e->px[3]);
+        e->even[2] = pixel_pair(e->px[4], bg);
+        e->odd[0] = pixel_pair(e->px[1], e->px[2]);
+        e->odd[1] = pixel_pair(e->px[3], e->px[4]);
+        e->join = pixel_pair(bg, e->px[0]);
+    }
+    glyph_rows_fg = fg;
+    glyph_rows_bg = bg;
+    glyph_rows_valid = 1;
+    SS_PROFILE_GLYPH_TABLE_BUILD();
+    return glyph_rows;
 }
 
-void ss_gfx_char_fast(int x, int y, char ch, uint16_t fg, uint16_t bg) {
-    /* Caller guarantees the glyph is fully on-screen, so we drop the
-     * per-pixel bounds checks and unroll the 5 font columns. The row
-     * pointer is advanced by the word stride each scanline. */
+static uint8_t glyph_index(char ch, int r) {
     uint8_t c = (uint8_t)ch;
-    SS_PROFILE_PRIMITIVE_CALL();
-    SS_PROFILE_GLYPH_FAST();
     if (c < 0x20 || c > 0x7E) c = ' ';
-    const uint8_t* g = ss_font_data[c - 0x20];
-    uint32_t stride = ss_current_mode->bytes_per_line / 2;  /* words per line */
-    volatile uint16_t* row = ss_draw_page + (uint32_t)y * stride + x;
-    for (int r = 0; r < SS_FONT_H; r++) {
-        uint8_t bits = g[r];
-        row[0] = (bits & 0x80) ? fg : bg;
-        row[1] = (bits & 0x40) ? fg : bg;
-        row[2] = (bits & 0x20) ? fg : bg;
-        row[3] = (bits & 0x10) ? fg : bg;
-        row[4] = (bits & 0x08) ? fg : bg;
-        row += stride;
-    }
-    SS_PROFILE_GVRAM_WRITE(SS_FONT_W * SS_FONT_H);
+    return (uint8_t)(ss_font_data[c - 0x20][r] >> 3);
 }
 
-void ss_gfx_draw_text_fast(int x, int y, const char* str, uint16_t fg, uint16_t bg) {
-    SS_PROFILE_TEXT_CALL();
-    while (*str) {
-        ss_gfx_char_fast(x, y, *str++, fg, bg);
-        x += SS_FONT_ADV;
+/* Emit pixels [sx, ex) of font row r for the text run starting at x.  Whole
+ * glyph slices go out as sequential long stores at either x parity (an odd
+ * run pairs each gap with the next glyph's first column); partial slices at
+ * the span ends fall back to word stores.  Returns the stores issued. */
+static uint32_t text_span(volatile uint16_t* row, int x, const char* str, int r,
+                          int sx, int ex, const SSGlyphRow* rows) {
+    uint32_t stores = 0;
+    int off = sx - x;
+    int k = off / SS_FONT_ADV;
+    int col = off - k * SS_FONT_ADV;
+    int p = sx;
+    const SSGlyphRow* e;
+
+    if (col != 0) {
+        e = &rows[glyph_index(str[k], r)];
+        while (col < SS_FONT_ADV && p < ex) {
+            row[p++] = e->px[col++];
+            stores++;
+        }
+        k++;
     }
-}
 
-static void ss_gfx_char_region(int x, int y, char ch, uint16_t fg, uint16_t bg,
-                               const SSGfxRect* clip) {
-    uint8_t c = (uint8_t)ch;
-    SS_PROFILE_PRIMITIVE_CALL();
-    SS_PROFILE_GLYPH_CLIP();
-    if (c < 0x20 || c > 0x7E) c = ' ';
-    const uint8_t* g = ss_font_data[c - 0x20];
-    uint32_t stride = ss_current_mode->bytes_per_line / 2;
-    uint32_t writes = 0;
-    for (int r = 0; r < SS_FONT_H; r++) {
-        int yy = y + r;
-        if (yy < 0 || yy >= ss_current_mode->display_h ||
-            yy < clip->y || yy >= clip->y + clip->h) continue;
-        volatile uint16_t* row = ss_draw_page + yy * stride;
-        uint8_t bits = g[r];
-        for (int b = 0; b < SS_FONT_W; b++) {
-            int xx = x + b;
-            if (xx < 0 || xx >= ss_current_mode->display_w ||
-                xx < clip->x || xx >= clip->x + clip->w) continue;
-            row[xx] = (bits & (0x80 >> b)) ? fg : bg;
-            writes++;
+    int whole = (ex - p) / SS_FONT_ADV;
+    if (whole > 0) {
+        volatile uint16_t* q = row + p;
+        e = &rows[glyph_index(str[k], r)];
+        if (p & 1) {
+            *q++ = e->px[0];
+            for (int i = 1; ; i++) {
+                *(volatile uint32_t*)(q + 0) = e->odd[0];
+                *(volatile uint32_t*)(q + 2) = e->odd[1];
+                q += 4;
+                if (i == whole) break;
+                e = &rows[glyph_index(str[k + i], r)];
+                *(volatile uint32_t*)q = e->join;
+                q += 2;
+            }
+            *q = e->px[SS_FONT_W];
+            stores += 3 * (uint32_t)whole + 1;
+        } else {
+            for (int i = 1; ; i++) {
+                *(volatile uint32_t*)(q + 0) = e->even[0];
+                *(volatile uint32_t*)(q + 2) = e->even[1];
+                *(volatile uint32_t*)(q + 4) = e->even[2];
+                q += 6;
+                if (i == whole) break;
+                e = &rows[glyph_index(str[k + i], r)];
+            }
+            stores += 3 * (uint32_t)whole;
         }
+        k += whole;
+        p += whole * SS_FONT_ADV;
     }
-    SS_PROFILE_GVRAM_WRITE(writes);
-}
 
-void ss_gfx_draw_text_region(int x, int y, const char* str, uint16_t fg, uint16_t bg,
-                             const SSGfxRect* clip) {
-    if (clip == NULL) {
-        ss_gfx_draw_text_fast(x, y, str, fg, bg);
-        return;
+    if (p < ex) {
+        e = &rows[glyph_index(str[k], r)];
+        for (col = 0; p < ex; col++) {
+            row[p++] = e->px[col];
+            stores++;
+        }
     }
-    SS_PROFILE_TEXT_CALL();
-    while (*str) {
-        ss_gfx_char_region(x, y, *str++, fg, bg, clip);
-        x += SS_FONT_ADV;
+    return stores;
+}
+
+/* Clamp the run [x, x + n * SS_FONT_ADV) x [y, y + SS_FONT_H) to `clip`
+ * (NULL = screen only).  Returns 0 when nothing is left to draw. */
+static int text_run_bounds(int x, int y, int n, const SSGfxRect* clip,
+                           int* x0, int* y0, int* x1, int* y1) {
+    *x0 = x > 0 ? x : 0;
+    *y0 = y > 0 ? y : 0;
+    *x1 = x + n * SS_FONT_ADV;
+    *y1 = y + SS_FONT_H;
+    if (*x1 > ss_current_mode->display_w) *x1 = ss_current_mode->display_w;
+    if (*y1 > ss_current_mode->display_h) *y1 = ss_current_mode->display_h;
+    if (clip != NULL) {
+        if (*x0 < clip->x) *x0 = clip->x;
+        if (*y0 < clip->y) *y0 = clip->y;
+        if (*x1 > clip->x + clip->w) *x1 = clip->x + clip->w;
+        if (*y1 > clip->y + clip->h) *y1 = clip->y + clip->h;
     }
+    return *x0 < *x1 && *y0 < *y1;
+}
+
+static uint32_t text_run_glyphs(int x, int x0, int x1) {
+    return (uint32_t)((x1 - 1 - x) / SS_FONT_ADV - (x0 - x) / SS_FONT_ADV + 1);
 }
 
 static uint32_t ss_gfx_xor_hline(volatile uint16_t* row, int x0, int x1) {
@@ -541,45 +544,253 @@ static uint32_t ss_gfx_xor_hline(volatile uint16_t* row, int x0, int x1) {
     return accesses;
 }
 
+/* The hot primitives are compiled once per mode from vram_kernels.h and
+ * reached through this table, so none of them loads the mode's stride or
+ * bounds at run time. */
+typedef struct {
+    void (*rect)(int x, int y, int w, int h, uint16_t color);
+    void (*fill)(int x, int y, int w, int h, uint16_t color);   /* pre-clipped */
+    void (*blit)(int sx, int sy, int dx, int dy, int w, int h);
+    void (*fill_stipple)(int x, int y, int w, int h, uint16_t c1, uint16_t c2);
+    void (*char_fast)(int x, int y, char ch, uint16_t fg, uint16_t bg);
+    void (*text_run)(int x, int y, const char* str, uint16_t fg, uint16_t bg,
+                     int x0, int y0, int x1, int y1);
+    void (*xor_rect)(int x, int y, int w, int h);
+} SSGfxKernels;
+
+#define K_CAT2(a, b) a##_##b
+#define K_CAT(a, b)  K_CAT2(a, b)
+#define K(name)      K_CAT(name, SS_K_SUFFIX)
+
+#define SS_K_SUFFIX     m8
+#define SS_K_W          MODE8_W
+#define SS_K_H          MODE8_H
+#define SS_K_STRIDE     MODE8_STRIDE
+#define SS_K_PAGE_WORDS (MODE8_STRIDE * PAGE_LINES)
+#include "vram_kernels.h"
+
+#define SS_K_SUFFIX     m16
+#define SS_K_W          MODE16_W
+#define SS_K_H          MODE16_H
+#define SS_K_STRIDE     MODE16_STRIDE
+#define SS_K_PAGE_WORDS (MODE16_STRIDE * PAGE_LINES)
+#include "vram_kernels.h"
+
+#define KERNELS(sfx) { K_CAT(rect, sfx), K_CAT(fill, sfx), \
+                       K_CAT(blit, sfx), K_CAT(fill_stipple, sfx), \
+                       K_CAT(char_fast, sfx), K_CAT(text_run, sfx), K_CAT(xor_rect, sfx) }
+
+static const SSGfxKernels kernel_table[] = {
+    [SS_CRTMOD_8]  = KERNELS(m8),
+    [SS_CRTMOD_16] = KERNELS(m16),
+};
+static const SSGfxKernels* gfx_kernels = &kernel_table[SS_CRTMOD_16];
+
+/* Mode Selection Function */
+void ss_gfx_set_mode(int mode) {
+    if (mode == SS_CRTMOD_8 || mode == SS_CRTMOD_16) {
+        ss_current_mode = &mode_table[mode];
+        gfx_kernels = &kernel_table[mode];
+    }
+}
+
+void ss_gfx_rect(int x, int y, int w, int h, uint16_t color) {
+    gfx_kernels->rect(x, y, w, h, color);
+}
+
+void ss_gfx_blit(int sx, int sy, int dx, int dy, int w, int h) {
+    gfx_kernels->blit(sx, sy, dx, dy, w, h);
+}
+
+void ss_gfx_fill_stipple(int x, int y, int w, int h, uint16_t c1, uint16_t c2) {
+    gfx_kernels->fill_stipple(x, y, w, h, c1, c2);
+}
+
+void ss_gfx_char_fast(int x, int y, char ch, uint16_t fg, uint16_t bg) {
+    gfx_kernels->char_fast(x, y, ch, fg, bg);
+}
+
 void ss_gfx_xor_rect(int x, int y, int w, int h) {
-    /* XOR 0xFFFF on the rectangle perimeter, clipped to the screen.
-     * Self-erasing: two passes over the same rect restore the original,
-     * so callers use it for transient UI (cursor, drag outline) with no
-     * save buffer and no GVRAM read. */
-    uint32_t stride = ss_current_mode->bytes_per_line / 2;
+    gfx_kernels->xor_rect(x, y, w, h);
+}
+
+static void text_run(int x, int y, const char* str, uint16_t fg, uint16_t bg,
+                     int x0, int y0, int x1, int y1) {
+    gfx_kernels->text_run(x, y, str, fg, bg, x0, y0, x1, y1);
+}
+
+/* Two same-coloured rects whose union is their bounding rect: stacked with
+ * equal columns or side by side with equal rows, touching or overlapping. */
+static int batch_mergeable(const SSGfxRect* a, const SSGfxRect* b) {
+    if (a->x == b->x && a->w == b->w)
+        return a->y <= b->y + b->h && b->y <= a->y + a->h;
+    if (a->y == b->y && a->h == b->h)
+        return a->x <= b->x + b->w && b->x <= a->x + a->w;
+    return 0;
+}
+
+static int batch_overlap(const SSGfxRect* a, const SSGfxRect* b) {
+    return a->x < b->x + b->w && b->x < a->x + a->w &&
+           a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+static void batch_chunk(const SSGfxRect* rects, const uint16_t* colors, int n,
+                        const SSGfxRect* clip) {
+    SSGfxRect r[SS_GFX_BATCH_MAX];
+    uint16_t c[SS_GFX_BATCH_MAX];
     int W = ss_current_mode->display_w, H = ss_current_mode->display_h;
-    volatile uint16_t* v = ss_draw_page;
-    uint32_t accesses = 0;
+    int cx0 = 0, cy0 = 0, cx1 = W, cy1 = H;
+    int m = 0;
+
+    if (clip != NULL) {
+        if (clip->x > cx0) cx0 = clip->x;
+        if (clip->y > cy0) cy0 = clip->y;
+        if (clip->x + clip->w < cx1) cx1 = clip->x + clip->w;
+        if (clip->y + clip->h < cy1) cy1 = clip->y + clip->h;
+    }
+    for (int i = 0; i < n; i++) {
+        const SSGfxRect* s = &rects[i];
+        int x0 = s->x > cx0 ? s->x : cx0;
+        int y0 = s->y > cy0 ? s->y : cy0;
+        int x1 = s->x + s->w < cx1 ? s->x + s->w : cx1;
+        int y1 = s->y + s->h < cy1 ? s->y + s->h : cy1;
+        if (s->w > 0 && s->h > 0)
+            SS_PROFILE_SUBMITTED_AREA((uint32_t)s->w * (uint32_t)s->h);
+        if (x0 >= x1 || y0 >= y1) continue;
+        r[m] = (SSGfxRect){ x0, y0, x1 - x0, y1 - y0 };
+        c[m++] = colors[i];
+    }
+
+    /* Merge a later rect into an earlier one of the same colour unless a
+     * differently coloured rect in between paints over it. */
+    for (int i = 0; i < m; i++) {
+        for (int j = i + 1; j < m; ) {
+            int ok = c[j] == c[i] && batch_mergeable(&r[i], &r[j]);
+            for (int k = i + 1; ok && k < j; k++)
+                if (c[k] != c[j] && batch_overlap(&r[k], &r[j])) ok = 0;
+            if (!ok) { j++; continue; }
+            int x1 = r[i].x + r[i].w > r[j].x + r[j].w ? r[i].x + r[i].w : r[j].x + r[j].w;
+            int y1 = r[i].y + r[i].h > r[j].y + r[j].h ? r[i].y + r[i].h : r[j].y + r[j].h;
+            if (r[j].x < r[i].x) r[i].x = r[j].x;
+            if (r[j].y < r[i].y) r[i].y = r[j].y;
+            r[i].w = x1 - r[i].x;
+            r[i].h = y1 - r[i].y;
+            m--;
+            for (int k = j; k < m; k++) { r[k] = r[k + 1]; c[k] = c[k + 1]; }
+            SS_PROFILE_RECT_BATCH_MERGE();
+            j = i + 1;      /* rects skipped so far may touch the grown one */
+        }
+    }
+
+    /* Address order: by top row, then column.  A rect never moves ahead of
+     * an overlapping rect of another colour, so overdraw order is kept. */
+    for (int i = 1; i < m; i++) {
+        SSGfxRect kr = r[i];
+        uint16_t kc = c[i];
+        int j = i;
+        while (j > 0 && (r[j - 1].y > kr.y || (r[j - 1].y == kr.y && r[j - 1].x > kr.x)) &&
+               (c[j - 1] == kc || !batch_overlap(&r[j - 1], &kr))) {
+            r[j] = r[j - 1];
+            c[j] = c[j - 1];
+            j--;
+        }
+        r[j] = kr;
+        c[j] = kc;
+    }
+
+    for (int i = 0; i < m; i++) {
+        SS_PROFILE_RECT_CALL();
+        SS_PROFILE_CLIPPED_AREA((uint32_t)r[i].w * (uint32_t)r[i].h);
+        gfx_kernels->fill(r[i].x, r[i].y, r[i].w, r[i].h, c[i]);
+    }
+}
+
+void ss_gfx_rect_batch(const SSGfxRect* rects, const uint16_t* colors, int n,
+                       const SSGfxRect* clip) {
     SS_PROFILE_PRIMITIVE_CALL();
-    SS_PROFILE_XOR_RECT_CALL();
-    if (w > 0 && h > 0) {
-        int x0 = x < 0 ? 0 : x;
-        int x1 = x + w;
-        if (x1 > W) x1 = W;
-        if (x0 < x1) {
-            if (y >= 0 && y < H) {
-                accesses += ss_gfx_xor_hline(v + y * stride, x0, x1);
-            }
-            int y2 = y + h - 1;
-            if (y2 != y && y2 >= 0 && y2 < H) {
-                accesses += ss_gfx_xor_hline(v + y2 * stride, x0, x1);
+    SS_PROFILE_RECT_BATCH_CALL();
+    for (int i = 0; i < n; i += SS_GFX_BATCH_MAX) {
+        int k = n - i < SS_GFX_BATCH_MAX ? n - i : SS_GFX_BATCH_MAX;
+        batch_chunk(rects + i, colors + i, k, clip);
+    }
+}
+
+void ss_gfx_draw_text(int x, int y, const char* str, uint16_t fg, uint16_t bg) {
+    int x0, y0, x1, y1;
+    SS_PROFILE_PRIMITIVE_CALL();
+    SS_PROFILE_TEXT_CALL();
+    if (!text_run_bounds(x, y, (int)strlen(str), NULL, &x0, &y0, &x1, &y1)) return;
+    for (uint32_t k = text_run_glyphs(x, x0, x1); k > 0; k--) SS_PROFILE_GLYPH_SLOW();
+    text_run(x, y, str, fg, bg, x0, y0, x1, y1);
+}
+
+void ss_gfx_draw_text_fast(int x, int y, const char* str, uint16_t fg, uint16_t bg) {
+    int n = (int)strlen(str);
+    SS_PROFILE_PRIMITIVE_CALL();
+    SS_PROFILE_TEXT_CALL();
+    if (n == 0) return;
+    for (int k = 0; k < n; k++) SS_PROFILE_GLYPH_FAST();
+    text_run(x, y, str, fg, bg, x, y, x + n * SS_FONT_ADV, y + SS_FONT_H);
+}
+
+void ss_gfx_draw_text_region(int x, int y, const char* str, uint16_t fg, uint16_t bg,
+                             const SSGfxRect* clip) {
+    int x0, y0, x1, y1;
+    if (clip == NULL) {
+        ss_gfx_draw_text_fast(x, y, str, fg, bg);
+        return;
+    }
+    SS_PROFILE_PRIMITIVE_CALL();
+    SS_PROFILE_TEXT_CALL();
+    if (!text_run_bounds(x, y, (int)strlen(str), clip, &x0, &y0, &x1, &y1)) return;
+    for (uint32_t k = text_run_glyphs(x, x0, x1); k > 0; k--) SS_PROFILE_GLYPH_CLIP();
+    text_run(x, y, str, fg, bg, x0, y0, x1, y1);
+}
+
+/* Occluder spans.  Windows above clip_wins[zpos] are rectangles, so which
+ * pixels of a scanline they cover only changes at their top and bottom
+ * edges.  The clipped paths walk the target in horizontal bands between
+ * those edges and, per band, step through the visible spans by jumping
+ * over occluders edge to edge: O(spans x windows) per band instead of a
+ * window test for every pixel. */
+static int clip_band_end(const int* clip_wins, int nclip, int zpos, int yy, int y1) {
+    for (int k = zpos + 1; k < nclip; k++) {
+        const int* cw = &clip_wins[k * 4];
+        int top = cw[1], bottom = cw[1] + cw[3];
+        if (top > yy && top < y1) y1 = top;
+        if (bottom > yy && bottom < y1) y1 = bottom;
+    }
+    return y1;
+}
+
+/* Next visible span of scanline yy at or after *sx, ending before x1.
+ * Returns 0 when the rest of the row is covered. */
+static int clip_next_span(const int* clip_wins, int nclip, int zpos, int yy,
+                          int* sx, int x1, int* ex) {
+    int p = *sx;
+    int moved = 1;
+    while (moved && p < x1) {
+        moved = 0;
+        for (int k = zpos + 1; k < nclip; k++) {
+            const int* cw = &clip_wins[k * 4];
+            if (yy >= cw[1] && yy < cw[1] + cw[3] &&
+                p >= cw[0] && p < cw[0] + cw[2]) {
+                p = cw[0] + cw[2];
+                moved = 1;
             }
         }
     }
-    /* Horizontal edges already include the corners.  Touch only interior
-     * scanlines here so every perimeter pixel is XORed exactly once. */
-    for (int dy = 1; dy < h - 1; dy++) {
-        int yy = y + dy;
-        if (yy < 0 || yy >= H) continue;
-        if (x >= 0 && x < W) { v[yy * stride + x] ^= 0xFFFF; accesses++; }
-        int x2 = x + w - 1;
-        if (x2 != x && x2 >= 0 && x2 < W) {
-            v[yy * stride + x2] ^= 0xFFFF;
-            accesses++;
+    if (p >= x1) return 0;
+    int e = x1;
+    for (int k = zpos + 1; k < nclip; k++) {
+        const int* cw = &clip_wins[k * 4];
+        if (yy >= cw[1] && yy < cw[1] + cw[3] && cw[0] > p && cw[0] < e) {
+            e = cw[0];
         }
     }
-    SS_PROFILE_GVRAM_READ(accesses);
-    SS_PROFILE_GVRAM_WRITE(accesses);
+    *sx = p;
+    *ex = e;
+    return 1;
 }
 
 void ss_gfx_char_clip(int x, int y, char ch, uint16_t fg, uint16_t bg,
@@ -591,37 +802,117 @@ void ss_gfx_char_clip(int x, int y, char ch, uint16_t fg, uint16_t bg,
     if (c < 0x20 || c > 0x7E) c = ' ';
     const uint8_t* g = ss_font_data[c - 0x20];
     uint32_t stride = ss_current_mode->bytes_per_line / 2;  /* words per line */
-    for (int r = 0; r < SS_FONT_H; r++) {
-        int yy = y + r;
-        if (yy < 0 || yy >= ss_current_mode->display_h) continue;
-        volatile uint16_t* row = ss_draw_page + yy * stride;
-        uint8_t bits = g[r];
-        for (int b = 0; b < SS_FONT_W; b++) {
-            int xx = x + b;
-            if (xx < 0 || xx >= ss_current_mode->display_w) continue;
-            int covered = 0;
-            for (int k = zpos + 1; k < nclip; k++) {
-                const int* cw = &clip_wins[k * 4];
-                if (xx >= cw[0] && xx < cw[0] + cw[2] &&
-                    yy >= cw[1] && yy < cw[1] + cw[3]) {
-                    covered = 1;
-                    break;
+    int x0 = x > 0 ? x : 0;
+    int y0 = y > 0 ? y : 0;
+    int x1 = x + SS_FONT_W;
+    int y1 = y + SS_FONT_H;
+    if (x1 > ss_current_mode->display_w) x1 = ss_current_mode->display_w;
+    if (y1 > ss_current_mode->display_h) y1 = ss_current_mode->display_h;
+    if (x0 >= x1) y1 = y0;
+    for (int yb = y0; yb < y1; ) {
+        int ye = clip_band_end(clip_wins, nclip, zpos, yb, y1);
+        int sx = x0, ex;
+        while (clip_next_span(clip_wins, nclip, zpos, yb, &sx, x1, &ex)) {
+            for (int yy = yb; yy < ye; yy++) {
+                volatile uint16_t* row = ss_draw_page + yy * stride;
+                uint8_t bits = g[yy - y];
+                for (int xx = sx; xx < ex; xx++) {
+                    row[xx] = (bits & (0x80 >> (xx - x))) ? fg : bg;
                 }
             }
-            if (!covered) {
-                row[xx] = (bits & (0x80 >> b)) ? fg : bg;
-                writes++;
-            }
+            writes += (uint32_t)(ex - sx) * (uint32_t)(ye - yb);
+            sx = ex;
         }
+        yb = ye;
     }
     SS_PROFILE_GVRAM_WRITE(writes);
+    SS_PROFILE_GLYPH_STORES(writes);
 }
 
 void ss_gfx_draw_text_clip(int x, int y, const char* str, uint16_t fg, uint16_t bg,
                            const int* clip_wins, int nclip, int zpos) {
+    /* Occluder-aware run: the visible spans are found once per band and
+     * every span goes through the same text_span() core as the fast and
+     * region variants. */
+    int x0, y0, x1, y1;
+    SS_PROFILE_PRIMITIVE_CALL();
+    SS_PROFILE_TEXT_CALL();
+    if (!text_run_bounds(x, y, (int)strlen(str), NULL, &x0, &y0, &x1, &y1)) return;
+    for (uint32_t k = text_run_glyphs(x, x0, x1); k > 0; k--) SS_PROFILE_GLYPH_CLIP();
+
+    const SSGlyphRow* rows = glyph_rows_for(fg, bg);
+    uint32_t stride = ss_current_mode->bytes_per_line / 2;  /* words per line */
+    uint32_t writes = 0;
+    uint32_t stores = 0;
+    for (int yb = y0; yb < y1; ) {
+        int ye = clip_band_end(clip_wins, nclip, zpos, yb, y1);
+        int sx = x0, ex;
+        while (clip_next_span(clip_wins, nclip, zpos, yb, &sx, x1, &ex)) {
+            volatile uint16_t* row = ss_draw_page + (uint32_t)yb * stride;
+            for (int yy = yb; yy < ye; yy++) {
+                stores += text_span(row, x, str, yy - y, sx, ex, rows);
+                row += stride;
+            }
+            writes += (uint32_t)(ex - sx) * (uint32_t)(ye - yb);
+            sx = ex;
+        }
+        yb = ye;
+    }
+    SS_PROFILE_GVRAM_WRITE(writes);
+    SS_PROFILE_GLYPH_STORES(stores);
+}
+
+/* Region-clipped primitives.  Boxes are y-x banded, so boxes above the
+ * target are skipped and the walk stops at the first band below it; each
+ * remaining box is an ordinary rect clip. */
+static int rgn_box_clip(const SSRegionBox* b, int x0, int y0, int x1, int y1,
+                        SSGfxRect* out) {
+    if (b->x0 > x0) x0 = b->x0;
+    if (b->y0 > y0) y0 = b->y0;
+    if (b->x1 < x1) x1 = b->x1;
+    if (b->y1 < y1) y1 = b->y1;
+    *out = (SSGfxRect){ x0, y0, x1 - x0, y1 - y0 };
+    return x0 < x1 && y0 < y1;
+}
+
+void ss_gfx_rect_rgn(SSGfxRect rect, const SSRegion* clip, uint16_t color) {
+    SSGfxRect r;
+    if (clip == NULL) return;
+    for (int i = 0; i < clip->count; i++) {
+        const SSRegionBox* b = &clip->box[i];
+        if (b->y0 >= rect.y + rect.h) break;
+        if (rgn_box_clip(b, rect.x, rect.y, rect.x + rect.w, rect.y + rect.h, &r))
+            ss_gfx_rect(r.x, r.y, r.w, r.h, color);
+    }
+}
+
+void ss_gfx_fill_stipple_rgn(SSGfxRect rect, const SSRegion* clip,
+                             uint16_t c1, uint16_t c2) {
+    SSGfxRect r;
+    if (clip == NULL) return;
+    /* The checker phase is absolute (x + y), so pieces line up. */
+    for (int i = 0; i < clip->count; i++) {
+        const SSRegionBox* b = &clip->box[i];
+        if (b->y0 >= rect.y + rect.h) break;
+        if (rgn_box_clip(b, rect.x, rect.y, rect.x + rect.w, rect.y + rect.h, &r))
+            ss_gfx_fill_stipple(r.x, r.y, r.w, r.h, c1, c2);
+    }
+}
+
+void ss_gfx_draw_text_rgn(int x, int y, const char* str, uint16_t fg, uint16_t bg,
+                          const SSRegion* clip) {
+    SSGfxRect r;
+    int n = (int)strlen(str);
+    SS_PROFILE_PRIMITIVE_CALL();
     SS_PROFILE_TEXT_CALL();
-    while (*str) {
-        ss_gfx_char_clip(x, y, *str++, fg, bg, clip_wins, nclip, zpos);
-        x += SS_FONT_ADV;
+    if (clip == NULL || n == 0) return;
+    for (int i = 0; i < clip->count; i++) {
+        const SSRegionBox* b = &clip->box[i];
+        int x0, y0, x1, y1;
+        if (b->y0 >= y + SS_FONT_H) break;
+        if (!rgn_box_clip(b, x, y, x + n * SS_FONT_ADV, y + SS_FONT_H, &r)) continue;
+        if (!text_run_bounds(x, y, n, &r, &x0, &y0, &x1, &y1)) continue;
+        for (uint32_t k = text_run_glyphs(x, x0, x1); k > 0; k--) SS_PROFILE_GLYPH_CLIP();
+        text_run(x, y, str, fg, bg, x0, y0, x1, y1);
     }
 }
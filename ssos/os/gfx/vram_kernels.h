@@ -0,0 +1,281 @@
+/* vram_kernels.h - per-mode pixel kernels.
+ *
+ * Included by vram.c once per graphics mode with these defined:
+ *   SS_K_SUFFIX      name suffix (K(rect) becomes rect_<suffix>)
+ *   SS_K_W, SS_K_H   display size in pixels
+ *   SS_K_STRIDE      words per line (a power of two)
+ *   SS_K_PAGE_WORDS  words per page
+ * With the stride and bounds constant, row * stride folds to a shift
+ * instead of a 68000 mulu, and the clip compares use immediates.  The
+ * bodies are the only copy of each primitive; ss_gfx_set_mode() selects
+ * the instance through the kernel table.  No include guard: this file is
+ * meant to be included repeatedly. */
+
+/* Fill a rect already clipped to the screen (ss_gfx_rect_batch clips a
+ * whole batch up front and comes straight here). */
+static void K(fill)(int x, int y, int w, int h, uint16_t color) {
+    SS_PROFILE_GVRAM_WRITE((uint32_t)w * (uint32_t)h);
+
+    uint32_t c2 = ((uint32_t)color << 16) | color;
+    const uint32_t stride = SS_K_STRIDE;  /* words per line */
+
+    /* Validate VRAM pointer range */
+    volatile uint16_t* vram_start = ss_draw_page;
+    volatile uint16_t* vram_end = ss_draw_page + SS_K_PAGE_WORDS;
+
+    if (w > SS_DMA_FILL_THRESHOLD && w <= 512 && h > 4 &&
+        !dma_disabled_after_timeout) {
+        ss_dma_fill_setup(color, w);
+        dma_fill_init();
+        int ok = 1;
+        int dma_rows = 0;
+        for (int row = y; row < y + h && ok; row++) {
+            volatile uint16_t* b = ss_draw_page + row * stride + x;
+            /* Check if pointer is within valid VRAM range */
+            if (b < vram_start || b + w > vram_end) {
+                ok = 0;
+                break;
+            }
+            SS_PROFILE_DMA_ATTEMPT();
+            int dma_result = ss_dma_fill_row(b, w);
+            if (dma_result == 0) {
+                SS_PROFILE_DMA_OK();
+                dma_rows++;
+            } else {
+                if (dma_result == -2) {
+                    SS_PROFILE_DMA_TIMEOUT();
+                    dma_disabled_after_timeout = 1;
+                } else {
+                    SS_PROFILE_DMA_ERROR();
+                }
+                ok = 0;
+            }
+        }
+        dma_ch2->ccr = 0x00;
+        if (ok) return;
+        /* Completed DMA rows are already correct.  Starting CPU fallback at
+         * the failed row avoids redundant GVRAM writes after a partial DMA
+         * sequence while still rewriting a row whose transfer failed. */
+        y += dma_rows;
+        h -= dma_rows;
+        SS_PROFILE_DMA_FALLBACK_ROWS(h);
+    }
+
+    volatile uint16_t* b = ss_draw_page + (uint32_t)y * stride;
+    /* Clipping keeps the block on screen; one range check replaces the
+     * per-row checks of the old scanline loop. */
+    if (b < vram_start || b + (uint32_t)(h - 1) * stride + x + w > vram_end) return;
+
+    /* Odd edge columns are word stores; the long-aligned interior goes to
+     * the row kernel, which keeps its burst registers loaded for the whole
+     * rectangle instead of re-entering per scanline. */
+    int cx = x;
+    int ex = x + w;
+    if (cx & 1) {
+        fill_column(b + cx, stride, h, color);
+        cx++;
+    }
+    if ((ex & 1) && ex > cx) {
+        ex--;
+        fill_column(b + ex, stride, h, color);
+    }
+    ss_fill_long_rows((volatile uint32_t*)(b + cx), c2, (uint32_t)(ex - cx) / 2,
+                      (uint32_t)h, stride * 2);
+}
+
+static void K(rect)(int x, int y, int w, int h, uint16_t color) {
+    int submitted_w = w;
+    int submitted_h = h;
+    SS_PROFILE_PRIMITIVE_CALL();
+    SS_PROFILE_RECT_CALL();
+    if (submitted_w > 0 && submitted_h > 0)
+        SS_PROFILE_SUBMITTED_AREA((uint32_t)submitted_w * (uint32_t)submitted_h);
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > SS_K_W) w = SS_K_W - x;
+    if (y + h > SS_K_H) h = SS_K_H - y;
+    if (w <= 0 || h <= 0) return;
+    SS_PROFILE_CLIPPED_AREA((uint32_t)w * (uint32_t)h);
+    K(fill)(x, y, w, h, color);
+}
+
+static void K(blit)(int sx, int sy, int dx, int dy, int w, int h) {
+    int W = SS_K_W, H = SS_K_H;
+    SS_PROFILE_PRIMITIVE_CALL();
+    /* Clip source and destination together so both stay on-screen. */
+    if (sx < 0) { w += sx; dx -= sx; sx = 0; }
+    if (dx < 0) { w += dx; sx -= dx; dx = 0; }
+    if (sy < 0) { h += sy; dy -= sy; sy = 0; }
+    if (dy < 0) { h += dy; sy -= dy; dy = 0; }
+    if (sx + w > W) w = W - sx;
+    if (dx + w > W) w = W - dx;
+    if (sy + h > H) h = H - sy;
+    if (dy + h > H) h = H - dy;
+    if (w <= 0 || h <= 0) return;
+    if (sx == dx && sy == dy) return;
+    SS_PROFILE_GVRAM_READ((uint32_t)w * (uint32_t)h);
+    SS_PROFILE_GVRAM_WRITE((uint32_t)w * (uint32_t)h);
+
+    /* Rows are copied away from the overlap: bottom-up when moving down.
+     * Within a row ss_copy_long has memmove semantics; the odd trailing
+     * pixel of a rightward move is copied before the longs overwrite it. */
+    const int32_t stride = SS_K_STRIDE;  /* words per line */
+    int32_t step = stride;
+    if (dy > sy) {
+        sy += h - 1;
+        dy += h - 1;
+        step = -stride;
+    }
+    volatile uint16_t* src = ss_draw_page + (int32_t)sy * stride + sx;
+    volatile uint16_t* dst = ss_draw_page + (int32_t)dy * stride + dx;
+    uint32_t n = (uint32_t)w / 2;
+    int odd = w & 1;
+    for (int r = 0; r < h; r++) {
+        if (odd && dst > src) dst[w - 1] = src[w - 1];
+        ss_copy_long((volatile uint32_t*)dst, (const volatile uint32_t*)src, n);
+        if (odd && dst < src) dst[w - 1] = src[w - 1];
+        src += step;
+        dst += step;
+    }
+}
+
+static void K(fill_stipple)(int x, int y, int w, int h, uint16_t c1, uint16_t c2) {
+    int submitted_w = w;
+    int submitted_h = h;
+    SS_PROFILE_PRIMITIVE_CALL();
+    SS_PROFILE_STIPPLE_CALL();
+    if (submitted_w > 0 && submitted_h > 0)
+        SS_PROFILE_SUBMITTED_AREA((uint32_t)submitted_w * (uint32_t)submitted_h);
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > SS_K_W) w = SS_K_W - x;
+    if (y + h > SS_K_H) h = SS_K_H - y;
+    if (w <= 0 || h <= 0) return;
+    SS_PROFILE_CLIPPED_AREA((uint32_t)w * (uint32_t)h);
+    SS_PROFILE_GVRAM_WRITE((uint32_t)w * (uint32_t)h);
+
+    const uint32_t stride = SS_K_STRIDE;  /* words per line */
+    volatile uint16_t* b = ss_draw_page + (uint32_t)y * stride;
+
+    /* Even and odd rows each repeat one long pattern, so the interior is two
+     * row-kernel calls at twice the stride.  pat[] is indexed by row parity:
+     * pixel (xx, yy) is c1 when xx + yy is odd. */
+    uint32_t pat[2];
+    pat[0] = pixel_pair(c2, c1);
+    pat[1] = pixel_pair(c1, c2);
+
+    int cx = x;
+    int ex = x + w;
+    if (cx & 1) {
+        stipple_column(b + cx, stride, h, cx + y, c1, c2);
+        cx++;
+    }
+    if ((ex & 1) && ex > cx) {
+        ex--;
+        stipple_column(b + ex, stride, h, ex + y, c1, c2);
+    }
+    uint32_t n = (uint32_t)(ex - cx) / 2;
+    ss_fill_long_rows((volatile uint32_t*)(b + cx), pat[y & 1], n,
+                      (uint32_t)(h + 1) / 2, stride * 4);
+    if (h > 1) {
+        ss_fill_long_rows((volatile uint32_t*)(b + stride + cx), pat[(y + 1) & 1], n,
+                          (uint32_t)h / 2, stride * 4);
+    }
+}
+
+static void K(char_fast)(int x, int y, char ch, uint16_t fg, uint16_t bg) {
+    /* Caller guarantees the glyph is fully on-screen, so we drop the
+     * per-pixel bounds checks.  Each row is one table lookup and three
+     * stores, long-word where the x parity allows. */
+    uint8_t c = (uint8_t)ch;
+    SS_PROFILE_PRIMITIVE_CALL();
+    SS_PROFILE_GLYPH_FAST();
+    if (c < 0x20 || c > 0x7E) c = ' ';
+    const uint8_t* g = ss_font_data[c - 0x20];
+    const SSGlyphRow* rows = glyph_rows_for(fg, bg);
+    const uint32_t stride = SS_K_STRIDE;  /* words per line */
+    volatile uint16_t* row = ss_draw_page + (uint32_t)y * stride + x;
+    if (x & 1) {
+        for (int r = 0; r < SS_FONT_H; r++) {
+            const SSGlyphRow* e = &rows[g[r] >> 3];
+            row[0] = e->px[0];
+            *(volatile uint32_t*)(row + 1) = e->odd[0];
+            *(volatile uint32_t*)(row + 3) = e->odd[1];
+            row += stride;
+        }
+    } else {
+        for (int r = 0; r < SS_FONT_H; r++) {
+            const SSGlyphRow* e = &rows[g[r] >> 3];
+            *(volatile uint32_t*)(row + 0) = e->even[0];
+            *(volatile uint32_t*)(row + 2) = e->even[1];
+            row[4] = e->px[4];
+            row += stride;
+        }
+    }
+    SS_PROFILE_GVRAM_WRITE(SS_FONT_W * SS_FONT_H);
+    SS_PROFILE_GLYPH_STORES(3 * SS_FONT_H);
+}
+
+/* Scanline-major run renderer: each of the 8 font rows is walked once
+ * across the whole string, so GVRAM addresses within a row are sequential
+ * and the table lookup for a glyph is shared by its three stores. */
+static void K(text_run)(int x, int y, const char* str, uint16_t fg, uint16_t bg,
+                     int x0, int y0, int x1, int y1) {
+    const SSGlyphRow* rows = glyph_rows_for(fg, bg);
+    const uint32_t stride = SS_K_STRIDE;  /* words per line */
+    volatile uint16_t* row = ss_draw_page + (uint32_t)y0 * stride;
+    uint32_t stores = 0;
+    for (int yy = y0; yy < y1; yy++) {
+        stores += text_span(row, x, str, yy - y, x0, x1, rows);
+        row += stride;
+    }
+    SS_PROFILE_GVRAM_WRITE((uint32_t)(x1 - x0) * (uint32_t)(y1 - y0));
+    SS_PROFILE_GLYPH_STORES(stores);
+}
+
+static void K(xor_rect)(int x, int y, int w, int h) {
+    /* XOR 0xFFFF on the rectangle perimeter, clipped to the screen.
+     * Self-erasing: two passes over the same rect restore the original,
+     * so callers use it for transient UI (cursor, drag outline) with no
+     * save buffer and no GVRAM read. */
+    const uint32_t stride = SS_K_STRIDE;
+    int W = SS_K_W, H = SS_K_H;
+    volatile uint16_t* v = ss_draw_page;
+    uint32_t accesses = 0;
+    SS_PROFILE_PRIMITIVE_CALL();
+    SS_PROFILE_XOR_RECT_CALL();
+    if (w > 0 && h > 0) {
+        int x0 = x < 0 ? 0 : x;
+        int x1 = x + w;
+        if (x1 > W) x1 = W;
+        if (x0 < x1) {
+            if (y >= 0 && y < H) {
+                accesses += ss_gfx_xor_hline(v + y * stride, x0, x1);
+            }
+            int y2 = y + h - 1;
+            if (y2 != y && y2 >= 0 && y2 < H) {
+                accesses += ss_gfx_xor_hline(v + y2 * stride, x0, x1);
+            }
+        }
+    }
+    /* Horizontal edges already include the corners.  Touch only interior
+     * scanlines here so every perimeter pixel is XORed exactly once. */
+    for (int dy = 1; dy < h - 1; dy++) {
+        int yy = y + dy;
+        if (yy < 0 || yy >= H) continue;
+        if (x >= 0 && x < W) { v[yy * stride + x] ^= 0xFFFF; accesses++; }
+        int x2 = x + w - 1;
+        if (x2 != x && x2 >= 0 && x2 < W) {
+            v[yy * stride + x2] ^= 0xFFFF;
+            accesses++;
+        }
+    }
+    SS_PROFILE_GVRAM_READ(accesses);
+    SS_PROFILE_GVRAM_WRITE(accesses);
+}
+
+#undef SS_K_SUFFIX
+#undef SS_K_W
+#undef SS_K_H
+#undef SS_K_STRIDE
+#undef SS_K_PAGE_WORDS
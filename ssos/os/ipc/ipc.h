@@ -25,5 +25,7 @@ void     ss_ipc_init(void);
 int16_t  ss_send(uint16_t target, SSMessage* msg);
 int16_t  ss_recv(SSMessage* msg);
 int16_t  ss_recv_nb(SSMessage* msg);
+/* Messages queued for task target; 0 for an unknown id. */
+uint16_t ss_msg_pending(uint16_t target);
 
 #endif /* SS_IPC_H */
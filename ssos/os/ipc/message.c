@@ -15,9 +15,9 @@ int16_t ss_send(uint16_t target, SSMessage* msg) {
 
     SSMsgQueue* q = &msg_queues[target - 1];
 
-    ss_disable_interrupts();
+    uint16_t sr = ss_irq_save();
     if (q->count >= SS_MSG_MAX) {
-        ss_enable_interrupts();
+        ss_irq_restore(sr);
         return SS_ERR_LIMIT;
     }
 
@@ -27,7 +27,8 @@ int16_t ss_send(uint16_t target, SSMessage* msg) {
 
     q->tail = (q->tail + 1) % SS_MSG_MAX;
     q->count++;
-    ss_enable_interrupts();
+    ss_irq_restore(sr);
+    ss_task_signal(&tcb_table[target - 1], SS_SIG_MSG);
 
     return SS_OK;
 }
@@ -46,16 +47,16 @@ int16_t ss_recv(SSMessage* msg) {
         ss_task_yield();
     }
 
-    ss_disable_interrupts();
+    uint16_t sr = ss_irq_save();
     if (q->count == 0) {
-        ss_enable_interrupts();
+        ss_irq_restore(sr);
         return SS_ERR_STATE;
     }
 
     memcpy(msg, &q->msgs[q->head], sizeof(SSMessage));
     q->head = (q->head + 1) % SS_MSG_MAX;
     q->count--;
-    ss_enable_interrupts();
+    ss_irq_restore(sr);
 
     return SS_OK;
 }
@@ -69,15 +70,20 @@ int16_t ss_recv_nb(SSMessage* msg) {
     uint16_t id = (uint16_t)((curr - tcb_table) + 1);
     SSMsgQueue* q = &msg_queues[id - 1];
 
-    ss_disable_interrupts();
+    uint16_t sr = ss_irq_save();
     if (q->count == 0) {
-        ss_enable_interrupts();
+        ss_irq_restore(sr);
         return SS_ERR_LIMIT;
     }
     memcpy(msg, &q->msgs[q->head], sizeof(SSMessage));
     q->head = (q->head + 1) % SS_MSG_MAX;
     q->count--;
-    ss_enable_interrupts();
+    ss_irq_restore(sr);
 
     return SS_OK;
 }
+
+uint16_t ss_msg_pending(uint16_t target) {
+    if (target == 0 || target > SS_MAX_TASKS) return 0;
+    return msg_queues[target - 1].count;
+}
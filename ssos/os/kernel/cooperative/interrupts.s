@@ -4,6 +4,8 @@
 		.align	2
 		.globl	ss_set_interrupts, ss_restore_interrupts
 		.globl	ss_disable_interrupts, ss_enable_interrupts
+		.globl	ss_irq_save, ss_irq_restore
+		.globl	ss_input_irq_attach, ss_input_irq_detach
 		.globl	ss_tick_counter, ss_vsync_counter
 		.globl	ss_vsync_flag
 		.globl	ss_save_data_base
@@ -22,6 +24,74 @@ ss_enable_interrupts:
 		move.w	#0x2000, %sr
 		rts
 
+		| uint16_t ss_irq_save(void): mask to IPL 7, return the SR it had.
+		| Unlike the pair above this nests and is safe inside an ISR.
+ss_irq_save:
+		move.w	%sr, d0
+		ori.w	#0x0700, %sr
+		rts
+
+		| void ss_irq_restore(uint16_t sr): the word ss_irq_save returned
+		| (a promoted argument: low word of the long at 4(sp)).
+ss_irq_restore:
+		move.w	6(sp), %sr
+		rts
+
+		| ============================================================
+		| ss_input_irq_attach / ss_input_irq_detach - chain the IOCS
+		| keyboard (MFP USART receive, 0x130) and mouse (SCC B receive,
+		| 0x150) handlers.  The chained handler pushes a return frame so
+		| the IOCS handler's rte comes back to it, then calls
+		| ss_input_iocs_key / ss_input_iocs_mouse to post what changed.
+		| ============================================================
+ss_input_irq_attach:
+		move.w	%sr, -(sp)
+		ori.w	#0x0700, %sr
+		tst.l	key_rx_chain
+		bne.s	.irq_attached
+		move.l	0x130, key_rx_chain
+		move.l	#key_rx_handler, 0x130
+		move.l	0x150, mouse_rx_chain
+		move.l	#mouse_rx_handler, 0x150
+	.irq_attached:
+		move.w	(sp)+, %sr
+		rts
+
+ss_input_irq_detach:
+		move.w	%sr, -(sp)
+		ori.w	#0x0700, %sr
+		tst.l	key_rx_chain
+		beq.s	.irq_detached
+		move.l	key_rx_chain, 0x130
+		move.l	mouse_rx_chain, 0x150
+		clr.l	key_rx_chain
+		clr.l	mouse_rx_chain
+	.irq_detached:
+		move.w	(sp)+, %sr
+		rts
+
+key_rx_handler:
+		pea	key_rx_post
+		move.w	%sr, -(sp)
+		move.l	key_rx_chain, -(sp)
+		rts				| into IOCS; its rte returns below
+	key_rx_post:
+		movem.l	d0-d1/a0-a1, -(sp)
+		jsr	ss_input_iocs_key
+		movem.l	(sp)+, d0-d1/a0-a1
+		rte
+
+mouse_rx_handler:
+		pea	mouse_rx_post
+		move.w	%sr, -(sp)
+		move.l	mouse_rx_chain, -(sp)
+		rts
+	mouse_rx_post:
+		movem.l	d0-d1/a0-a1, -(sp)
+		jsr	ss_input_iocs_mouse
+		movem.l	(sp)+, d0-d1/a0-a1
+		rte
+
 		| ============================================================
 		| ss_set_interrupts - Initialize MFP and interrupt vectors
 		| ============================================================
@@ -155,6 +225,9 @@ ss_set_interrupts:
 ss_restore_interrupts:
 		move.w	#0x2700, %sr
 
+		| Unchain the input handlers (0x150 is not in the save area)
+		bsr	ss_input_irq_detach
+
 		| Reset pending
 		move.b	#0x00, 0xe8800b
 		move.b	#0x00, 0xe8800d
@@ -370,6 +443,10 @@ ss_timerd_fire_count:
 ss_context_switch_count:
 		dc.l	0
 		.even
+key_rx_chain:
+		dc.l	0			| IOCS handlers while chained, else 0
+mouse_rx_chain:
+		dc.l	0
 
 		.section .bss
 		.even
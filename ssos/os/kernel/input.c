@@ -0,0 +1,84 @@
+#include "input.h"
+#include "input_trace.h"
+#include "kernel.h"
+#include "scheduler.h"
+#include <string.h>
+
+static SSInputEvent ring[SS_INPUT_QUEUE_SIZE];
+static volatile uint16_t head, tail, count;
+static SSInputSource source;
+static SSTask* notify;
+uint32_t ss_input_dropped;
+
+void ss_input_init(const SSInputSource* src) {
+    uint16_t sr = ss_irq_save();
+    head = tail = count = 0;
+    ss_input_dropped = 0;
+    if (src != NULL) source = *src;
+    else memset(&source, 0, sizeof(source));
+    ss_irq_restore(sr);
+}
+
+void ss_input_notify(SSTask* task) {
+    notify = task;
+}
+
+int16_t ss_input_post(const SSInputEvent* ev) {
+    if (ev == NULL) return SS_ERR_PARAM;
+    /* Posted from ISRs too: restore the SR found, never force IPL 0. */
+    uint16_t sr = ss_irq_save();
+    if (ev->type == SS_INPUT_MOTION && count > 0) {
+        SSInputEvent* last = &ring[(tail + SS_INPUT_QUEUE_SIZE - 1) % SS_INPUT_QUEUE_SIZE];
+        if (last->type == SS_INPUT_MOTION) {
+            *last = *ev;
+            last->time = ss_vsync_counter;
+            ss_irq_restore(sr);
+            ss_task_signal(notify, SS_SIG_INPUT);
+            return SS_OK;
+        }
+    }
+    if (count >= SS_INPUT_QUEUE_SIZE) {
+        ss_input_dropped++;
+        ss_irq_restore(sr);
+        return SS_ERR_LIMIT;
+    }
+    ring[tail] = *ev;
+    ring[tail].time = ss_vsync_counter;
+    tail = (tail + 1) % SS_INPUT_QUEUE_SIZE;
+    count++;
+    ss_irq_restore(sr);
+    ss_task_signal(notify, SS_SIG_INPUT);
+    return SS_OK;
+}
+
+void ss_input_pump(void) {
+    if (source.pump != NULL) source.pump(source.ctx);
+}
+
+int16_t ss_input_poll(SSInputEvent* ev) {
+    if (ev == NULL) return SS_ERR_PARAM;
+    uint16_t sr = ss_irq_save();
+    if (count == 0) {
+        ss_irq_restore(sr);
+        return SS_ERR_LIMIT;
+    }
+    *ev = ring[head];
+    head = (head + 1) % SS_INPUT_QUEUE_SIZE;
+    count--;
+    ss_irq_restore(sr);
+    if (ss_trace_recording != NULL) ss_trace_append(ss_trace_recording, ev);
+    return SS_OK;
+}
+
+int16_t ss_input_wait(SSInputEvent* ev) {
+    if (ev == NULL) return SS_ERR_PARAM;
+    while (1) {
+        if (count == 0) ss_input_pump();
+        if (ss_input_poll(ev) == SS_OK) return SS_OK;
+        ss_task_yield();
+    }
+}
+
+uint16_t ss_input_pending(void) {
+    return count;
+}
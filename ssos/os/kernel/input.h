@@ -0,0 +1,54 @@
+#ifndef SS_INPUT_H
+#define SS_INPUT_H
+
+#include <stdint.h>
+
+/* Input events.  Producers post into one ring: an interrupt handler calls
+ * ss_input_post() directly; a polled device is wrapped in an
+ * SSInputSource whose pump runs when a consumer asks for events.  A
+ * pointer move that finds a motion event still waiting at the tail of
+ * the ring updates it in place, so a burst of mouse packets costs one
+ * event. */
+
+#define SS_INPUT_QUEUE_SIZE 32
+
+#define SS_INPUT_KEY     1      /* key: IOCS B_KEYINP code (shift << 8 | ascii) */
+#define SS_INPUT_MOTION  2      /* x, y: new pointer position */
+#define SS_INPUT_BUTTON  3      /* buttons: new state; x, y: where */
+
+#define SS_INPUT_LEFT    0x01
+#define SS_INPUT_RIGHT   0x02
+
+typedef struct {
+    uint8_t  type;
+    uint8_t  buttons;           /* button state when posted */
+    int16_t  x, y;              /* pointer position when posted */
+    uint16_t key;
+    uint32_t time;              /* ss_vsync_counter when posted */
+} SSInputEvent;
+
+typedef struct {
+    void (*pump)(void* ctx);    /* post what the device has; NULL if IRQ fed */
+    void* ctx;
+} SSInputSource;
+
+struct SSTask;
+
+/* Empty the ring and attach src (NULL: events arrive only by post). */
+void     ss_input_init(const SSInputSource* src);
+/* Signal task (SS_SIG_INPUT) on every post; NULL for none. */
+void     ss_input_notify(struct SSTask* task);
+/* Safe from interrupt handlers.  SS_ERR_LIMIT when the ring is full;
+ * the event is dropped and counted. */
+int16_t  ss_input_post(const SSInputEvent* ev);
+/* Run the source's pump once. */
+void     ss_input_pump(void);
+/* Next event: SS_OK, or SS_ERR_LIMIT at once when there is none. */
+int16_t  ss_input_poll(SSInputEvent* ev);
+/* Next event, yielding to other tasks until one arrives. */
+int16_t  ss_input_wait(SSInputEvent* ev);
+uint16_t ss_input_pending(void);
+
+extern uint32_t ss_input_dropped;
+
+#endif /* SS_INPUT_H */
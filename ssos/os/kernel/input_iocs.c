@@ -0,0 +1,64 @@
+#include "input_iocs.h"
+#include "input.h"
+#include "kernel.h"
+#include <x68k/iocs.h>
+#include <string.h>
+
+/* Pointer state last posted; only changes are posted. */
+static int iocs_mx = -1, iocs_my = -1, iocs_btn = 0;
+
+void ss_input_iocs_key(void) {
+    SSInputEvent ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = SS_INPUT_KEY;
+    ev.x = (int16_t)iocs_mx;
+    ev.y = (int16_t)iocs_my;
+    ev.buttons = (uint8_t)iocs_btn;
+    while (_iocs_b_keysns() > 0) {
+        ev.key = (uint16_t)_iocs_b_keyinp();
+        ss_input_post(&ev);
+    }
+}
+
+void ss_input_iocs_mouse(void) {
+    SSInputEvent ev;
+    /* MS_CURGT (0x75): high word = X, low word = Y.
+     * MS_GETDT (0x74): button state (bit9 = left, bit0 = right).
+     * A packet takes three receive interrupts; only the last one moves
+     * the position IOCS reports. */
+    int pos = _iocs_ms_curgt();
+    int dt  = _iocs_ms_getdt();
+    memset(&ev, 0, sizeof(ev));
+    ev.x = (int16_t)((pos >> 16) & 0xFFFF);
+    ev.y = (int16_t)(pos & 0xFFFF);
+    ev.buttons = (uint8_t)(((dt & 0x0200) ? SS_INPUT_LEFT : 0) |
+                           ((dt & 0x0001) ? SS_INPUT_RIGHT : 0));
+    if (ev.x != iocs_mx || ev.y != iocs_my) {
+        ev.type = SS_INPUT_MOTION;
+        ss_input_post(&ev);
+        iocs_mx = ev.x;
+        iocs_my = ev.y;
+    }
+    if (ev.buttons != iocs_btn) {
+        ev.type = SS_INPUT_BUTTON;
+        ss_input_post(&ev);
+        iocs_btn = ev.buttons;
+    }
+}
+
+void ss_input_iocs_attach(void) {
+    ss_input_init(NULL);
+    /* Sample once with the vectors chained and the receive interrupts
+     * held off, so nothing lands between the sample and the chain. */
+    uint16_t sr = ss_irq_save();
+    iocs_mx = iocs_my = -1;
+    iocs_btn = 0;
+    ss_input_irq_attach();
+    ss_input_iocs_mouse();
+    ss_input_iocs_key();
+    ss_irq_restore(sr);
+}
+
+void ss_input_iocs_detach(void) {
+    ss_input_irq_detach();
+}
@@ -0,0 +1,24 @@
+#ifndef SS_INPUT_IOCS_H
+#define SS_INPUT_IOCS_H
+
+/* IOCS input producer.  The keyboard and mouse receive interrupts stay
+ * IOCS's (key translation, the mouse position it tracks): attaching
+ * chains a handler behind each, and after IOCS has taken the byte the
+ * handler posts what it changed.  Keys and clicks that land between
+ * frames reach the ring, and an idle scene makes no IOCS calls. */
+
+/* Empty the ring, post the current pointer state and any waiting keys,
+ * and chain the receive vectors.  Attaching twice is harmless. */
+void ss_input_iocs_attach(void);
+/* Put the IOCS handlers back (also done by ss_restore_interrupts). */
+void ss_input_iocs_detach(void);
+
+/* Run by the chained handlers, after the IOCS one. */
+void ss_input_iocs_key(void);
+void ss_input_iocs_mouse(void);
+
+/* Vector chaining (interrupts.s; fake_iocs.c on the host). */
+void ss_input_irq_attach(void);
+void ss_input_irq_detach(void);
+
+#endif /* SS_INPUT_IOCS_H */
@@ -0,0 +1,128 @@
+#include "input_trace.h"
+#include "kernel.h"
+#include <string.h>
+
+SSInputTrace* ss_trace_recording;
+
+static const uint8_t trace_magic[4] = { 'S', 'S', 'I', 'T' };
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+int16_t ss_trace_record(SSInputTrace* t, uint8_t* buf, uint32_t size) {
+    if (t == NULL || buf == NULL || size < SS_TRACE_HEADER) return SS_ERR_PARAM;
+    memset(t, 0, sizeof(*t));
+    t->buf = buf;
+    t->size = size;
+    memcpy(buf, trace_magic, sizeof(trace_magic));
+    buf[4] = SS_TRACE_VERSION;
+    buf[5] = 0;
+    t->len = SS_TRACE_HEADER;
+    t->base = ss_vsync_counter;
+    ss_trace_recording = t;
+    return SS_OK;
+}
+
+void ss_trace_stop(void) {
+    ss_trace_recording = NULL;
+}
+
+int16_t ss_trace_append(SSInputTrace* t, const SSInputEvent* ev) {
+    if (t->overflow) return SS_ERR_LIMIT;
+    /* Events posted before the trace started count as its first vsync. */
+    uint32_t when = ev->time - t->base;
+    if (when > 0x7FFFFFFFUL) when = 0;
+    if (when < t->at) when = t->at;
+    uint32_t delta = when - t->at;
+    uint32_t need = delta / SS_TRACE_GAP + 2 + (ev->type == SS_INPUT_KEY ? 2 : 4);
+    if (t->len + need > t->size) {
+        t->overflow = 1;
+        return SS_ERR_LIMIT;
+    }
+
+    uint8_t* p = t->buf + t->len;
+    for (; delta >= SS_TRACE_GAP; delta -= SS_TRACE_GAP) *p++ = SS_TRACE_GAP;
+    *p++ = (uint8_t)delta;
+    *p++ = (uint8_t)((ev->type & 0x0F) | (ev->buttons << 4));
+    if (ev->type == SS_INPUT_KEY) {
+        put16(p, ev->key);
+        p += 2;
+    } else {
+        put16(p, (uint16_t)ev->x);
+        put16(p + 2, (uint16_t)ev->y);
+        p += 4;
+    }
+    t->len = (uint32_t)(p - t->buf);
+    t->at = when;
+    t->events++;
+    return SS_OK;
+}
+
+int16_t ss_trace_open(SSInputTrace* t, uint8_t* buf, uint32_t len) {
+    if (t == NULL || buf == NULL || len < SS_TRACE_HEADER) return SS_ERR_PARAM;
+    if (memcmp(buf, trace_magic, sizeof(trace_magic)) != 0 || buf[4] != SS_TRACE_VERSION)
+        return SS_ERR_PARAM;
+    memset(t, 0, sizeof(*t));
+    t->buf = buf;
+    t->size = len;
+    t->len = len;
+    t->pos = SS_TRACE_HEADER;
+    t->base = ss_vsync_counter;
+    return SS_OK;
+}
+
+/* Post every event due by now.  A record cut short by the end of the
+ * buffer ends the trace. */
+static void trace_pump(void* ctx) {
+    SSInputTrace* t = ctx;
+    uint32_t now = ss_vsync_counter - t->base;
+    while (t->pos < t->len) {
+        const uint8_t* p = t->buf + t->pos;
+        uint32_t when = t->at, n = 0;
+        while (t->pos + n < t->len && p[n] == SS_TRACE_GAP) {
+            when += SS_TRACE_GAP;
+            n++;
+        }
+        if (t->pos + n + 2 > t->len) {
+            t->pos = t->len;
+            break;
+        }
+        when += p[n];
+        if (when > now) break;
+
+        SSInputEvent ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.type = p[n + 1] & 0x0F;
+        ev.buttons = p[n + 1] >> 4;
+        uint32_t size = n + 2 + (ev.type == SS_INPUT_KEY ? 2 : 4);
+        if (t->pos + size > t->len) {
+            t->pos = t->len;
+            break;
+        }
+        if (ev.type == SS_INPUT_KEY) {
+            ev.key = get16(p + n + 2);
+        } else {
+            ev.x = (int16_t)get16(p + n + 2);
+            ev.y = (int16_t)get16(p + n + 4);
+        }
+        ss_input_post(&ev);
+        t->pos += size;
+        t->at = when;
+        t->events++;
+    }
+}
+
+SSInputSource ss_trace_source(SSInputTrace* t) {
+    SSInputSource src = { trace_pump, t };
+    return src;
+}
+
+int ss_trace_done(const SSInputTrace* t) {
+    return t->pos >= t->len;
+}
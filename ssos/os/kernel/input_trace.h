@@ -0,0 +1,62 @@
+#ifndef SS_INPUT_TRACE_H
+#define SS_INPUT_TRACE_H
+
+#include <stdint.h>
+#include "input.h"
+
+/* Input traces: the events a session consumed, with the vsync each was
+ * posted on, so the session can be replayed exactly.  Recording appends
+ * every event ss_input_poll() returns; replay is an SSInputSource that
+ * posts each event on the vsync it was recorded at, counted from the
+ * start of the replay; recording and replay both start right before the
+ * scene runs.
+ *
+ * The format is byte oriented and big-endian, so a trace recorded on
+ * the X68000 replays unchanged on a host:
+ *
+ *   header  "SSIT" version(1) 0
+ *   event   delta type|buttons<<4 payload
+ *             delta    vsyncs since the previous event (0..254)
+ *             payload  key: key(2); motion, button: x(2) y(2)
+ *   gap     0xFF: 255 vsyncs without an event
+ *
+ * A pointer event is 6 bytes, a key 4. */
+
+#define SS_TRACE_VERSION     1
+#define SS_TRACE_HEADER      6
+#define SS_TRACE_EVENT_MAX   6
+#define SS_TRACE_GAP         0xFF
+
+typedef struct {
+    uint8_t* buf;
+    uint32_t size;              /* capacity when recording */
+    uint32_t len;               /* bytes recorded / to replay */
+    uint32_t pos;               /* replay: next record */
+    uint32_t base;              /* ss_vsync_counter at the start */
+    uint32_t at;                /* vsyncs from base to the last event */
+    uint32_t events;            /* recorded / replayed */
+    uint8_t  overflow;          /* recording ran out of buffer */
+} SSInputTrace;
+
+/* The trace ss_input_poll() records into, NULL when not recording. */
+extern SSInputTrace* ss_trace_recording;
+
+/* Start a trace in buf and record every polled event into it.
+ * SS_ERR_PARAM when buf cannot hold the header. */
+int16_t  ss_trace_record(SSInputTrace* t, uint8_t* buf, uint32_t size);
+/* Stop recording; t->len is the trace's length. */
+void     ss_trace_stop(void);
+/* Append one event stamped with ev->time.  SS_ERR_LIMIT once the buffer
+ * is full: the trace ends there and overflow is set. */
+int16_t  ss_trace_append(SSInputTrace* t, const SSInputEvent* ev);
+
+/* Check len bytes of buf and prepare them for replay.  SS_ERR_PARAM for
+ * a missing header or an unknown version.  Time starts now, as it does
+ * for ss_trace_record(). */
+int16_t  ss_trace_open(SSInputTrace* t, uint8_t* buf, uint32_t len);
+/* Replay source: each pump posts the events that are due. */
+SSInputSource ss_trace_source(SSInputTrace* t);
+/* Every event has been posted. */
+int      ss_trace_done(const SSInputTrace* t);
+
+#endif /* SS_INPUT_TRACE_H */
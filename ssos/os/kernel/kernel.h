@@ -24,6 +24,7 @@
 #define SS_VEC_TIMERC  0x114
 #define SS_VEC_TIMERD  0x110
 #define SS_VEC_KEY     0x130
+#define SS_VEC_MOUSE   0x150
 #define SS_VEC_VDISP   0x134
 #define SS_VEC_CRTC    0x138
 #define SS_VEC_HSYNC   0x13C
@@ -60,6 +61,11 @@ void ss_set_interrupts(void);
 void ss_restore_interrupts(void);
 void ss_disable_interrupts(void);
 void ss_enable_interrupts(void);
+/* Save-and-mask / restore pair: ss_irq_restore() puts back the SR
+ * ss_irq_save() found, so a critical section can run inside an ISR or
+ * with interrupts already off.  The pair above forces IPL 7 / IPL 0. */
+uint16_t ss_irq_save(void);
+void ss_irq_restore(uint16_t sr);
 
 /* Linker symbols */
 extern uint8_t __text_start, __text_end, __text_size;
@@ -247,6 +247,60 @@ uint16_t ss_task_sleep(uint32_t ticks) {
     return SS_OK;
 }
 
+void ss_task_signal(SSTask* tcb, uint16_t bits) {
+    if (tcb == NULL) return;
+    uint16_t sr = ss_irq_save();
+    tcb->signals |= bits;
+    /* Due now: the next wakeup pass readies it. */
+    if (tcb->sig_wait) tcb->wait_until = ss_tick_counter;
+    ss_irq_restore(sr);
+}
+
+uint16_t ss_task_wait(uint32_t ticks) {
+    SSTask* curr = ss_curr_task;
+    if (curr == NULL || ticks > SS_MAX_SLEEP_TICKS)
+        return 0;
+
+    ss_disable_interrupts();
+    if (curr->signals == 0 && ticks > 0) {
+        curr->state = SS_TS_WAIT;
+        curr->wait_until = ss_tick_counter + ticks;
+        ss_sched_dequeue(curr);
+        if (ready_queue.pri_bitmap == 0) {
+            curr->state = SS_TS_READY;
+            curr->wait_until = 0;
+            ss_sched_enqueue(curr);
+        } else {
+            curr->sig_wait = 1;
+            curr->sleep_next = sleeping_tasks;
+            sleeping_tasks = curr;
+            ss_task_yield();
+            ss_disable_interrupts();
+        }
+    }
+    uint16_t bits = curr->signals;
+    curr->signals = 0;
+    ss_enable_interrupts();
+    return bits;
+}
+
+void ss_task_idle(void) {
+    SSTask* curr = ss_curr_task;
+    if (curr != NULL) {
+        ss_disable_interrupts();
+        ss_sched_dequeue(curr);
+        curr->pri = SS_MAX_PRI - 1;
+        ss_sched_enqueue(curr);
+        ss_enable_interrupts();
+    }
+    for (;;) {
+        uint16_t sr = ss_irq_save();
+        ss_process_wakeups();
+        ss_irq_restore(sr);
+        ss_task_yield();
+    }
+}
+
 static int deadline_reached(uint32_t now, uint32_t deadline) {
     return now - deadline <= SS_MAX_SLEEP_TICKS;
 }
@@ -261,6 +315,7 @@ void ss_do_wakeups(void) {
             tcb->sleep_next = NULL;
             tcb->state = SS_TS_READY;
             tcb->wait_until = 0;
+            tcb->sig_wait = 0;
             ss_sched_enqueue(tcb);
         } else {
             link = &tcb->sleep_next;
@@ -19,6 +19,9 @@ struct SSTask {
     uint8_t  ctx_level;    /* SS_CTX_MINIMAL/NORMAL/FULL */
     uint8_t  resume_type;  /* 0 = interrupted, 1 = yielded */
     SSTask*  sleep_next;
+    volatile uint16_t signals;  /* ss_task_signal() bits not yet taken */
+    uint8_t  sig_wait;     /* blocked in ss_task_wait() */
+    uint8_t  pad;
 };
 
 #if UINTPTR_MAX == UINT32_MAX
@@ -29,6 +32,11 @@ _Static_assert(offsetof(SSTask, resume_type) == 31, "SSTask.resume_type ABI chan
 _Static_assert(offsetof(SSTask, sleep_next) == 32, "SSTask.sleep_next ABI changed");
 #endif
 
+/* ss_task_signal() bits. */
+#define SS_SIG_MSG     0x0001   /* ss_send() queued a message */
+#define SS_SIG_INPUT   0x0002   /* ss_input_post() queued an event */
+#define SS_SIG_DAMAGE  0x0004   /* ss_win_add_damage() queued a rect */
+
 typedef struct {
     void* (*entry)(void*);
     uint8_t pri;
@@ -67,6 +75,19 @@ uint16_t ss_task_sleep(uint32_t ticks);
 void     ss_task_yield(void);
 void     ss_process_wakeups(void);
 
+/* Wait for any of several things.  ss_task_signal() ORs bits into a
+ * task's signals and, when the task is blocked in ss_task_wait(), makes
+ * it due at the next wakeup pass; it is safe from ISRs and ignores NULL.
+ * ss_task_wait() blocks the calling task until it is signalled or ticks
+ * pass, then takes and returns its bits (0 on timeout).  Like
+ * ss_task_sleep() it does not block when no other task could run. */
+void     ss_task_signal(SSTask* tcb, uint16_t bits);
+uint16_t ss_task_wait(uint32_t ticks);
+/* Turn the calling task into the idle task: lowest priority, running the
+ * wakeup pass and yielding, so every other task can block.  Never
+ * returns. */
+void     ss_task_idle(void);
+
 /* Stack debugging */
 uint32_t ss_stack_check(uint16_t id);
 void     ss_stack_canary_init(uint16_t id);
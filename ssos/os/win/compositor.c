@@ -0,0 +1,125 @@
+#include "compositor.h"
+#include "win.h"
+#include "../ipc/ipc.h"
+#include "../kernel/kernel.h"
+#include "../kernel/scheduler.h"
+#include <string.h>
+
+uint16_t ss_comp_task;
+
+/* Payload layouts.  Both fit one SSMessage, so an update is one copy into
+ * the queue. */
+typedef struct {
+    uint16_t win;
+    int16_t  x, y, w, h;
+} CompDamage;
+
+typedef struct {
+    uint16_t win;
+    uint8_t  row, col;
+    char     text[SS_COMP_TEXT_MAX];  /* payload_size - 4 characters */
+} CompText;
+
+_Static_assert(sizeof(CompDamage) <= SS_MSG_PAYLOAD, "CompDamage too large");
+_Static_assert(sizeof(CompText) <= SS_MSG_PAYLOAD, "CompText too large");
+
+uint16_t ss_comp_start(void* (*entry)(void*), uint8_t pri) {
+    SSTaskInfo info = { entry, pri, SS_CTX_FULL, 0, NULL };
+    uint16_t id = ss_task_create(&info);
+    if (id == 0 || id > SS_MAX_TASKS) return id;
+    uint16_t err = ss_task_start(id);
+    if (err != SS_OK) return err;
+    ss_comp_task = id;
+    return SS_OK;
+}
+
+/* Callers check room and send with interrupts masked (ss_irq_save), so
+ * no other task's post can take the slots a multi-message post counted
+ * on. */
+static int16_t comp_room(int n) {
+    if (ss_comp_task == 0) return SS_ERR_STATE;
+    return SS_MSG_MAX - ss_msg_pending(ss_comp_task) >= n ? SS_OK : SS_ERR_LIMIT;
+}
+
+int16_t ss_comp_damage(uint16_t win, int x, int y, int w, int h) {
+    CompDamage d = { win, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h };
+    SSMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = SS_MSG_COMP_DAMAGE;
+    msg.payload_size = sizeof(d);
+    memcpy(msg.payload, &d, sizeof(d));
+    uint16_t sr = ss_irq_save();
+    int16_t err = comp_room(1);
+    if (err == SS_OK && w > 0 && h > 0) err = ss_send(ss_comp_task, &msg);
+    ss_irq_restore(sr);
+    return err;
+}
+
+int16_t ss_comp_put(uint16_t win, int row, int col, const char* text) {
+    if (row < 0 || row >= SS_TGRID_ROWS || col < 0 || col >= SS_TGRID_COLS || text == NULL)
+        return SS_ERR_PARAM;
+    int len = 0;
+    while (col + len < SS_TGRID_COLS && text[len] != '\0') len++;
+    SSMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = SS_MSG_COMP_TEXT;
+    uint16_t sr = ss_irq_save();
+    int16_t err = comp_room((len + SS_COMP_TEXT_MAX - 1) / SS_COMP_TEXT_MAX);
+    for (int done = 0; done < len && err == SS_OK; ) {
+        CompText t;
+        int n = len - done;
+        if (n > SS_COMP_TEXT_MAX) n = SS_COMP_TEXT_MAX;
+        t.win = win;
+        t.row = (uint8_t)row;
+        t.col = (uint8_t)(col + done);
+        memcpy(t.text, text + done, (size_t)n);
+        msg.payload_size = (uint16_t)(sizeof(t) - SS_COMP_TEXT_MAX + n);
+        memcpy(msg.payload, &t, msg.payload_size);
+        err = ss_send(ss_comp_task, &msg);
+        done += n;
+    }
+    ss_irq_restore(sr);
+    return err;
+}
+
+int16_t ss_comp_set_line(uint16_t win, int row, const char* text) {
+    char line[SS_TGRID_COLS + 1];
+    int c = 0;
+    if (text == NULL) return SS_ERR_PARAM;
+    for (; c < SS_TGRID_COLS && text[c] != '\0'; c++) line[c] = text[c];
+    memset(line + c, ' ', (size_t)(SS_TGRID_COLS - c));
+    line[SS_TGRID_COLS] = '\0';
+    return ss_comp_put(win, row, 0, line);
+}
+
+uint16_t ss_comp_pending(void) {
+    return ss_msg_pending(ss_comp_task);
+}
+
+static void apply(const SSMessage* msg, SSCompGridFn grid) {
+    if (msg->type == SS_MSG_COMP_DAMAGE) {
+        CompDamage d;
+        memcpy(&d, msg->payload, sizeof(d));
+        ss_win_damage(d.win, d.x, d.y, d.w, d.h);
+    } else if (msg->type == SS_MSG_COMP_TEXT && msg->payload_size <= sizeof(CompText)) {
+        CompText t;
+        memcpy(&t, msg->payload, msg->payload_size);
+        SSTextGrid* g = grid != NULL ? grid(t.win) : NULL;
+        if (g != NULL)
+            ss_tgrid_put(g, t.row, t.col, t.text,
+                         msg->payload_size - (int)(sizeof(t) - SS_COMP_TEXT_MAX));
+    }
+}
+
+/* At most one queue's worth per frame: messages posted while draining
+ * wait for the next vsync instead of stretching this one. */
+int ss_comp_drain(SSCompGridFn grid) {
+    SSMessage msg;
+    int n = 0;
+    if (ss_comp_task == 0 || ss_curr_task != &tcb_table[ss_comp_task - 1]) return 0;
+    while (n < SS_MSG_MAX && ss_recv_nb(&msg) == SS_OK) {
+        apply(&msg, grid);
+        n++;
+    }
+    return n;
+}
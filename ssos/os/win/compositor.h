@@ -0,0 +1,52 @@
+#ifndef SS_COMPOSITOR_H
+#define SS_COMPOSITOR_H
+
+#include <stdint.h>
+#include "textgrid.h"
+
+/* Compositor protocol.  One task, the compositor, owns GVRAM and the
+ * window content; application tasks never draw.  They post damage and
+ * content-line updates to the compositor's IPC queue, which only copies
+ * the message and returns (SS_ERR_LIMIT when the queue is full), so an
+ * app is never held up by a repaint.  The compositor drains the queue
+ * once per vsync and applies everything before its single damage flush:
+ * any number of updates between two vsyncs costs one repaint of the
+ * cells that changed, and an app that stalls just leaves its windows as
+ * they were. */
+
+#define SS_MSG_COMP_DAMAGE 0x0C01
+#define SS_MSG_COMP_TEXT   0x0C02
+
+#define SS_COMP_TEXT_MAX   12       /* characters per text message */
+
+/* Task id of the compositor; 0 while there is none and nothing can be
+ * posted. */
+extern uint16_t ss_comp_task;
+
+/* Create and start the compositor task.  entry runs the render loop and
+ * calls ss_comp_drain() once per frame.  Returns SS_OK or the scheduler's
+ * error. */
+uint16_t ss_comp_start(void* (*entry)(void*), uint8_t pri);
+
+/* Application side.  Coordinates are window relative; row and col are
+ * text grid cells.  A post that needs more messages than the queue has
+ * room for is refused whole with SS_ERR_LIMIT; the room check and the
+ * sends run with interrupts masked, so a preempting post cannot split
+ * one. */
+int16_t  ss_comp_damage(uint16_t win, int x, int y, int w, int h);
+/* Overwrite cells of row from col, cut at the grid's width. */
+int16_t  ss_comp_put(uint16_t win, int row, int col, const char* text);
+/* Replace the whole row; the rest of it is blanked. */
+int16_t  ss_comp_set_line(uint16_t win, int row, const char* text);
+
+/* Compositor side.  grid maps a window id to its text grid, NULL for
+ * windows without one (text for them is dropped).  Drain applies the
+ * queued updates in order: text to the grids, marking the changed cells,
+ * and damage to the window table.  Returns the messages applied, 0 when
+ * not called from the compositor task. */
+typedef SSTextGrid* (*SSCompGridFn)(uint16_t win);
+
+uint16_t ss_comp_pending(void);
+int      ss_comp_drain(SSCompGridFn grid);
+
+#endif /* SS_COMPOSITOR_H */
@@ -0,0 +1,234 @@
+#include "console.h"
+#include <string.h>
+
+/* Render callbacks only get the window, so open consoles are found by
+ * window id. */
+static SSConsole* consoles[SS_CONSOLE_MAX];
+
+static SSConsole* console_of(uint16_t win) {
+    for (int i = 0; i < SS_CONSOLE_MAX; i++) {
+        if (consoles[i] != NULL && consoles[i]->win == win) return consoles[i];
+    }
+    return NULL;
+}
+
+static char* line_slot(const SSConsole* con, uint32_t line) {
+    return con->buf + (uint32_t)(line % con->cap) * con->cols;
+}
+
+static uint32_t oldest_line(const SSConsole* con) {
+    return con->total > con->cap ? con->total - con->cap : 0;
+}
+
+/* View top that puts the newest line on the bottom row. */
+static uint32_t bottom_top(const SSConsole* con) {
+    return con->total > con->rows ? con->total - con->rows : 0;
+}
+
+static void mark_cells(SSConsole* con, uint32_t line, int c0, int c1) {
+    if (line < con->shown_top || line - con->shown_top >= con->rows) return;
+    uint32_t r = line - con->shown_top;
+    if (con->dirty_lo[r] > con->dirty_hi[r]) {
+        con->dirty_lo[r] = (uint8_t)c0;
+        con->dirty_hi[r] = (uint8_t)c1;
+        return;
+    }
+    if (c0 < con->dirty_lo[r]) con->dirty_lo[r] = (uint8_t)c0;
+    if (c1 > con->dirty_hi[r]) con->dirty_hi[r] = (uint8_t)c1;
+}
+
+static void mark_rows(SSConsole* con, int r0, int r1, int dirty) {
+    for (int r = r0; r < r1; r++) {
+        con->dirty_lo[r] = dirty ? 0 : 0xFF;
+        con->dirty_hi[r] = dirty ? (uint8_t)(con->cols - 1) : 0;
+    }
+}
+
+/* The grid, row by row from shown_top; lines not written yet or already
+ * dropped from the ring are blank.  The strips right of and below the
+ * grid are filled with bg. */
+static void console_render(SSWindow* self, const SSGfxRect* clip) {
+    SSConsole* con = console_of(self->id);
+    char text[SS_CONSOLE_MAX_COLS + 1];
+    SSGfxRect area = { self->x, self->y, self->w, self->h };
+    if (con == NULL) return;
+    if (clip == NULL) clip = &area;
+
+    int gw = con->cols * SS_FONT_ADV, gh = con->rows * SS_FONT_H;
+    int r0 = (clip->y - self->y) / SS_FONT_H;
+    int r1 = (clip->y + clip->h - self->y + SS_FONT_H - 1) / SS_FONT_H;
+    if (r0 < 0) r0 = 0;
+    if (r1 > con->rows) r1 = con->rows;
+    text[con->cols] = '\0';
+    for (int r = r0; r < r1; r++) {
+        uint32_t line = con->shown_top + (uint32_t)r;
+        if (line < con->total && line >= oldest_line(con)) {
+            memcpy(text, line_slot(con, line), con->cols);
+        } else {
+            memset(text, ' ', con->cols);
+        }
+        ss_gfx_draw_text_region(self->x, self->y + r * SS_FONT_H, text,
+                                con->fg, con->bg, clip);
+    }
+    if (self->w > gw) {
+        ss_gfx_rect_region((SSGfxRect){ self->x + gw, self->y, self->w - gw, self->h },
+                           clip, con->bg);
+    }
+    if (self->h > gh) {
+        ss_gfx_rect_region((SSGfxRect){ self->x, self->y + gh, gw, self->h - gh },
+                           clip, con->bg);
+    }
+}
+
+int ss_console_open(SSConsole* con, uint16_t win, char* buf, uint32_t size,
+                    uint16_t fg, uint16_t bg) {
+    SSWindow* w = ss_win_get_ptr(win);
+    int slot = -1;
+    if (w == NULL || console_of(win) != NULL) return -1;
+    for (int i = 0; i < SS_CONSOLE_MAX && slot < 0; i++) {
+        if (consoles[i] == NULL) slot = i;
+    }
+    if (slot < 0) return -1;
+
+    int cols = w->w / SS_FONT_ADV, rows = w->h / SS_FONT_H;
+    if (cols > SS_CONSOLE_MAX_COLS) cols = SS_CONSOLE_MAX_COLS;
+    if (rows > SS_CONSOLE_MAX_ROWS) rows = SS_CONSOLE_MAX_ROWS;
+    if (cols == 0 || rows == 0) return -1;
+    uint32_t cap = size / (uint32_t)cols;
+    if (cap > 0xFFFF) cap = 0xFFFF;
+    if (cap < (uint32_t)rows) return -1;
+
+    memset(con, 0, sizeof(*con));
+    con->win = win;
+    con->cols = (uint16_t)cols;
+    con->rows = (uint16_t)rows;
+    con->cap = (uint16_t)cap;
+    con->fg = fg;
+    con->bg = bg;
+    con->buf = buf;
+    con->total = 1;
+    con->follow = 1;
+    memset(buf, ' ', (size_t)cols);
+    mark_rows(con, 0, rows, 0);
+    consoles[slot] = con;
+    ss_win_set_render(win, console_render);
+    ss_win_damage(win, 0, 0, w->w, w->h);
+    return 0;
+}
+
+void ss_console_close(SSConsole* con) {
+    for (int i = 0; i < SS_CONSOLE_MAX; i++) {
+        if (consoles[i] == con) consoles[i] = NULL;
+    }
+    ss_win_set_render(con->win, NULL);
+}
+
+/* Start a new line.  The slot it takes held the line cap back, which
+ * must be blanked if it is still on screen. */
+static void new_line(SSConsole* con) {
+    uint32_t line = con->total;
+    if (line >= con->cap) mark_cells(con, line - con->cap, 0, con->cols - 1);
+    memset(line_slot(con, line), ' ', con->cols);
+    con->total++;
+    con->col = 0;
+}
+
+void ss_console_write(SSConsole* con, const char* str) {
+    for (; *str != '\0'; str++) {
+        char c = *str;
+        if (c == '\n') {
+            new_line(con);
+            continue;
+        }
+        if (c == '\r') {
+            con->col = 0;
+            continue;
+        }
+        if (con->col == con->cols) new_line(con);
+        uint32_t line = con->total - 1;
+        line_slot(con, line)[con->col] = c;
+        mark_cells(con, line, con->col, con->col);
+        con->col++;
+    }
+}
+
+void ss_console_put(SSConsole* con, uint32_t line, int col, const char* str) {
+    if (line >= con->total || line < oldest_line(con) || col < 0) return;
+    char* dst = line_slot(con, line);
+    int c = col;
+    for (; c < con->cols && str[c - col] != '\0'; c++) dst[c] = str[c - col];
+    if (c > col) mark_cells(con, line, col, c - 1);
+}
+
+void ss_console_scroll(SSConsole* con, int delta) {
+    uint32_t top = con->follow ? bottom_top(con) : con->view_top;
+    uint32_t oldest = oldest_line(con);
+    if (top < oldest) top = oldest;
+    if (delta < 0) {
+        uint32_t back = (uint32_t)-delta;
+        top = top - oldest > back ? top - back : oldest;
+    } else {
+        top += (uint32_t)delta;
+        if (top > bottom_top(con)) top = bottom_top(con);
+    }
+    con->view_top = top;
+    con->follow = con->view_top == bottom_top(con);
+}
+
+uint32_t ss_console_last_line(const SSConsole* con) {
+    return con->total - 1;
+}
+
+/* Move the screen to top.  Rows that stay visible are blitted when the
+ * window is unobscured (their pending cell damage moves with them) and
+ * only the rows scrolled in are marked; otherwise every row is. */
+static void scroll_to(SSConsole* con, uint32_t top) {
+    SSWindow* w = ss_win_get_ptr(con->win);
+    int32_t delta = (int32_t)(top - con->shown_top);
+    int n = delta < 0 ? -delta : delta;
+    int rows = con->rows;
+
+    if (n < rows && ss_win_unobscured(con->win)) {
+        int gw = con->cols * SS_FONT_ADV, keep = (rows - n) * SS_FONT_H;
+        int dy = n * SS_FONT_H;
+        /* Pending damage first, so the blit moves current pixels. */
+        ss_win_flush_damage();
+        if (delta > 0) {
+            ss_gfx_blit(w->x, w->y + dy, w->x, w->y, gw, keep);
+            memmove(con->dirty_lo, con->dirty_lo + n, (size_t)(rows - n));
+            memmove(con->dirty_hi, con->dirty_hi + n, (size_t)(rows - n));
+            mark_rows(con, rows - n, rows, 1);
+        } else {
+            ss_gfx_blit(w->x, w->y, w->x, w->y + dy, gw, keep);
+            memmove(con->dirty_lo + n, con->dirty_lo, (size_t)(rows - n));
+            memmove(con->dirty_hi + n, con->dirty_hi, (size_t)(rows - n));
+            mark_rows(con, 0, n, 1);
+        }
+        ss_win_note_drawn(w->x, w->y, gw, rows * SS_FONT_H);
+    } else {
+        mark_rows(con, 0, rows, 1);
+    }
+    con->shown_top = top;
+}
+
+void ss_console_flush(SSConsole* con) {
+    uint32_t top = con->follow ? bottom_top(con) : con->view_top;
+    if (top < oldest_line(con)) top = oldest_line(con);
+    con->view_top = top;
+    if (top != con->shown_top) scroll_to(con, top);
+
+    /* One damage rect per run of rows with the same changed columns. */
+    int r = 0;
+    while (r < con->rows) {
+        int lo = con->dirty_lo[r], hi = con->dirty_hi[r], r1 = r + 1;
+        if (lo > hi) {
+            r++;
+            continue;
+        }
+        while (r1 < con->rows && con->dirty_lo[r1] == lo && con->dirty_hi[r1] == hi) r1++;
+        ss_win_damage(con->win, lo * SS_FONT_ADV, r * SS_FONT_H,
+                      (hi - lo + 1) * SS_FONT_ADV, (r1 - r) * SS_FONT_H);
+        mark_rows(con, r, r1, 0);
+        r = r1;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef SS_CONSOLE_H
+#define SS_CONSOLE_H
+
+#include <stdint.h>
+#include "win.h"
+
+/* Text console: a window whose content is a ring of fixed-width lines,
+ * drawn as a grid of SS_FONT_ADV x SS_FONT_H cells from the window's
+ * top-left corner.  Writes only touch the ring and record which cells
+ * changed; ss_console_flush() turns that into damage once per frame.
+ * When the view moves by less than a screen and the window is
+ * unobscured, the rows still shown are blitted into place and only the
+ * rows that scrolled in are rendered, so a log that prints many lines a
+ * frame costs one blit plus the new lines instead of a full repaint.
+ *
+ * The line buffer belongs to the caller; its size sets the scrollback. */
+
+#define SS_CONSOLE_MAX       4                       /* open at once */
+#define SS_CONSOLE_MAX_COLS  (768 / SS_FONT_ADV)     /* 128 */
+#define SS_CONSOLE_MAX_ROWS  (512 / SS_FONT_H)       /* 64 */
+
+typedef struct {
+    uint16_t win;
+    uint16_t cols, rows;        /* visible grid */
+    uint16_t cap;               /* lines the ring holds */
+    uint16_t col;               /* write column in the newest line */
+    uint16_t fg, bg;
+    char*    buf;               /* cap lines of cols chars */
+    uint32_t total;             /* lines written; the newest is total - 1 */
+    uint32_t view_top;          /* first line to show */
+    uint32_t shown_top;         /* first line on screen */
+    uint8_t  follow;            /* view tracks the newest line */
+    /* Changed cells per screen row, [lo, hi]; lo > hi when clean. */
+    uint8_t  dirty_lo[SS_CONSOLE_MAX_ROWS];
+    uint8_t  dirty_hi[SS_CONSOLE_MAX_ROWS];
+} SSConsole;
+
+/* Attach con to window win, using size bytes of buf as the ring.  The
+ * grid fills the window; the ring must hold at least one screen.
+ * Returns 0, or -1 when the window, buffer or console table does not
+ * fit. */
+int      ss_console_open(SSConsole* con, uint16_t win, char* buf, uint32_t size,
+                         uint16_t fg, uint16_t bg);
+void     ss_console_close(SSConsole* con);
+
+/* Append text: '\n' starts a line, '\r' returns to column 0, a full line
+ * wraps. */
+void     ss_console_write(SSConsole* con, const char* str);
+/* Overwrite cells of a retained line in place from column col. */
+void     ss_console_put(SSConsole* con, uint32_t line, int col, const char* str);
+/* Move the view by delta lines (negative is back into the scrollback).
+ * Reaching the newest line resumes following output. */
+void     ss_console_scroll(SSConsole* con, int delta);
+/* Newest line number; lines before total - cap are gone. */
+uint32_t ss_console_last_line(const SSConsole* con);
+
+/* Bring the screen up to date: scroll, then queue damage for changed
+ * cells.  Call once per frame before ss_win_flush_damage(). */
+void     ss_console_flush(SSConsole* con);
+
+#endif /* SS_CONSOLE_H */
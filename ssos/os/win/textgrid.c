@@ -0,0 +1,65 @@
+#include "textgrid.h"
+#include <string.h>
+
+void ss_tgrid_init(SSTextGrid* g) {
+    for (int r = 0; r < SS_TGRID_ROWS; r++) {
+        memset(g->cell[r], ' ', SS_TGRID_COLS);
+        g->cell[r][SS_TGRID_COLS] = '\0';
+        g->dirty[r] = 0;
+    }
+}
+
+void ss_tgrid_set_line(SSTextGrid* g, int row, const char* text) {
+    if (row < 0 || row >= SS_TGRID_ROWS) return;
+    char* dst = g->cell[row];
+    uint32_t dirty = 0;
+    int c = 0;
+    for (; c < SS_TGRID_COLS && text[c] != '\0'; c++) {
+        if (dst[c] != text[c]) {
+            dst[c] = text[c];
+            dirty |= 1UL << c;
+        }
+    }
+    for (; c < SS_TGRID_COLS; c++) {
+        if (dst[c] != ' ') {
+            dst[c] = ' ';
+            dirty |= 1UL << c;
+        }
+    }
+    dst[SS_TGRID_COLS] = '\0';
+    g->dirty[row] |= dirty;
+}
+
+void ss_tgrid_put(SSTextGrid* g, int row, int col, const char* text, int len) {
+    if (row < 0 || row >= SS_TGRID_ROWS || col < 0) return;
+    char* dst = g->cell[row];
+    uint32_t dirty = 0;
+    for (int i = 0; i < len && col + i < SS_TGRID_COLS; i++) {
+        if (dst[col + i] != text[i]) {
+            dst[col + i] = text[i];
+            dirty |= 1UL << (col + i);
+        }
+    }
+    g->dirty[row] |= dirty;
+}
+
+void ss_tgrid_mark_all(SSTextGrid* g) {
+    uint32_t all = 0xFFFFFFFFUL >> (32 - SS_TGRID_COLS);
+    for (int r = 0; r < SS_TGRID_ROWS; r++) g->dirty[r] = all;
+}
+
+uint32_t ss_tgrid_take(SSTextGrid* g, int row) {
+    if (row < 0 || row >= SS_TGRID_ROWS) return 0;
+    uint32_t mask = g->dirty[row];
+    g->dirty[row] = 0;
+    return mask;
+}
+
+int ss_tgrid_run(uint32_t mask, int from, int* first) {
+    int c = from;
+    while (c < SS_TGRID_COLS && !(mask & (1UL << c))) c++;
+    if (c >= SS_TGRID_COLS) return 0;
+    *first = c;
+    while (c < SS_TGRID_COLS && (mask & (1UL << c))) c++;
+    return c - *first;
+}
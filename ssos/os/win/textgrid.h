@@ -0,0 +1,36 @@
+#ifndef SS_TEXTGRID_H
+#define SS_TEXTGRID_H
+
+#include <stdint.h>
+
+/* Character grid of a text window with one dirty bit per cell.  Writers
+ * replace whole rows; only the cells whose character actually changed are
+ * marked, so "Tick: 12345" -> "Tick: 12346" marks one cell wherever in
+ * the line the change is.  Renderers take a row's dirty mask and draw it
+ * as runs of adjacent dirty cells. */
+
+#define SS_TGRID_ROWS 3
+#define SS_TGRID_COLS 28        /* at most 32: one mask word per row */
+
+typedef struct {
+    /* Rows are space padded and NUL terminated, so a row can be drawn
+     * or referenced as one string. */
+    char     cell[SS_TGRID_ROWS][SS_TGRID_COLS + 1];
+    uint32_t dirty[SS_TGRID_ROWS];      /* bit c = column c changed */
+} SSTextGrid;
+
+/* Blank rows, nothing dirty: the caller paints the initial state. */
+void     ss_tgrid_init(SSTextGrid* g);
+/* Copy text into row, space padded and cut at SS_TGRID_COLS. */
+void     ss_tgrid_set_line(SSTextGrid* g, int row, const char* text);
+/* Overwrite len cells of row from column col, cut at the row's end. */
+void     ss_tgrid_put(SSTextGrid* g, int row, int col, const char* text, int len);
+void     ss_tgrid_mark_all(SSTextGrid* g);
+/* Return row's dirty mask and clear it. */
+uint32_t ss_tgrid_take(SSTextGrid* g, int row);
+
+/* The first run of set bits in mask at or after column from: stores its
+ * first column and returns its length, 0 when there is none. */
+int      ss_tgrid_run(uint32_t mask, int from, int* first);
+
+#endif /* SS_TEXTGRID_H */
@@ -3,15 +3,45 @@
 
 #include <stdint.h>
 #include "../gfx/gfx.h"
+#include "textgrid.h"
 
+/* Windows come from a slab cache over a window table the host supplies
+ * with ss_win_set_storage(): the OS takes SS_WIN_HEAP_WINDOWS from its
+ * heap, the standalone .x SS_MAX_WINDOWS.  Native tests also have a
+ * built-in SS_MAX_WINDOWS table.  Render paths walk the live windows
+ * only, so unused capacity costs memory, not time. */
 #define SS_MAX_WINDOWS  32
+#define SS_WIN_HEAP_WINDOWS 512
+/* Titles and content lines live in a parallel pool, one block per table
+ * slot, taken on first use: icon- and tooltip-like windows drawn by a
+ * render callback never touch theirs. */
 #define SS_WIN_VISIBLE  0x01
 #define SS_WIN_DIRTY    0x02
+/* ss_win_raise / ss_win_lower keep z within 1..SS_WIN_Z_MAX. */
+#define SS_WIN_Z_MAX    0xFFFE
+
+/* Frame damage: screen rects queued by geometry and content changes and
+ * repainted together by ss_win_flush_damage(), once per frame. */
+#define SS_DAMAGE_MAX   8
 
 #define SS_BLOCK_SIZE   8
 #define SS_ZMAP_W       (768 / SS_BLOCK_SIZE)   /* 96 */
 #define SS_ZMAP_H       (512 / SS_BLOCK_SIZE)   /* 64 */
 
+typedef struct {
+    char title[20];
+    SSTextGrid content;         /* content lines, with changed-cell bits */
+} SSWinText;
+
+/* A window's exact visible region: count boxes from `first` in the
+ * window layer's box pool. */
+typedef struct {
+    uint16_t first;
+    uint16_t count;
+    uint8_t  exact;
+} SSWinVis;
+
+struct SSTask;
 typedef struct SSWindow SSWindow;
 struct SSWindow {
     uint16_t x, y, w, h;
@@ -20,11 +50,22 @@ struct SSWindow {
     uint16_t dirty_x, dirty_y, dirty_w, dirty_h;
     void (*render)(SSWindow* self, const SSGfxRect* clip);
     uint16_t id;
-    char title[20];
-    char content[3][30];
-    char content_prev[3][30];
+    SSWinText* text;            /* NULL until a title or line is set */
+    /* Window layer bookkeeping: z-order links (slot indices), visible
+     * region, and the block rows the window touches. */
+    uint16_t zprev, znext;
+    SSWinVis vis;
+    uint8_t  zrow0, zrow1;
 };
 
+/* Bytes of storage for n windows: the table and its text blocks. */
+#define SS_WIN_STORAGE_SIZE(n) \
+    ((uint32_t)(n) * (uint32_t)(sizeof(SSWindow) + sizeof(SSWinText)))
+
+/* Use mem (size bytes) as the window table and text pool from the next
+ * ss_win_init().  Without storage (NULL) the target has no windows and
+ * ss_win_create() returns 0; native tests fall back to a built-in table. */
+void     ss_win_set_storage(void* mem, uint32_t size);
 void     ss_win_init(void);
 uint16_t ss_win_create(int x, int y, int w, int h, uint16_t z);
 void     ss_win_destroy(uint16_t id);
@@ -35,17 +76,44 @@ void     ss_win_render_all(void);
 void     ss_win_render_region(int rx, int ry, int rw, int rh);
 void     ss_win_move(uint16_t id, int x, int y);
 int      ss_win_hit_test(int mx, int my);
+/* 1 when the window is entirely on-screen and no window covers it, so
+ * its pixels can be moved with a blit. */
+int      ss_win_unobscured(uint16_t id);
+/* Every id-taking call ignores ids of destroyed windows: the getters
+ * return 0 (ss_win_get_ptr NULL), the setters do nothing. */
 int      ss_win_get_x(uint16_t id);
 int      ss_win_get_y(uint16_t id);
 int      ss_win_get_w(uint16_t id);
 int      ss_win_get_h(uint16_t id);
 int      ss_win_get_z(uint16_t id);
 SSWindow* ss_win_get_ptr(uint16_t id);
-void     ss_win_set_title(uint16_t id, const char* title);
-void     ss_win_set_content_line(uint16_t id, int line, const char* text);
+/* SS_OK, or SS_ERR_PARAM for a free slot, bad line or NULL text. */
+int16_t  ss_win_set_title(uint16_t id, const char* title);
+int16_t  ss_win_set_content_line(uint16_t id, int line, const char* text);
 void     ss_win_set_render(uint16_t id, void (*render)(SSWindow*, const SSGfxRect*));
 void     ss_win_set_z(uint16_t id, uint16_t z);
+void     ss_win_raise(uint16_t id);
+void     ss_win_lower(uint16_t id);
+/* Visible windows in z order: ss_win_bottom() then ss_win_above() up to
+ * the top, or ss_win_top() then ss_win_below(); 0 ends the walk. */
+uint16_t ss_win_bottom(void);
+uint16_t ss_win_top(void);
+uint16_t ss_win_above(uint16_t id);
+uint16_t ss_win_below(uint16_t id);
 void     ss_win_mark_dirty(uint16_t id);
+void     ss_win_add_damage(int x, int y, int w, int h);
+/* Signal task (SS_SIG_DAMAGE) whenever damage is queued; NULL for none. */
+void     ss_win_notify(struct SSTask* task);
+int      ss_win_flush_damage(void);
+/* Copy up to max queued rects to out; returns how many are queued. */
+int      ss_win_pending_damage(SSGfxRect* out, int max);
+/* Double-buffered presentation (2-page modes only; returns the new state).
+ * While on, drawing goes to the hidden page and ss_win_present() flushes
+ * and flips once per frame.  Pixels drawn outside the compositor must be
+ * reported with ss_win_note_drawn() so the other page receives them. */
+int      ss_win_set_double_buffer(int on);
+int      ss_win_present(void);
+void     ss_win_note_drawn(int x, int y, int w, int h);
 
 extern uint16_t ss_win_active_z;   /* highest visible z, set by render_all */
 
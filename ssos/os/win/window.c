@@ -2,37 +2,342 @@
 #include "../gfx/gfx.h"
 #include "../gfx/palette.h"
 #include "../gfx/profile.h"
+#include "../gfx/region.h"
 #include "../kernel/kernel.h"
+#include "../kernel/scheduler.h"
+#include "../mem/memory.h"
 #include <string.h>
 
-static SSWindow windows[SS_MAX_WINDOWS];
-static uint8_t zmap[SS_ZMAP_W * SS_ZMAP_H];
-/* The z-map depends only on visibility, geometry, and z-order.  Content
- * updates and repeated partial paints must not pay to rebuild it. */
+/* Window table.  Slot i holds id i + 1; ss_slab_window hands out the free
+ * slots, so create and destroy never scan the table.  Both hosts put the
+ * table on their heap with ss_win_set_storage(), keeping .data+.bss
+ * flat; only native tests, which mostly run without storage, get a
+ * built-in one. */
+SSSlabCache ss_slab_window;
+#ifdef SS_HOST_TEST
+static SSWindow win_table[SS_MAX_WINDOWS];
+static SSWinText win_text_table[SS_MAX_WINDOWS];
+#define WIN_BUILTIN_CAP SS_MAX_WINDOWS
+#else
+#define win_table      ((SSWindow*)NULL)
+#define win_text_table ((SSWinText*)NULL)
+#define WIN_BUILTIN_CAP 0
+#endif
+static SSWindow* windows = win_table;
+static uint16_t win_cap = 0;
+static void* win_storage;
+static uint32_t win_storage_size;
+
+static SSSlabCache win_text_cache;
+
+/* A live window's id.  A destroyed slot belongs to ss_slab_window and
+ * holds its free-list link, so every id-taking entry point must reject it
+ * before touching the slot. */
+static inline int win_live(uint16_t id) {
+    return id != 0 && id <= win_cap && windows[id - 1].id != 0;
+}
+
+/* Z-order list: every live slot, hidden ones included, doubly linked
+ * through zprev/znext in paint order (ascending z, a later slot wins a
+ * tie).  create, destroy and set_z relink one slot, so nothing sorts the
+ * windows again; walks skip hidden slots. */
+#define SS_ZLIST_NIL 0xFFFF
+static uint16_t zlist_head = SS_ZLIST_NIL;
+static uint16_t zlist_tail = SS_ZLIST_NIL;
+/* Window index.  zmap holds, per 8x8 block, the id of the topmost window
+ * touching the block (0 = desktop), with SS_ZMAP_EDGE set when that
+ * window does not cover the whole block.  Each window records the block
+ * rows it touches (zrow0..zrow1).  Both depend only on visibility,
+ * geometry, and z-order, so content updates and repeated partial paints
+ * must not pay to rebuild them. */
+#define SS_ZMAP_EDGE 0x8000
+#define SS_ZMAP_ID   0x7FFF
+static uint16_t zmap[SS_ZMAP_W * SS_ZMAP_H];
 static uint8_t zmap_valid;
 static uint16_t win_count;
 uint16_t ss_win_active_z = 0;  /* highest visible z, set by render_all */
 
-void ss_win_init(void) {
-    memset(windows, 0, sizeof(windows));
-    memset(zmap, 0xFF, sizeof(zmap));
+/* Exact visible regions: every window's rect minus all higher windows, and
+ * the desktop (screen minus all windows).  Like the z-map they depend only
+ * on geometry, visibility and z-order and are rebuilt lazily.  The boxes of
+ * all regions share one pool so the per-window cost stays a few bytes of
+ * .bss; a region that overflows SSRegion or the pool is marked inexact and
+ * painted through its whole rect, as before. */
+#define SS_WIN_VIS_POOL 256
+
+static SSRegionBox vis_pool[SS_WIN_VIS_POOL];
+static SSWinVis desk_vis;
+static uint8_t vis_valid;
+
+/* Frame damage list.  Rects that overlap or touch are merged when their
+ * bounding box wastes at most a quarter of the covered area, so the flush
+ * repaints a few compact rects instead of the same pixels several times.
+ * A full list forces the cheapest merge. */
+static SSGfxRect damage[SS_DAMAGE_MAX];
+static int damage_count;
+static SSTask* damage_task;     /* ss_win_notify() */
+
+/* Double-buffered presentation.  The compositor draws on the back page and
+ * ss_win_present() flips.  Each page then misses what was drawn on the
+ * other one during the previous frame: page_damage collects everything
+ * drawn on the back page this frame, and after the flip it becomes `stale`,
+ * the rects the new back page must repaint before anything else lands
+ * on it. */
+static uint8_t double_buffered;
+static SSGfxRect page_damage[SS_DAMAGE_MAX];
+static int page_damage_count;
+static SSGfxRect stale[SS_DAMAGE_MAX];
+static int stale_count;
+
+static void ensure_vis(void);
+static int window_unobscured(const SSWindow* win);
+
+static void invalidate_geometry(void) {
     zmap_valid = 0;
+    vis_valid = 0;
+}
+
+/* 1 when slot a paints before slot b. */
+static int zlist_before(int a, int b) {
+    return windows[a].z < windows[b].z ||
+           (windows[a].z == windows[b].z && a < b);
+}
+
+/* Insert slot i at its place.  Searched from the top: new and raised
+ * windows usually land there. */
+static void zlist_link(int i) {
+    int at = zlist_tail;
+    while (at != SS_ZLIST_NIL && zlist_before(i, at)) at = windows[at].zprev;
+    windows[i].zprev = (uint16_t)at;
+    windows[i].znext = at == SS_ZLIST_NIL ? zlist_head : windows[at].znext;
+    if (at == SS_ZLIST_NIL) zlist_head = (uint16_t)i;
+    else windows[at].znext = (uint16_t)i;
+    if (windows[i].znext == SS_ZLIST_NIL) zlist_tail = (uint16_t)i;
+    else windows[windows[i].znext].zprev = (uint16_t)i;
+}
+
+static void zlist_unlink(int i) {
+    if (windows[i].zprev == SS_ZLIST_NIL) zlist_head = windows[i].znext;
+    else windows[windows[i].zprev].znext = windows[i].znext;
+    if (windows[i].znext == SS_ZLIST_NIL) zlist_tail = windows[i].zprev;
+    else windows[windows[i].znext].zprev = windows[i].zprev;
+}
+
+/* Visible slots from slot i along the list, or NIL. */
+static int zlist_visible_up(int i) {
+    while (i != SS_ZLIST_NIL && !(windows[i].flags & SS_WIN_VISIBLE)) i = windows[i].znext;
+    return i;
+}
+
+static int zlist_visible_down(int i) {
+    while (i != SS_ZLIST_NIL && !(windows[i].flags & SS_WIN_VISIBLE)) i = windows[i].zprev;
+    return i;
+}
+
+/* Give the listed windows z = first, first + 1, ... in list order.  Order,
+ * and so the picture, is unchanged; only the numbers are compacted. */
+static void zlist_renumber(uint16_t first) {
+    uint16_t z = first;
+    for (int i = zlist_head; i != SS_ZLIST_NIL; i = windows[i].znext) windows[i].z = z++;
+}
+
+static uint32_t rect_area(SSGfxRect r) {
+    return (uint32_t)r.w * (uint32_t)r.h;
+}
+
+static SSGfxRect rect_bound(SSGfxRect a, SSGfxRect b) {
+    int x0 = a.x < b.x ? a.x : b.x;
+    int y0 = a.y < b.y ? a.y : b.y;
+    int x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+    int y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+    return (SSGfxRect){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+/* Pixels the bounding box of a and b would repaint that neither covers. */
+static uint32_t merge_waste(SSGfxRect a, SSGfxRect b, uint32_t* covered) {
+    uint32_t overlap = 0;
+    int ix = (a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w) - (a.x > b.x ? a.x : b.x);
+    int iy = (a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h) - (a.y > b.y ? a.y : b.y);
+    if (ix > 0 && iy > 0) overlap = (uint32_t)ix * (uint32_t)iy;
+    *covered = rect_area(a) + rect_area(b) - overlap;
+    return rect_area(rect_bound(a, b)) - *covered;
+}
+
+static int rects_touch(SSGfxRect a, SSGfxRect b) {
+    return a.x <= b.x + b.w && b.x <= a.x + a.w &&
+           a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+/* Clip r to the screen and merge it into list. */
+static void damage_list_add(SSGfxRect* list, int* count, SSGfxRect r) {
+    if (r.x < 0) { r.w += r.x; r.x = 0; }
+    if (r.y < 0) { r.h += r.y; r.y = 0; }
+    if (r.x + r.w > ss_current_mode->display_w) r.w = ss_current_mode->display_w - r.x;
+    if (r.y + r.h > ss_current_mode->display_h) r.h = ss_current_mode->display_h - r.y;
+    if (r.w <= 0 || r.h <= 0) return;
+    uint32_t covered;
+
+    /* A merge can make the result mergeable with an earlier rect, so
+     * restart the scan after each one. */
+    for (int i = 0; i < *count; ) {
+        if (rects_touch(r, list[i]) &&
+            merge_waste(r, list[i], &covered) * 4 <= covered) {
+            r = rect_bound(r, list[i]);
+            list[i] = list[--*count];
+            SS_PROFILE_DAMAGE_MERGE();
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+    if (*count == SS_DAMAGE_MAX) {
+        int best = 0;
+        uint32_t best_waste = merge_waste(r, list[0], &covered);
+        for (int i = 1; i < *count; i++) {
+            uint32_t waste = merge_waste(r, list[i], &covered);
+            if (waste < best_waste) { best_waste = waste; best = i; }
+        }
+        r = rect_bound(r, list[best]);
+        list[best] = list[--*count];
+        SS_PROFILE_DAMAGE_MERGE();
+    }
+    list[(*count)++] = r;
+}
+
+void ss_win_add_damage(int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return;
+    SS_PROFILE_DAMAGE_RECT();
+    damage_list_add(damage, &damage_count, (SSGfxRect){ x, y, w, h });
+    ss_task_signal(damage_task, SS_SIG_DAMAGE);
+}
+
+void ss_win_notify(SSTask* task) {
+    damage_task = task;
+}
+
+/* Record pixels changed on the back page so the other page catches up
+ * after the next flip. */
+static void page_note(SSGfxRect r) {
+    if (double_buffered) damage_list_add(page_damage, &page_damage_count, r);
+}
+
+void ss_win_note_drawn(int x, int y, int w, int h) {
+    page_note((SSGfxRect){ x, y, w, h });
+}
+
+static void damage_window(const SSWindow* win) {
+    ss_win_add_damage(win->x, win->y, win->w, win->h);
+}
+
+static void repaint_region(int rx, int ry, int rw, int rh);
+
+/* Repaint every queued rect once and empty the list.  Returns the number of
+ * rects repainted.  The list is copied first so render callbacks may queue
+ * damage for the next frame.  Double-buffered, the back page's stale rects
+ * are merged in, so one pass brings it up to date: the union of this
+ * frame's and the previous frame's damage. */
+int ss_win_flush_damage(void) {
+    SSGfxRect pending[SS_DAMAGE_MAX];
+    int n = damage_count;
+    if (n == 0 && stale_count == 0) return 0;
+    memcpy(pending, damage, (size_t)n * sizeof(SSGfxRect));
+    damage_count = 0;
+    for (int i = 0; i < n; i++) page_note(pending[i]);
+    for (int i = 0; i < stale_count; i++) damage_list_add(pending, &n, stale[i]);
+    stale_count = 0;
+    SS_PROFILE_DAMAGE_FLUSH();
+    for (int i = 0; i < n; i++) {
+        repaint_region(pending[i].x, pending[i].y, pending[i].w, pending[i].h);
+    }
+    return n;
+}
+
+int ss_win_present(void) {
+    if (!double_buffered) return 0;
+    ss_win_flush_damage();
+    if (page_damage_count == 0) return 0;   /* pages already identical */
+    memcpy(stale, page_damage, (size_t)page_damage_count * sizeof(SSGfxRect));
+    stale_count = page_damage_count;
+    page_damage_count = 0;
+    ss_gfx_flip();
+    return 1;
+}
+
+int ss_win_set_double_buffer(int on) {
+    if (on && !double_buffered) {
+        if (ss_current_mode->page_count < 2) return 0;
+        /* Show the current page and start drawing on the other, which
+         * holds nothing of ours yet. */
+        ss_gfx_flip();
+        double_buffered = 1;
+        page_damage_count = 0;
+        stale[0] = (SSGfxRect){ 0, 0, ss_current_mode->display_w,
+                                ss_current_mode->display_h };
+        stale_count = 1;
+    } else if (!on && double_buffered) {
+        /* Bring the back page up to date, show it and keep drawing on it. */
+        ss_win_flush_damage();
+        ss_gfx_flip();
+        ss_gfx_draw_on_display();
+        double_buffered = 0;
+        page_damage_count = 0;
+        stale_count = 0;
+    }
+    return double_buffered;
+}
+
+int ss_win_pending_damage(SSGfxRect* out, int max) {
+    int n = damage_count < max ? damage_count : max;
+    if (n > 0) memcpy(out, damage, (size_t)n * sizeof(SSGfxRect));
+    return damage_count;
+}
+
+void ss_win_set_storage(void* mem, uint32_t size) {
+    win_storage = size >= SS_WIN_STORAGE_SIZE(1) ? mem : NULL;
+    win_storage_size = size;
+}
+
+void ss_win_init(void) {
+    uint32_t cap = WIN_BUILTIN_CAP;
+    SSWinText* texts = win_text_table;
+    windows = win_table;
+    if (win_storage != NULL) {
+        /* The table first, then as many text blocks as it has slots. */
+        cap = win_storage_size / SS_WIN_STORAGE_SIZE(1);
+        if (cap > SS_ZMAP_ID) cap = SS_ZMAP_ID;
+        windows = (SSWindow*)win_storage;
+        texts = (SSWinText*)(windows + cap);
+    }
+    win_cap = (uint16_t)cap;
+    if (cap > 0) {
+        memset(windows, 0, cap * sizeof(SSWindow));
+        ss_slab_init(&ss_slab_window, sizeof(SSWindow), windows, cap * sizeof(SSWindow));
+        ss_slab_init(&win_text_cache, sizeof(SSWinText), texts, cap * sizeof(SSWinText));
+    } else {
+        /* No storage: every create fails with 0. */
+        memset(&ss_slab_window, 0, sizeof(ss_slab_window));
+        memset(&win_text_cache, 0, sizeof(win_text_cache));
+    }
+    damage_count = 0;
+    double_buffered = 0;
+    page_damage_count = 0;
+    stale_count = 0;
+    invalidate_geometry();
+    zlist_head = zlist_tail = SS_ZLIST_NIL;
     win_count = 0;
 }
 
 uint16_t ss_win_create(int x, int y, int w, int h, uint16_t z) {
     ss_disable_interrupts();
 
-    uint16_t i;
-    for (i = 0; i < SS_MAX_WINDOWS; i++) {
-        if (windows[i].id == 0) break;
-    }
-    if (i >= SS_MAX_WINDOWS) {
+    SSWindow* win = ss_slab_alloc(&ss_slab_window);
+    if (win == NULL) {
         ss_enable_interrupts();
         return 0;
     }
 
-    SSWindow* win = &windows[i];
+    uint16_t i = (uint16_t)(win - windows);
+    memset(win, 0, sizeof(*win));
     win->x = x;
     win->y = y;
     win->w = w;
@@ -43,13 +348,11 @@ uint16_t ss_win_create(int x, int y, int w, int h, uint16_t z) {
     win->dirty_y = 0;
     win->dirty_w = w;
     win->dirty_h = h;
-    win->render = NULL;
     win->id = i + 1;
-    memset(win->title, 0, sizeof(win->title));
-    memset(win->content, 0, sizeof(win->content));
-    memset(win->content_prev, 0, sizeof(win->content_prev));
     win_count++;
-    zmap_valid = 0;
+    zlist_link(i);
+    invalidate_geometry();
+    damage_window(win);
     SS_PROFILE_DIRTY_MARK();
     if (w > 0 && h > 0) SS_PROFILE_DIRTY_AREA((uint32_t)w * (uint32_t)h);
 
@@ -58,84 +361,126 @@ uint16_t ss_win_create(int x, int y, int w, int h, uint16_t z) {
 }
 
 void ss_win_destroy(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
+    if (!win_live(id)) return;
     ss_disable_interrupts();
+    if (windows[id - 1].id == 0) {
+        ss_enable_interrupts();
+        return;
+    }
+    if (windows[id - 1].flags & SS_WIN_VISIBLE) damage_window(&windows[id - 1]);
+    zlist_unlink(id - 1);
+    ss_slab_free(&win_text_cache, windows[id - 1].text);
     memset(&windows[id - 1], 0, sizeof(SSWindow));
+    ss_slab_free(&ss_slab_window, &windows[id - 1]);
     win_count--;
-    zmap_valid = 0;
+    invalidate_geometry();
     ss_enable_interrupts();
 }
 
 void ss_win_show(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
+    if (!win_live(id)) return;
+    if (!(windows[id - 1].flags & SS_WIN_VISIBLE)) damage_window(&windows[id - 1]);
     windows[id - 1].flags |= SS_WIN_VISIBLE | SS_WIN_DIRTY;
-    zmap_valid = 0;
+    invalidate_geometry();
     SS_PROFILE_DIRTY_MARK();
     SS_PROFILE_DIRTY_AREA((uint32_t)windows[id - 1].w * (uint32_t)windows[id - 1].h);
 }
 
 void ss_win_hide(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
+    if (!win_live(id)) return;
+    if (windows[id - 1].flags & SS_WIN_VISIBLE) damage_window(&windows[id - 1]);
     windows[id - 1].flags &= ~SS_WIN_VISIBLE;
-    zmap_valid = 0;
+    invalidate_geometry();
 }
 
 void ss_win_damage(uint16_t id, int x, int y, int w, int h) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
+    if (!win_live(id)) return;
     SSWindow* win = &windows[id - 1];
     win->flags |= SS_WIN_DIRTY;
     win->dirty_x = x;
     win->dirty_y = y;
     win->dirty_w = w;
     win->dirty_h = h;
+    if (win->flags & SS_WIN_VISIBLE) ss_win_add_damage(win->x + x, win->y + y, w, h);
     SS_PROFILE_DIRTY_MARK();
     if (w > 0 && h > 0) SS_PROFILE_DIRTY_AREA((uint32_t)w * (uint32_t)h);
 }
 
 void ss_win_move(uint16_t id, int x, int y) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
+    if (!win_live(id)) return;
     SSWindow* win = &windows[id - 1];
+    int ox = win->x, oy = win->y;
+    int visible = (win->flags & SS_WIN_VISIBLE) && (ox != x || oy != y);
+    int blit = 0;
+
+    /* An unobscured, fully on-screen window keeps its pixels: they are
+     * blitted to the new spot and only the exposed strip (old minus new)
+     * is queued for recomposition, so a small move costs in proportion to
+     * the distance.  Pending damage is flushed first so the blit copies
+     * current pixels. */
+    if (visible) {
+        ss_win_flush_damage();
+        blit = window_unobscured(win);
+    }
     win->x = x;
     win->y = y;
+    invalidate_geometry();
+    if (visible && blit) blit = window_unobscured(win);
+    if (blit) {
+        SSRegion exposed;
+        ss_gfx_blit(ox, oy, x, y, win->w, win->h);
+        page_note((SSGfxRect){ x, y, win->w, win->h });
+        ss_region_set_rect(&exposed, (SSGfxRect){ ox, oy, win->w, win->h });
+        ss_region_subtract_rect(&exposed, (SSGfxRect){ x, y, win->w, win->h });
+        for (int i = 0; i < exposed.count; i++) {
+            SSGfxRect r = ss_region_rect(&exposed, i);
+            ss_win_add_damage(r.x, r.y, r.w, r.h);
+        }
+    } else if (visible) {
+        /* Both the vacated and the newly covered rect change on screen. */
+        ss_win_add_damage(ox, oy, win->w, win->h);
+        damage_window(win);
+    }
     win->flags |= SS_WIN_DIRTY;
     win->dirty_x = 0;
     win->dirty_y = 0;
     win->dirty_w = win->w;
     win->dirty_h = win->h;
-    zmap_valid = 0;
     SS_PROFILE_DIRTY_MARK();
     SS_PROFILE_DIRTY_AREA((uint32_t)win->w * (uint32_t)win->h);
 }
 
 static void rebuild_zmap(void) {
     SS_PROFILE_ZMAP_REBUILD();
-    /* 0 = uncovered.  Must NOT be 0xFF: the max-z update below only writes
-     * when win->z > current, and 0xFF(255) would suppress every z<=255. */
     memset(zmap, 0, sizeof(zmap));
 
-    /* Sort windows by z-order (ascending) and update zmap */
-    for (uint16_t i = 0; i < SS_MAX_WINDOWS; i++) {
-        SSWindow* win = &windows[i];
-        if (win->id == 0 || !(win->flags & SS_WIN_VISIBLE)) continue;
-
+    /* Paint the ids bottom to top, so each block ends up with the window
+     * a repaint would leave on top of it. */
+    for (int k = zlist_visible_up(zlist_head); k != SS_ZLIST_NIL;
+         k = zlist_visible_up(windows[k].znext)) {
+        SSWindow* win = &windows[k];
+        win->zrow0 = 1;
+        win->zrow1 = 0;                 /* touches no row */
+        if (win->w == 0 || win->h == 0 || win->y >= SS_ZMAP_H * SS_BLOCK_SIZE)
+            continue;
+        int x1 = win->x + win->w, y1 = win->y + win->h;
         int bx0 = win->x / SS_BLOCK_SIZE;
         int by0 = win->y / SS_BLOCK_SIZE;
-        int bx1 = (win->x + win->w) / SS_BLOCK_SIZE;
-        int by1 = (win->y + win->h) / SS_BLOCK_SIZE;
-
-        if (bx0 < 0) bx0 = 0;
-        if (by0 < 0) by0 = 0;
+        int bx1 = (x1 - 1) / SS_BLOCK_SIZE;
+        int by1 = (y1 - 1) / SS_BLOCK_SIZE;
         if (bx1 >= SS_ZMAP_W) bx1 = SS_ZMAP_W - 1;
         if (by1 >= SS_ZMAP_H) by1 = SS_ZMAP_H - 1;
+        win->zrow0 = (uint8_t)by0;
+        win->zrow1 = (uint8_t)by1;
 
         for (int by = by0; by <= by1; by++) {
+            int row_edge = by * SS_BLOCK_SIZE < win->y ||
+                           (by + 1) * SS_BLOCK_SIZE > y1;
             for (int bx = bx0; bx <= bx1; bx++) {
-                /* keep the HIGHEST z covering this block, not just the
-                 * last one written (array order is arbitrary vs. z).  The
-                 * occlusion test in render_all compares zmap <= win->z, so
-                 * max-z here is what makes it correct. */
-                if (win->z > zmap[by * SS_ZMAP_W + bx])
-                    zmap[by * SS_ZMAP_W + bx] = win->z;
+                int edge = row_edge || bx * SS_BLOCK_SIZE < win->x ||
+                           (bx + 1) * SS_BLOCK_SIZE > x1;
+                zmap[by * SS_ZMAP_W + bx] =
+                    (uint16_t)(win->id | (edge ? SS_ZMAP_EDGE : 0));
             }
         }
     }
@@ -146,6 +491,111 @@ static void ensure_zmap(void) {
     if (!zmap_valid) rebuild_zmap();
 }
 
+static SSGfxRect win_screen_rect(const SSWindow* win) {
+    int x0 = win->x, y0 = win->y;
+    int x1 = x0 + (int)win->w, y1 = y0 + (int)win->h;
+    if (x1 > ss_current_mode->display_w) x1 = ss_current_mode->display_w;
+    if (y1 > ss_current_mode->display_h) y1 = ss_current_mode->display_h;
+    return (SSGfxRect){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+/* Store r's boxes in the pool.  Inexact when r overflowed or the pool is
+ * full; the pool cursor is the caller's. */
+static void vis_store(SSWinVis* vis, const SSRegion* r, uint16_t* used) {
+    vis->first = *used;
+    vis->count = 0;
+    vis->exact = 0;
+    if (r->overflow || *used + r->count > SS_WIN_VIS_POOL) return;
+    memcpy(&vis_pool[*used], r->box, r->count * sizeof(SSRegionBox));
+    vis->count = r->count;
+    vis->exact = 1;
+    *used = (uint16_t)(*used + r->count);
+}
+
+/* Top-down sweep: a window sees its rect minus the union of everything
+ * above it, and the desktop sees what is left of the screen. */
+static void rebuild_vis(void) {
+    SSRegion covered, r;
+    uint16_t used = 0;
+
+    for (int i = zlist_head; i != SS_ZLIST_NIL; i = windows[i].znext) {
+        windows[i].vis.count = 0;
+        windows[i].vis.exact = 1;
+    }
+
+    ss_region_init(&covered);
+    for (int k = zlist_visible_down(zlist_tail); k != SS_ZLIST_NIL;
+         k = zlist_visible_down(windows[k].zprev)) {
+        SSWindow* win = &windows[k];
+        SSGfxRect rect = win_screen_rect(win);
+        ss_region_set_rect(&r, rect);
+        ss_region_subtract(&r, &r, &covered);
+        vis_store(&win->vis, &r, &used);
+        ss_region_union_rect(&covered, rect);
+    }
+    ss_region_set_rect(&r, (SSGfxRect){ 0, 0, ss_current_mode->display_w,
+                                        ss_current_mode->display_h });
+    ss_region_subtract(&r, &r, &covered);
+    vis_store(&desk_vis, &r, &used);
+    vis_valid = 1;
+}
+
+static void ensure_vis(void) {
+    if (!vis_valid) rebuild_vis();
+}
+
+/* 1 when the whole window is on-screen and nothing covers it. */
+static int window_unobscured(const SSWindow* win) {
+    ensure_vis();
+    const SSWinVis* vis = &win->vis;
+    if (win->w == 0 || win->h == 0) return 0;
+    if (win->x + win->w > ss_current_mode->display_w ||
+        win->y + win->h > ss_current_mode->display_h) return 0;
+    if (!vis->exact || vis->count != 1) return 0;
+    const SSRegionBox* b = &vis_pool[vis->first];
+    return b->x0 == win->x && b->y0 == win->y &&
+           b->x1 == win->x + win->w && b->y1 == win->y + win->h;
+}
+
+int ss_win_unobscured(uint16_t id) {
+    if (!win_live(id) || !(windows[id - 1].flags & SS_WIN_VISIBLE)) return 0;
+    return window_unobscured(&windows[id - 1]);
+}
+
+/* Clip `box` against the optional paint rect. */
+static int vis_box_clip(const SSRegionBox* b, const SSGfxRect* clip, SSGfxRect* out) {
+    int x0 = b->x0, y0 = b->y0, x1 = b->x1, y1 = b->y1;
+    if (clip != NULL) {
+        if (clip->x > x0) x0 = clip->x;
+        if (clip->y > y0) y0 = clip->y;
+        if (clip->x + clip->w < x1) x1 = clip->x + clip->w;
+        if (clip->y + clip->h < y1) y1 = clip->y + clip->h;
+    }
+    *out = (SSGfxRect){ x0, y0, x1 - x0, y1 - y0 };
+    return x0 < x1 && y0 < y1;
+}
+
+/* Desktop stipple, restricted to pixels no window covers when the desktop
+ * region is exact. */
+static void paint_desktop(const SSGfxRect* clip) {
+    uint16_t c1 = ss_palette_index(SS_PALETTE_WHITE);
+    uint16_t c2 = ss_palette_index(SS_PALETTE_MEDIUM_GRAY);
+    SSGfxRect r;
+    if (!desk_vis.exact) {
+        if (clip == NULL) {
+            ss_gfx_fill_stipple(0, 0, ss_current_mode->display_w,
+                                ss_current_mode->display_h, c1, c2);
+        } else {
+            ss_gfx_fill_stipple(clip->x, clip->y, clip->w, clip->h, c1, c2);
+        }
+        return;
+    }
+    for (int i = 0; i < desk_vis.count; i++) {
+        if (vis_box_clip(&vis_pool[desk_vis.first + i], clip, &r))
+            ss_gfx_fill_stipple(r.x, r.y, r.w, r.h, c1, c2);
+    }
+}
+
 static void draw_frame_rect(SSGfxRect rect, const SSGfxRect* clip, SSPalette color) {
     uint16_t index = ss_palette_index(color);
     if (clip == NULL) {
@@ -177,24 +627,48 @@ static void draw_frame(SSWindow* win, int is_fg, const SSGfxRect* clip) {
                     clip, SS_PALETTE_BLACK);
 }
 
+static int vis_is_whole(const SSWindow* win, const SSWinVis* vis) {
+    SSGfxRect rect = win_screen_rect(win);
+    const SSRegionBox* b = &vis_pool[vis->first];
+    return b->x0 == rect.x && b->y0 == rect.y &&
+           b->x1 == rect.x + rect.w && b->y1 == rect.y + rect.h;
+}
+
+static void render_window(SSWindow* win, int is_fg, const SSGfxRect* clip) {
+    if (win->render) {
+        win->render(win, clip);
+    } else {
+        draw_frame(win, is_fg, clip);
+    }
+    SS_PROFILE_WINDOW_RENDERED();
+}
+
 /*
  * Paint visible windows in ascending z-order, optionally restricted to those
  * overlapping [rx,ry,rw,rh] (region pass-through from the drag path).  The
- * caller has already laid down the stipple background and rebuild_zmap().
+ * caller has already painted the desktop and brought the visible regions
+ * up to date.
  *
- * Replaces the earlier "for z in 0..255" sweep: with <= SS_MAX_WINDOWS
- * windows the z*windows product was pure waste.  We collect visible windows
- * into a small stack array, insertion-sort by z, and render in one pass.
+ * Replaces the earlier "for z in 0..255" sweep: the z*windows product was
+ * pure waste.  The z-order list is already sorted, so this is one walk
+ * over the live windows, and the block-row test drops most of them.
  */
 static void paint_windows_zorder(int highest_z,
                                  int rx, int ry, int rw, int rh,
                                  int use_region, const SSGfxRect* clip) {
-    SSWindow* order[SS_MAX_WINDOWS];
-    int n = 0;
+    int by0 = 0, by1 = SS_ZMAP_H - 1;
 
-    for (int i = 0; i < SS_MAX_WINDOWS; i++) {
-        SSWindow* win = &windows[i];
-        if (win->id == 0 || !(win->flags & SS_WIN_VISIBLE)) continue;
+    /* Only windows that touch the region's block rows are candidates. */
+    if (use_region) {
+        by0 = ry / SS_BLOCK_SIZE;
+        by1 = (ry + rh - 1) / SS_BLOCK_SIZE;
+        if (by0 < 0) by0 = 0;
+        if (by1 >= SS_ZMAP_H) by1 = SS_ZMAP_H - 1;
+    }
+    for (int k = zlist_visible_up(zlist_head); k != SS_ZLIST_NIL;
+         k = zlist_visible_up(windows[k].znext)) {
+        SSWindow* win = &windows[k];
+        if (use_region && (win->zrow0 > by1 || win->zrow1 < by0)) continue;
         SS_PROFILE_WINDOW_CONSIDERED();
         if (use_region) {
             /* skip windows that don't overlap the dirty region */
@@ -202,56 +676,46 @@ static void paint_windows_zorder(int highest_z,
                 win->y >= ry + rh || win->y + (int)win->h <= ry)
                 { SS_PROFILE_WINDOW_SKIP_NO_OVERLAP(); continue; }
         }
-        /* insertion sort: keep order[] ascending by z */
-        int j = n;
-        while (j > 0 && (int)order[j - 1]->z > (int)win->z) {
-            order[j] = order[j - 1];
-            j--;
-        }
-        order[j] = win;
-        n++;
-    }
-
-    for (int k = 0; k < n; k++) {
-        SSWindow* win = order[k];
-
-        /* Do not use the coarse 8x8 max-z map as a draw skip.  A block can
-         * contain both exposed pixels of this window and pixels covered by a
-         * higher window, so max-z cannot prove full rectangle occlusion.
-         * Recompose every overlapping window in z-order; with the small
-         * window limit this is cheaper than repairing stale pixels after a
-         * drag and is the correctness baseline for a future exact occluder. */
-
-        if (win->render) {
-            win->render(win, clip);
+        const SSWinVis* vis = &win->vis;
+        int is_fg = (int)win->z == highest_z;
+
+        /* Paint through the exact visible region, so lower windows are not
+         * drawn and then overdrawn.  An unobscured window keeps the single
+         * call with the caller's clip (NULL for a full repaint). */
+        if (!vis->exact || (vis->count == 1 && vis_is_whole(win, vis))) {
+            render_window(win, is_fg, clip);
         } else {
-            draw_frame(win, (int)win->z == highest_z, clip);
+            int drawn = 0;
+            SSGfxRect box;
+            for (int i = 0; i < vis->count; i++) {
+                if (!vis_box_clip(&vis_pool[vis->first + i], clip, &box)) continue;
+                render_window(win, is_fg, &box);
+                drawn = 1;
+            }
+            if (!drawn) SS_PROFILE_WINDOW_SKIP_OCCLUDED();
         }
-        SS_PROFILE_WINDOW_RENDERED();
         win->flags &= ~SS_WIN_DIRTY;
     }
 }
 
 /* Highest z among visible windows, or -1 if none. */
 static int compute_highest_z(void) {
-    int highest_z = -1;
-    for (int i = 0; i < SS_MAX_WINDOWS; i++) {
-        if (windows[i].id && (windows[i].flags & SS_WIN_VISIBLE) &&
-            (int)windows[i].z > highest_z)
-            highest_z = windows[i].z;
-    }
-    return highest_z;
+    int top = zlist_visible_down(zlist_tail);
+    return top != SS_ZLIST_NIL ? (int)windows[top].z : -1;
 }
 
 void ss_win_render_all(void) {
     SS_PROFILE_RENDER_ALL();
     ensure_zmap();
-
-    /* Background stipple (no pre-clear — covers old window positions naturally) */
-    ss_gfx_fill_stipple(0, 0, ss_current_mode->display_w,
-                        ss_current_mode->display_h,
-                        ss_palette_index(SS_PALETTE_WHITE),
-                        ss_palette_index(SS_PALETTE_MEDIUM_GRAY));
+    ensure_vis();
+    damage_count = 0;  /* everything is repainted below */
+    stale_count = 0;
+    page_note((SSGfxRect){ 0, 0, ss_current_mode->display_w,
+                           ss_current_mode->display_h });
+
+    /* Background stipple (no pre-clear — covers old window positions
+     * naturally), only where no window will paint over it. */
+    paint_desktop(NULL);
     SS_PROFILE_FULL_BG_FILL();
 
     int highest_z = compute_highest_z();
@@ -267,11 +731,16 @@ void ss_win_render_all(void) {
  * screen repaint.
  */
 void ss_win_render_region(int rx, int ry, int rw, int rh) {
+    page_note((SSGfxRect){ rx, ry, rw, rh });
+    repaint_region(rx, ry, rw, rh);
+}
+
+static void repaint_region(int rx, int ry, int rw, int rh) {
     SS_PROFILE_RENDER_REGION();
     ensure_zmap();
-    ss_gfx_fill_stipple(rx, ry, rw, rh,
-                        ss_palette_index(SS_PALETTE_WHITE),
-                        ss_palette_index(SS_PALETTE_MEDIUM_GRAY));
+    ensure_vis();
+    SSGfxRect clip = {rx, ry, rw, rh};
+    paint_desktop(&clip);
     if (rw > 0 && rh > 0) {
         SS_PROFILE_DIRTY_MARK();
         SS_PROFILE_DIRTY_AREA((uint32_t)rw * (uint32_t)rh);
@@ -289,100 +758,176 @@ void ss_win_render_region(int rx, int ry, int rw, int rh) {
     int highest_z = compute_highest_z();
     ss_win_active_z = (uint16_t)highest_z;
 
-    SSGfxRect clip = {rx, ry, rw, rh};
     paint_windows_zorder(highest_z, rx, ry, rw, rh, 1, &clip);
 }
 
+/* The block under the point answers directly unless its top window ends
+ * inside the block; then the windows touching the block row are tested
+ * exactly, top first. */
 int ss_win_hit_test(int mx, int my) {
-    int best_z = -1, best_id = -1;
-    for (int i = 0; i < SS_MAX_WINDOWS; i++) {
-        SSWindow* w = &windows[i];
-        if (w->id == 0 || !(w->flags & SS_WIN_VISIBLE)) continue;
+    if (mx < 0 || my < 0 || mx >= SS_ZMAP_W * SS_BLOCK_SIZE ||
+        my >= SS_ZMAP_H * SS_BLOCK_SIZE)
+        return -1;
+    ensure_zmap();
+    int by = my / SS_BLOCK_SIZE;
+    uint16_t top = zmap[by * SS_ZMAP_W + mx / SS_BLOCK_SIZE];
+    if (!(top & SS_ZMAP_EDGE)) return (top & SS_ZMAP_ID) ? (top & SS_ZMAP_ID) : -1;
+
+    for (int k = zlist_visible_down(zlist_tail); k != SS_ZLIST_NIL;
+         k = zlist_visible_down(windows[k].zprev)) {
+        const SSWindow* w = &windows[k];
+        if (by < w->zrow0 || by > w->zrow1) continue;
         if (mx >= w->x && mx < w->x + (int)w->w &&
-            my >= w->y && my < w->y + (int)w->h &&
-            (int)w->z > best_z) {
-            best_z = w->z;
-            best_id = w->id;
-        }
+            my >= w->y && my < w->y + (int)w->h)
+            return w->id;
     }
-    return best_id;
+    return -1;
 }
 
 int ss_win_get_x(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return 0;
+    if (!win_live(id)) return 0;
     return windows[id - 1].x;
 }
 
 int ss_win_get_y(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return 0;
+    if (!win_live(id)) return 0;
     return windows[id - 1].y;
 }
 int ss_win_get_w(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return 0;
+    if (!win_live(id)) return 0;
     return windows[id - 1].w;
 }
 int ss_win_get_h(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return 0;
+    if (!win_live(id)) return 0;
     return windows[id - 1].h;
 }
 int ss_win_get_z(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return 0;
+    if (!win_live(id)) return 0;
     return windows[id - 1].z;
 }
 
 SSWindow* ss_win_get_ptr(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return NULL;
+    if (!win_live(id)) return NULL;
     return &windows[id - 1];
 }
 
-void ss_win_set_title(uint16_t id, const char* title) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
-    SSWindow* win = &windows[id - 1];
-    strncpy(win->title, title, sizeof(win->title) - 1);
-    win->title[sizeof(win->title) - 1] = '\0';
+/* The window's text block, taken from the pool on first use.  The pool
+ * has a block per slot, so only a free slot gets NULL. */
+static SSWinText* win_text(SSWindow* win) {
+    if (win->text == NULL && win->id != 0) {
+        win->text = ss_slab_alloc(&win_text_cache);
+        if (win->text != NULL) {
+            win->text->title[0] = '\0';
+            ss_tgrid_init(&win->text->content);
+        }
+    }
+    return win->text;
 }
 
-void ss_win_set_content_line(uint16_t id, int line, const char* text) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
-    if (line < 0 || line >= 3) return;
-    SSWindow* win = &windows[id - 1];
+int16_t ss_win_set_title(uint16_t id, const char* title) {
+    if (!win_live(id) || title == NULL) return SS_ERR_PARAM;
+    SSWinText* t = win_text(&windows[id - 1]);
+    if (t == NULL) return SS_ERR_PARAM;
+    strncpy(t->title, title, sizeof(t->title) - 1);
+    t->title[sizeof(t->title) - 1] = '\0';
+    return SS_OK;
+}
+
+int16_t ss_win_set_content_line(uint16_t id, int line, const char* text) {
+    if (!win_live(id) || text == NULL) return SS_ERR_PARAM;
+    if (line < 0 || line >= SS_TGRID_ROWS) return SS_ERR_PARAM;
     /* Guard the copy: preemptive Timer D ISR can preempt a main-thread
      * read mid-strncpy. Cooperative never preempts a strncpy, but the
      * cost of disable/enable here is negligible, so guard unconditionally
      * for correctness under both threading models. */
     ss_disable_interrupts();
-    /* Copy then space-pad to the full buffer width. Padding makes every
-     * byte deterministic so callers can do a differential redraw (only
-     * repainting the changed suffix) without leaving stale trailing
-     * characters when a value shrinks. */
-    char* dst = win->content[line];
-    size_t cap = sizeof(win->content[line]);
-    strncpy(dst, text, cap - 1);
-    dst[cap - 1] = '\0';
-    for (size_t i = strlen(dst); i < cap - 1; i++) dst[i] = ' ';
-    dst[cap - 1] = '\0';
+    SSWinText* t = win_text(&windows[id - 1]);
+    if (t == NULL) {
+        ss_enable_interrupts();
+        return SS_ERR_PARAM;
+    }
+    /* The grid pads the line and marks just the cells that changed, so a
+     * renderer repaints those cells and a shrinking value is erased. */
+    ss_tgrid_set_line(&t->content, line, text);
     ss_enable_interrupts();
+    return SS_OK;
 }
 
 void ss_win_set_render(uint16_t id, void (*render)(SSWindow*, const SSGfxRect*)) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
+    if (!win_live(id)) return;
     windows[id - 1].render = render;
 }
 
 void ss_win_set_z(uint16_t id, uint16_t z) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
+    if (!win_live(id)) return;
+    if (windows[id - 1].z != z && (windows[id - 1].flags & SS_WIN_VISIBLE))
+        damage_window(&windows[id - 1]);
+    zlist_unlink(id - 1);
     windows[id - 1].z = z;
-    zmap_valid = 0;
+    zlist_link(id - 1);
+    invalidate_geometry();
+}
+
+/* Move a window to the top (bottom) of the z-order.  z goes one past the
+ * current top (below the bottom); when that would leave 1..SS_WIN_Z_MAX,
+ * every window is renumbered in order first, so callers never manage z. */
+void ss_win_raise(uint16_t id) {
+    if (!win_live(id)) return;
+    int i = id - 1;
+    if (zlist_tail == i) return;
+    if (windows[i].flags & SS_WIN_VISIBLE) damage_window(&windows[i]);
+    zlist_unlink(i);
+    if (windows[zlist_tail].z >= SS_WIN_Z_MAX) zlist_renumber(1);
+    windows[i].z = (uint16_t)(windows[zlist_tail].z + 1);
+    zlist_link(i);
+    invalidate_geometry();
+}
+
+void ss_win_lower(uint16_t id) {
+    if (!win_live(id)) return;
+    int i = id - 1;
+    if (zlist_head == i) return;
+    /* What it uncovers is inside its own rect. */
+    if (windows[i].flags & SS_WIN_VISIBLE) damage_window(&windows[i]);
+    zlist_unlink(i);
+    if (windows[zlist_head].z <= 1) zlist_renumber(2);
+    windows[i].z = (uint16_t)(windows[zlist_head].z - 1);
+    zlist_link(i);
+    invalidate_geometry();
+}
+
+/* Visible windows in z order, shared by the compositor and its callers. */
+uint16_t ss_win_bottom(void) {
+    int i = zlist_visible_up(zlist_head);
+    return i != SS_ZLIST_NIL ? windows[i].id : 0;
+}
+
+uint16_t ss_win_top(void) {
+    int i = zlist_visible_down(zlist_tail);
+    return i != SS_ZLIST_NIL ? windows[i].id : 0;
+}
+
+uint16_t ss_win_above(uint16_t id) {
+    if (!win_live(id)) return 0;
+    int i = zlist_visible_up(windows[id - 1].znext);
+    return i != SS_ZLIST_NIL ? windows[i].id : 0;
+}
+
+uint16_t ss_win_below(uint16_t id) {
+    if (!win_live(id)) return 0;
+    int i = zlist_visible_down(windows[id - 1].zprev);
+    return i != SS_ZLIST_NIL ? windows[i].id : 0;
 }
 
 void ss_win_mark_dirty(uint16_t id) {
-    if (id == 0 || id > SS_MAX_WINDOWS) return;
+    if (!win_live(id)) return;
     SSWindow* win = &windows[id - 1];
     win->flags |= SS_WIN_DIRTY;
     win->dirty_x = 0;
     win->dirty_y = 0;
     win->dirty_w = win->w;
     win->dirty_h = win->h;
+    if (win->flags & SS_WIN_VISIBLE) damage_window(win);
     SS_PROFILE_DIRTY_MARK();
     SS_PROFILE_DIRTY_AREA((uint32_t)win->w * (uint32_t)win->h);
 }
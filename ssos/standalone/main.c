@@ -2,7 +2,7 @@
  * SSOS Standalone — shared Windowed Demo host
  * CRT: 512x512 256-color (crtmod 8) or 1024x1024 16-color (crtmod 16)
  * Font: Spleen 5x8
- * Exit: ESC key
+ * Exit: ESC key (or the end of a -replay trace)
  *
  * Architecture:
  *   UI task (main, pri=8): shared os/app/scene.c loop + host V-sync hook
@@ -16,8 +16,10 @@
 #include "../os/gfx/gfx.h"
 #include "../os/gfx/palette.h"
 #include "../os/gfx/profile.h"
+#include "../os/gfx/overlay.h"
 #include "../os/win/win.h"
 #include "../os/kernel/main_task.h"
+#include "../os/kernel/input_trace.h"
 #include "../os/app/scene.h"
 
 #include <stdint.h>
@@ -68,7 +70,7 @@ static void init_palette_indices(void) {
 #define TITLE_H 12
 #define CONTENT_Y 14
 #define LINE_H 10
-#define LINE_LEN 28
+#define LINE_LEN SS_TGRID_COLS
 #define WIN_W 240
 #define WIN_H (CONTENT_Y + 3 * LINE_H + 4)
 
@@ -99,46 +101,43 @@ static SSTask main_tcb;
 
 static void draw_frame(SSWindow* w, int is_fg, const SSGfxRect* clip) {
     uint16_t t_bg = is_fg ? C_GRAY_L : C_WHITE;
+    SSGfxRect r[7 + 10];
+    uint16_t c[7 + 10];
+    int n = 0;
 
-    ss_gfx_rect_region((SSGfxRect){w->x + 1, w->y + 1, w->w - 2,
-                                   TITLE_H - 2}, clip, t_bg);
-    ss_gfx_rect_region((SSGfxRect){w->x + 1, w->y + TITLE_H, w->w - 2,
-                                   w->h - TITLE_H - 1}, clip, C_WHITE);
+#define FRAME_RECT(rx, ry, rw, rh, col) \
+    do { r[n] = (SSGfxRect){ (rx), (ry), (rw), (rh) }; c[n++] = (col); } while (0)
+    FRAME_RECT(w->x + 1, w->y + 1, w->w - 2, TITLE_H - 2, t_bg);
+    FRAME_RECT(w->x + 1, w->y + TITLE_H, w->w - 2, w->h - TITLE_H - 1, C_WHITE);
 
     /* Border lines */
-    ss_gfx_rect_region((SSGfxRect){w->x, w->y, w->w, 1}, clip, C_BLACK);
-    ss_gfx_rect_region((SSGfxRect){w->x, w->y + w->h - 1, w->w, 1}, clip,
-                       C_BLACK);
-    ss_gfx_rect_region((SSGfxRect){w->x, w->y + 1, 1, w->h - 2}, clip,
-                       C_BLACK);
-    ss_gfx_rect_region((SSGfxRect){w->x + w->w - 1, w->y + 1, 1, w->h - 2},
-                       clip, C_BLACK);
-    ss_gfx_rect_region((SSGfxRect){w->x + 1, w->y + TITLE_H - 1, w->w - 2, 1},
-                       clip, C_BLACK);
-
-    int tw = (int)strlen(w->title) * SS_FONT_ADV;
+    FRAME_RECT(w->x, w->y, w->w, 1, C_BLACK);
+    FRAME_RECT(w->x, w->y + w->h - 1, w->w, 1, C_BLACK);
+    FRAME_RECT(w->x, w->y + 1, 1, w->h - 2, C_BLACK);
+    FRAME_RECT(w->x + w->w - 1, w->y + 1, 1, w->h - 2, C_BLACK);
+    FRAME_RECT(w->x + 1, w->y + TITLE_H - 1, w->w - 2, 1, C_BLACK);
+
+    const char* title = w->text != NULL ? w->text->title : "";
+    int tw = (int)strlen(title) * SS_FONT_ADV;
     int tx = w->x + (w->w - tw) / 2;
 
     if (is_fg) {
         for (int i = 0; i < 5; i++) {
             int ly = w->y + 2 + i * 2;
             if (tx > w->x + 12)
-                ss_gfx_rect_region((SSGfxRect){w->x + 4, ly,
-                                               tx - 8 - (w->x + 4) + 1, 1},
-                                   clip, C_BLACK);
+                FRAME_RECT(w->x + 4, ly, tx - 8 - (w->x + 4) + 1, 1, C_BLACK);
             if (tx + tw + 8 < w->x + w->w - 4)
-                ss_gfx_rect_region((SSGfxRect){tx + tw + 8, ly,
-                                               (w->x + w->w - 5) -
-                                                   (tx + tw + 8) + 1,
-                                               1},
-                                   clip, C_BLACK);
+                FRAME_RECT(tx + tw + 8, ly,
+                           (w->x + w->w - 5) - (tx + tw + 8) + 1, 1, C_BLACK);
         }
     }
+#undef FRAME_RECT
+    ss_gfx_rect_batch(r, c, n, clip);
 
     if (clip == NULL)
-        ss_gfx_draw_text_fast(tx, w->y + 2, w->title, C_BLACK, t_bg);
+        ss_gfx_draw_text_fast(tx, w->y + 2, title, C_BLACK, t_bg);
     else
-        ss_gfx_draw_text_region(tx, w->y + 2, w->title, C_BLACK, t_bg, clip);
+        ss_gfx_draw_text_region(tx, w->y + 2, title, C_BLACK, t_bg, clip);
 }
 
 /* ---- Dirty content update ---- */
@@ -149,24 +148,12 @@ static void draw_frame(SSWindow* w, int is_fg, const SSGfxRect* clip) {
  * single page. */
 static int build_text_clip_windows(SSWindow* target, int clip_wins[3 * 4],
                                    int* target_pos) {
-    int order[3];
     int n = 0;
 
-    for (int i = 0; i < 3; i++) {
-        SSWindow* w = ss_win_get_ptr(win_ids[i]);
-        if (!(w->flags & SS_WIN_VISIBLE)) continue;
-        int j = n;
-        while (j > 0 && ss_win_get_z(win_ids[order[j - 1]]) > w->z) {
-            order[j] = order[j - 1];
-            j--;
-        }
-        order[j] = i;
-        n++;
-    }
-
     *target_pos = -1;
-    for (int i = 0; i < n; i++) {
-        SSWindow* w = ss_win_get_ptr(win_ids[order[i]]);
+    for (uint16_t id = ss_win_bottom(); id != 0 && n < 3; id = ss_win_above(id)) {
+        SSWindow* w = ss_win_get_ptr(id);
+        int i = n++;
         clip_wins[i * 4] = w->x;
         clip_wins[i * 4 + 1] = w->y;
         clip_wins[i * 4 + 2] = w->w;
@@ -180,30 +167,30 @@ static int draw_content_dirty(SSWindow* w) {
     int changed = 0;
     int clip_wins[3 * 4];
     int target_pos;
+    SSWinText* t = w->text;
+    if (t == NULL) return 0;
     int nclip = build_text_clip_windows(w, clip_wins, &target_pos);
 
-    for (int i = 0; i < 3; i++) {
-        char current[30];
+    for (int i = 0; i < SS_TGRID_ROWS; i++) {
+        char current[SS_TGRID_COLS + 1];
 
         /* The data task updates content under the same interrupt guard.
-         * Snapshot first, then draw with interrupts enabled; otherwise a
-         * Timer D preemption can leave a mixed old/new string in VRAM while
-         * content_prev incorrectly records the new string as complete. */
+         * Snapshot the row and take its changed cells together, then draw
+         * with interrupts enabled: a write that lands while drawing marks
+         * its cells again and is drawn next frame. */
         ss_disable_interrupts();
-        memcpy(current, w->content[i], sizeof(current));
+        memcpy(current, t->content.cell[i], sizeof(current));
+        uint32_t mask = ss_tgrid_take(&t->content, i);
         ss_enable_interrupts();
+        if (mask == 0) continue;
+        changed = 1;
 
-        if (memcmp(current, w->content_prev[i], sizeof(current)) != 0) {
-            changed = 1;
-            /* Redraw only the changed suffix. Content is space-padded by
-             * ss_win_set_content_line, so the first differing column marks
-             * the visible change and the padded tail erases any shrink. */
-            int j = 0;
-            while (j < LINE_LEN && current[j] == w->content_prev[i][j]) j++;
-
-            int x = w->x + 4 + j * SS_FONT_ADV;
+        /* Redraw each run of adjacent changed cells, not the line. */
+        int first, len;
+        for (int from = 0; (len = ss_tgrid_run(mask, from, &first)) > 0; from = first + len) {
+            int x = w->x + 4 + first * SS_FONT_ADV;
             int y = w->y + CONTENT_Y + i * LINE_H;
-            int text_w = (LINE_LEN - j - 1) * SS_FONT_ADV + SS_FONT_W;
+            int text_w = len * SS_FONT_ADV;
             int needs_clip = 0;
             for (int k = target_pos + 1; k < nclip; k++) {
                 int* upper = &clip_wins[k * 4];
@@ -214,67 +201,51 @@ static int draw_content_dirty(SSWindow* w) {
                 }
             }
 
+            char end = current[first + len];
+            current[first + len] = '\0';
             if (target_pos >= 0 && needs_clip) {
-                ss_gfx_draw_text_clip(w->x + 4 + j * SS_FONT_ADV,
-                                      y, current + j, C_BLACK, C_WHITE,
+                ss_gfx_draw_text_clip(x, y, current + first, C_BLACK, C_WHITE,
                                       clip_wins, nclip, target_pos);
             } else {
-                ss_gfx_draw_text_fast(x, y, current + j, C_BLACK, C_WHITE);
+                ss_gfx_draw_text_fast(x, y, current + first, C_BLACK, C_WHITE);
             }
-
-            /* Do not acknowledge a value that changed while it was drawn.
-             * Leaving content_prev untouched schedules one clean redraw on
-             * the next frame. */
-            ss_disable_interrupts();
-            if (memcmp(w->content[i], current, sizeof(current)) == 0)
-                memcpy(w->content_prev[i], current, sizeof(current));
-            ss_enable_interrupts();
+            current[first + len] = end;
         }
     }
     return changed;
 }
 
+static int top_z(void) {
+    uint16_t top = ss_win_top();
+    return top != 0 ? ss_win_get_z(top) : -1;
+}
+
 /* Recompose the desktop in z-order.  Dragging temporarily hides the moved
  * window; rebuilding from the background avoids copying a stale composite
  * bitmap from the old position into the new position. */
 static void redraw_desktop(void) {
-    int order[3];
-    int n = 0;
-
     ss_gfx_fill_stipple(0, 0, ss_current_mode->display_w,
                         ss_current_mode->display_h, C_WHITE, C_GRAY_M);
 
-    highest_active_z = -1;
-    for (int i = 0; i < 3; i++) {
-        SSWindow* w = ss_win_get_ptr(win_ids[i]);
-        if ((w->flags & SS_WIN_VISIBLE) && w->z > highest_active_z)
-            highest_active_z = w->z;
-        int j = n;
-        while (j > 0 && ss_win_get_z(win_ids[order[j - 1]]) > w->z) {
-            order[j] = order[j - 1];
-            j--;
-        }
-        order[j] = i;
-        n++;
-    }
-
-    for (int k = 0; k < n; k++) {
-        SSWindow* w = ss_win_get_ptr(win_ids[order[k]]);
-        if (!(w->flags & SS_WIN_VISIBLE)) continue;
+    highest_active_z = top_z();
+    for (uint16_t id = ss_win_bottom(); id != 0; id = ss_win_above(id)) {
+        SSWindow* w = ss_win_get_ptr(id);
         draw_frame(w, w->z == highest_active_z, NULL);
-        memset(w->content_prev, 0xFF, sizeof(w->content_prev));
+        if (w->text != NULL) ss_tgrid_mark_all(&w->text->content);
         draw_content_dirty(w);
     }
 }
 
 /* Paint only one region. Content is snapshotted per line so a preempting
- * data task cannot make content_prev acknowledge a mixed value. */
+ * data task cannot have a mixed value acknowledged as drawn. */
 static void draw_content_region(SSWindow* w, const SSGfxRect* clip) {
     int x = w->x + 4;
-    int line_w = (LINE_LEN - 1) * SS_FONT_ADV + SS_FONT_W;
+    int line_w = LINE_LEN * SS_FONT_ADV;
+    SSWinText* t = w->text;
+    if (t == NULL) return;
 
-    for (int i = 0; i < 3; i++) {
-        char current[30];
+    for (int i = 0; i < SS_TGRID_ROWS; i++) {
+        char current[SS_TGRID_COLS + 1];
         int y = w->y + CONTENT_Y + i * LINE_H;
 
         /* Avoid copying and clipping every glyph when this line cannot
@@ -283,19 +254,17 @@ static void draw_content_region(SSWindow* w, const SSGfxRect* clip) {
             y >= clip->y + clip->h || y + SS_FONT_H <= clip->y)
             continue;
 
-        ss_disable_interrupts();
-        memcpy(current, w->content[i], sizeof(current));
-        ss_enable_interrupts();
-
-        ss_gfx_draw_text_region(x, y, current, C_BLACK, C_WHITE, clip);
-
+        /* A line drawn in full is up to date: its changed cells are taken
+         * with the snapshot. */
         int fully_clipped = x >= clip->x && y >= clip->y &&
                             x + line_w <= clip->x + clip->w &&
                             y + SS_FONT_H <= clip->y + clip->h;
         ss_disable_interrupts();
-        if (fully_clipped && memcmp(w->content[i], current, sizeof(current)) == 0)
-            memcpy(w->content_prev[i], current, sizeof(current));
+        memcpy(current, t->content.cell[i], sizeof(current));
+        if (fully_clipped) ss_tgrid_take(&t->content, i);
         ss_enable_interrupts();
+
+        ss_gfx_draw_text_region(x, y, current, C_BLACK, C_WHITE, clip);
     }
 }
 
@@ -307,29 +276,12 @@ static int rect_overlaps_window(const SSGfxRect* clip, const SSWindow* w) {
 /* Recompose only clip: background first, then overlapping visible windows in
  * ascending z-order so higher windows restore their occlusion naturally. */
 static void redraw_region(SSGfxRect clip) {
-    int order[3];
-    int n = 0;
-
     ss_gfx_fill_stipple(clip.x, clip.y, clip.w, clip.h, C_WHITE, C_GRAY_M);
 
-    highest_active_z = -1;
-    for (int i = 0; i < 3; i++) {
-        SSWindow* w = ss_win_get_ptr(win_ids[i]);
-        if (!(w->flags & SS_WIN_VISIBLE)) continue;
-        if (w->z > highest_active_z) highest_active_z = w->z;
+    highest_active_z = top_z();
+    for (uint16_t id = ss_win_bottom(); id != 0; id = ss_win_above(id)) {
+        SSWindow* w = ss_win_get_ptr(id);
         if (!rect_overlaps_window(&clip, w)) continue;
-
-        int j = n;
-        while (j > 0 && ss_win_get_z(win_ids[order[j - 1]]) > w->z) {
-            order[j] = order[j - 1];
-            j--;
-        }
-        order[j] = i;
-        n++;
-    }
-
-    for (int k = 0; k < n; k++) {
-        SSWindow* w = ss_win_get_ptr(win_ids[order[k]]);
         draw_frame(w, w->z == highest_active_z, &clip);
         draw_content_region(w, &clip);
     }
@@ -341,28 +293,11 @@ static void redraw_region(SSGfxRect clip) {
  * repaint only target and higher overlapping windows in z-order. */
 static void redraw_title_region(const SSWindow* w) {
     SSGfxRect clip = {w->x, w->y, w->w, TITLE_H};
-    int order[3];
-    int n = 0;
-
-    highest_active_z = -1;
-    for (int i = 0; i < 3; i++) {
-        SSWindow* other = ss_win_get_ptr(win_ids[i]);
-        if ((other->flags & SS_WIN_VISIBLE) && other->z > highest_active_z)
-            highest_active_z = other->z;
-        if (!(other->flags & SS_WIN_VISIBLE) || other->z < w->z ||
-            !rect_overlaps_window(&clip, other))
-            continue;
-        int j = n;
-        while (j > 0 && ss_win_get_z(win_ids[order[j - 1]]) > other->z) {
-            order[j] = order[j - 1];
-            j--;
-        }
-        order[j] = i;
-        n++;
-    }
 
-    for (int i = 0; i < n; i++) {
-        SSWindow* other = ss_win_get_ptr(win_ids[order[i]]);
+    highest_active_z = top_z();
+    for (uint16_t id = w->id; id != 0; id = ss_win_above(id)) {
+        SSWindow* other = ss_win_get_ptr(id);
+        if (!rect_overlaps_window(&clip, other)) continue;
         draw_frame(other, other->z == highest_active_z, &clip);
         if (other != w) draw_content_region(other, &clip);
     }
@@ -429,8 +364,76 @@ static int scene_wait_vsync(void* ctx) {
     return 0;
 }
 
+/* Input traces: -record [file] saves the session's input, -replay [file]
+ * feeds a saved one to the scene instead of IOCS and ends with it, so the
+ * runtime SSPERF lines of two builds come from the same session. */
+#define SS_TRACE_FILE     "trace.bin"
+#define SS_TRACE_BUF_SIZE (32 * 1024)
+
+enum { TRACE_OFF, TRACE_RECORD, TRACE_REPLAY };
+static int trace_mode = TRACE_OFF;
+static const char* trace_file = SS_TRACE_FILE;
+static uint8_t* trace_buf;
+static uint32_t trace_len;
+static SSInputTrace scene_trace;
+static SSInputSource trace_source;
+
+static void find_trace_option(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-record") == 0) {
+            trace_mode = TRACE_RECORD;
+        } else if (strcmp(argv[i], "-replay") == 0) {
+            trace_mode = TRACE_REPLAY;
+        } else {
+            continue;
+        }
+        if (i + 1 < argc && argv[i + 1][0] != '-') trace_file = argv[i + 1];
+        return;
+    }
+}
+
+/* Take the trace buffer and, for a replay, read the file into it while
+ * the text console is still up.  Returns 0 when the trace is unusable. */
+static int trace_load(void) {
+    trace_buf = ss_alloc(SS_TRACE_BUF_SIZE);
+    if (trace_buf == NULL) return 0;
+    if (trace_mode == TRACE_RECORD) return 1;
+    FILE* f = fopen(trace_file, "rb");
+    if (f == NULL) return 0;
+    trace_len = (uint32_t)fread(trace_buf, 1, SS_TRACE_BUF_SIZE, f);
+    fclose(f);
+    return ss_trace_open(&scene_trace, trace_buf, trace_len) == SS_OK;
+}
+
+/* Start recording or replaying right before the scene's first frame. */
+static const SSInputSource* trace_begin(void) {
+    if (trace_mode == TRACE_RECORD) {
+        ss_trace_record(&scene_trace, trace_buf, SS_TRACE_BUF_SIZE);
+    } else if (trace_mode == TRACE_REPLAY) {
+        ss_trace_open(&scene_trace, trace_buf, trace_len);
+        trace_source = ss_trace_source(&scene_trace);
+        return &trace_source;
+    }
+    return NULL;
+}
+
+static void trace_save(void) {
+    char buf[96];
+    FILE* f = fopen(trace_file, "wb");
+    if (f == NULL || fwrite(trace_buf, 1, scene_trace.len, f) != scene_trace.len) {
+        snprintf(buf, sizeof(buf), "SSPERF trace=write-failed name=%s\r\n", trace_file);
+    } else {
+        snprintf(buf, sizeof(buf), "SSPERF trace=%s events=%lu bytes=%lu overflow=%d\r\n",
+                 trace_file, (unsigned long)scene_trace.events,
+                 (unsigned long)scene_trace.len, scene_trace.overflow);
+    }
+    if (f != NULL) fclose(f);
+    _iocs_b_print(buf);
+}
+
 static int scene_should_stop(void* ctx) {
     (void)ctx;
+    if (trace_mode == TRACE_REPLAY && ss_trace_done(&scene_trace)) return 1;
     return (ss_scene_last_key() & 0xFF) == 0x1B;
 }
 
@@ -452,6 +455,9 @@ static int scene_should_stop(void* ctx) {
 #define SS_BENCH_DRAG_Y0        120
 #define SS_BENCH_DRAG_X1        128
 #define SS_BENCH_DRAG_Y1        96
+#define SS_BENCH_OPAQUE_DX      8
+#define SS_BENCH_OPAQUE_DY      4
+#define SS_BENCH_PHASE_MAX      8
 
 static int parse_bench_rounds(const char* text, uint32_t* rounds) {
     uint32_t value = 0;
@@ -489,7 +495,7 @@ typedef struct {
     SSGfxProfile profile;
 } SSBenchResult;
 
-static SSBenchResult bench_results[6];
+static SSBenchResult bench_results[SS_BENCH_PHASE_MAX];
 static uint32_t bench_result_count;
 static const SSGfxMode* bench_mode;
 static FILE* bench_log_file;
@@ -501,13 +507,25 @@ static void bench_print_line(const char* line) {
     }
 }
 
+/* Idle frames the scene skipped versus frames it rendered. */
+static void print_scene_stats(const SSSceneStats* s) {
+    char buf[96];
+    snprintf(buf, sizeof(buf), "SSPERF scene rendered=%lu skipped=%lu\r\n",
+             (unsigned long)s->rendered, (unsigned long)s->skipped);
+    bench_print_line(buf);
+}
+
 static void print_bench_profile(const char* phase, uint32_t rounds,
                                 uint32_t vsyncs, const SSGfxMode* mode,
                                 const SSGfxProfile* p) {
     char buf[256];
 
-    snprintf(buf, sizeof(buf), "SSPERF phase=%s rounds=%lu vsync=%lu\r\n",
-             phase, (unsigned long)rounds, (unsigned long)vsyncs);
+    uint32_t per_round = rounds != 0 ? vsyncs * 100U / rounds : 0;
+
+    snprintf(buf, sizeof(buf),
+             "SSPERF phase=%s rounds=%lu vsync=%lu per_round=%lu.%02lu\r\n",
+             phase, (unsigned long)rounds, (unsigned long)vsyncs,
+             (unsigned long)(per_round / 100U), (unsigned long)(per_round % 100U));
     bench_print_line(buf);
     snprintf(buf, sizeof(buf),
              "SSPERF mode crtmod=%d display=%dx%d color=%d pages=%d\r\n",
@@ -515,15 +533,18 @@ static void print_bench_profile(const char* phase, uint32_t rounds,
              mode->color_count, mode->page_count);
     bench_print_line(buf);
     snprintf(buf, sizeof(buf),
-             "SSPERF calls primitive=%lu rect=%lu hline=%lu stipple=%lu xor=%lu\r\n",
+             "SSPERF calls primitive=%lu rect=%lu batch=%lu merged=%lu hline=%lu stipple=%lu xor=%lu\r\n",
              (unsigned long)p->primitive_calls, (unsigned long)p->rect_calls,
+             (unsigned long)p->rect_batch_calls, (unsigned long)p->rect_batch_merges,
              (unsigned long)p->hline_calls, (unsigned long)p->stipple_calls,
              (unsigned long)p->xor_rect_calls);
     bench_print_line(buf);
     snprintf(buf, sizeof(buf),
-             "SSPERF glyph slow=%lu fast=%lu clip=%lu text=%lu\r\n",
+             "SSPERF glyph slow=%lu fast=%lu clip=%lu text=%lu stores=%lu table=%lu\r\n",
              (unsigned long)p->glyph_slow, (unsigned long)p->glyph_fast,
-             (unsigned long)p->glyph_clip, (unsigned long)p->text_calls);
+             (unsigned long)p->glyph_clip, (unsigned long)p->text_calls,
+             (unsigned long)p->glyph_stores,
+             (unsigned long)p->glyph_table_builds);
     bench_print_line(buf);
     snprintf(buf, sizeof(buf),
              "SSPERF gvram read=%lu write=%lu area=%lu clipped=%lu\r\n",
@@ -532,6 +553,18 @@ static void print_bench_profile(const char* phase, uint32_t rounds,
              (unsigned long)p->submitted_area,
              (unsigned long)p->clipped_area);
     bench_print_line(buf);
+    /* Overlay words go to text VRAM; compare them with the gvram line of
+     * xor-move, which draws the same outlines. */
+    snprintf(buf, sizeof(buf),
+             "SSPERF overlay calls=%lu read=%lu write=%lu\r\n",
+             (unsigned long)p->overlay_calls,
+             (unsigned long)p->overlay_words_read,
+             (unsigned long)p->overlay_words_written);
+    bench_print_line(buf);
+    snprintf(buf, sizeof(buf), "SSPERF dlist replayed=%lu skipped=%lu\r\n",
+             (unsigned long)p->dl_nodes_replayed,
+             (unsigned long)p->dl_nodes_skipped);
+    bench_print_line(buf);
     snprintf(buf, sizeof(buf),
              "SSPERF dma attempts=%lu ok=%lu error=%lu timeout=%lu fallback_rows=%lu status_samples=%lu csr=%02X cer=%02X config_samples=%lu dcr=%02X ocr=%02X scr=%02X mfc=%02X dfc=%02X bfc=%02X\r\n",
              (unsigned long)p->dma_attempts, (unsigned long)p->dma_ok,
@@ -558,10 +591,13 @@ static void print_bench_profile(const char* phase, uint32_t rounds,
              (unsigned long)p->windows_skipped_occluded);
     bench_print_line(buf);
     snprintf(buf, sizeof(buf),
-             "SSPERF dirty marks=%lu submitted=%lu clipped=%lu\r\n",
+             "SSPERF dirty marks=%lu submitted=%lu clipped=%lu damage=%lu merges=%lu flushes=%lu\r\n",
              (unsigned long)p->dirty_marks,
              (unsigned long)p->dirty_area_submitted,
-             (unsigned long)p->dirty_area_clipped);
+             (unsigned long)p->dirty_area_clipped,
+             (unsigned long)p->damage_rects,
+             (unsigned long)p->damage_merges,
+             (unsigned long)p->damage_flushes);
     bench_print_line(buf);
     snprintf(buf, sizeof(buf), "SSPERF drag save_words=%lu restore_words=%lu\r\n",
              (unsigned long)p->drag_save_words,
@@ -609,6 +645,21 @@ static void bench_xor_outline(uint32_t rounds) {
     ss_gfx_xor_rect(x, SS_BENCH_OUTLINE_Y, WIN_W, WIN_H);
 }
 
+/* The xor-move outline sequence drawn on the text VRAM overlay: erase is a
+ * clear of the old frame instead of a second XOR pass over GVRAM. */
+static void bench_overlay_outline(uint32_t rounds) {
+    int x = SS_BENCH_OUTLINE_X0;
+
+    ss_overlay_frame(x, SS_BENCH_OUTLINE_Y, WIN_W, WIN_H, 1);
+    for (uint32_t i = 0; i < rounds; i++) {
+        ss_overlay_frame(x, SS_BENCH_OUTLINE_Y, WIN_W, WIN_H, 0);
+        x = (x == SS_BENCH_OUTLINE_X0) ? SS_BENCH_OUTLINE_X1
+                                        : SS_BENCH_OUTLINE_X0;
+        ss_overlay_frame(x, SS_BENCH_OUTLINE_Y, WIN_W, WIN_H, 1);
+    }
+    ss_overlay_frame(x, SS_BENCH_OUTLINE_Y, WIN_W, WIN_H, 0);
+}
+
 static void bench_text_update(uint32_t rounds) {
     static const char text_a[] = "Vsync: 00000000             ";
     static const char text_b[] = "Vsync: 11111111             ";
@@ -620,6 +671,7 @@ static void bench_text_update(uint32_t rounds) {
 }
 
 static SSWindow bench_drag_saved[3];
+static SSWinText bench_drag_saved_text[3];
 static int bench_drag_saved_highest_active_z;
 
 /* Set up a fixed scene outside the profile interval. */
@@ -627,15 +679,20 @@ static void bench_drag_region_prepare(void) {
     SSWindow* dragged = ss_win_get_ptr(win_ids[2]);
 
     ss_disable_interrupts();
-    for (int i = 0; i < 3; i++)
-        memcpy(&bench_drag_saved[i], ss_win_get_ptr(win_ids[i]),
-               sizeof(bench_drag_saved[i]));
+    for (int i = 0; i < 3; i++) {
+        SSWindow* w = ss_win_get_ptr(win_ids[i]);
+        memcpy(&bench_drag_saved[i], w, sizeof(bench_drag_saved[i]));
+        if (w->text != NULL)
+            memcpy(&bench_drag_saved_text[i], w->text, sizeof(bench_drag_saved_text[i]));
+    }
     bench_drag_saved_highest_active_z = highest_active_z;
     ss_enable_interrupts();
 
     ss_win_move(dragged->id, SS_BENCH_DRAG_X0, SS_BENCH_DRAG_Y0);
     ss_win_show(dragged->id);
     ss_win_set_z(dragged->id, 4);
+    /* Drop the window layer's queued damage so no phase pays for it. */
+    ss_win_flush_damage();
     redraw_desktop();
 }
 
@@ -665,21 +722,52 @@ static void bench_drag_region(uint32_t rounds) {
 
 }
 
-/* Restore outside the profile interval.  redraw_desktop updates content_prev,
- * so copy the exact model one final time after repainting. */
-static void bench_drag_region_restore(void) {
+/* One opaque drag step per round: the raised window is blitted by a small
+ * offset and only the uncovered strip is recomposited, as the UI does
+ * while the drag stays inside its budget.  vsync per round is the cost of
+ * one move. */
+static void bench_opaque_move(uint32_t rounds) {
+    SSWindow* dragged = ss_win_get_ptr(win_ids[2]);
+
+    for (uint32_t i = 0; i < rounds; i++) {
+        int step = (i & 1U) ? 0 : 1;
+        ss_win_move(dragged->id, SS_BENCH_DRAG_X0 + step * SS_BENCH_OPAQUE_DX,
+                    SS_BENCH_DRAG_Y0 + step * SS_BENCH_OPAQUE_DY);
+        ss_win_flush_damage();
+    }
+    if (rounds & 1U) {
+        ss_win_move(dragged->id, SS_BENCH_DRAG_X0, SS_BENCH_DRAG_Y0);
+        ss_win_flush_damage();
+    }
+}
+
+static void bench_drag_restore_text(void) {
     ss_disable_interrupts();
-    for (int i = 0; i < 3; i++)
-        memcpy(ss_win_get_ptr(win_ids[i]), &bench_drag_saved[i],
-               sizeof(bench_drag_saved[i]));
+    for (int i = 0; i < 3; i++) {
+        SSWindow* w = ss_win_get_ptr(win_ids[i]);
+        if (w->text != NULL)
+            memcpy(w->text, &bench_drag_saved_text[i], sizeof(bench_drag_saved_text[i]));
+    }
     ss_enable_interrupts();
+}
+
+/* Restore outside the profile interval.  Geometry, visibility and z go back
+ * through the window API so its z-order list and index follow.
+ * redraw_desktop takes the changed-cell bits, so copy the exact text one
+ * final time after repainting. */
+static void bench_drag_region_restore(void) {
+    for (int i = 0; i < 3; i++) {
+        const SSWindow* saved = &bench_drag_saved[i];
+        ss_win_move(win_ids[i], saved->x, saved->y);
+        if (saved->flags & SS_WIN_VISIBLE) ss_win_show(win_ids[i]);
+        else ss_win_hide(win_ids[i]);
+        ss_win_set_z(win_ids[i], saved->z);
+    }
+    ss_win_flush_damage();
+    bench_drag_restore_text();
     redraw_desktop();
-    ss_disable_interrupts();
-    for (int i = 0; i < 3; i++)
-        memcpy(ss_win_get_ptr(win_ids[i]), &bench_drag_saved[i],
-               sizeof(bench_drag_saved[i]));
+    bench_drag_restore_text();
     highest_active_z = bench_drag_saved_highest_active_z;
-    ss_enable_interrupts();
 }
 
 typedef void (*SSBenchPhase)(uint32_t rounds);
@@ -689,7 +777,7 @@ static void run_bench_phase(const char* name, uint32_t rounds,
     SSBenchResult* result;
     uint32_t start_vsync;
 
-    if (bench_result_count >= 6) return;
+    if (bench_result_count >= SS_BENCH_PHASE_MAX) return;
     result = &bench_results[bench_result_count++];
     strncpy(result->phase, name, sizeof(result->phase) - 1);
     result->phase[sizeof(result->phase) - 1] = '\0';
@@ -711,7 +799,13 @@ static void run_benchmark(uint32_t rounds) {
     bench_drag_region_prepare();
     run_bench_phase("drag-region", rounds, bench_drag_region);
     bench_drag_region_restore();
+    bench_drag_region_prepare();
+    run_bench_phase("opaque-move", rounds, bench_opaque_move);
+    bench_drag_region_restore();
     run_bench_phase("xor-move", rounds, bench_xor_outline);
+    ss_overlay_init();
+    run_bench_phase("overlay-move", rounds, bench_overlay_outline);
+    ss_overlay_shutdown();
 }
 
 static void print_bench_results(void) {
@@ -735,6 +829,7 @@ int main(int argc, char** argv) {
     uint32_t bench_rounds;
     int run_bench = find_bench_option(argc, argv, &bench_rounds);
 #endif
+    find_trace_option(argc, argv);
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-8") == 0) {
             requested_mode = SS_CRTMOD_8;
@@ -762,6 +857,10 @@ int main(int argc, char** argv) {
 
     ss_mem_init(local_memory, sizeof(local_memory));
     ss_sched_init();
+    if (trace_mode != TRACE_OFF && !trace_load()) {
+        _iocs_b_print("SSPERF trace=open-failed\r\n");
+        trace_mode = TRACE_OFF;
+    }
 
     if (ss_main_task_register(&main_tcb, 8) != SS_OK) _exit(1);
 
@@ -773,6 +872,9 @@ int main(int argc, char** argv) {
     _iocs_skeyset(0);
 
     ss_gfx_init();
+    /* The window table lives on the heap, as in the .xdf. */
+    ss_win_set_storage(ss_alloc(SS_WIN_STORAGE_SIZE(SS_MAX_WINDOWS)),
+                       SS_WIN_STORAGE_SIZE(SS_MAX_WINDOWS));
     ss_win_init();
 
     {
@@ -820,7 +922,9 @@ int main(int argc, char** argv) {
         .should_stop = scene_should_stop,
         .ctx = NULL,
     };
+    scene_hooks.input = trace_begin();
     ss_scene_run(&scene_hooks, &runtime_stats);
+    ss_trace_stop();
 
 cleanup:
     if (ss_trapbuf_flag != 0) {
@@ -850,6 +954,8 @@ cleanup:
     _iocs_crtmod(old_mode);
     _iocs_b_curon();
 
+    if (trace_mode == TRACE_RECORD) trace_save();
+
 #if SS_PROFILE_GFX
     /* CRTMOD restoration clears the graphics page.  Emit retained benchmark
      * records only after returning to the text console so the user can read
@@ -874,6 +980,7 @@ cleanup:
         print_bench_profile("runtime", runtime_stats.frames,
                             runtime_stats.vsyncs,
                             ss_current_mode, &runtime_profile);
+        print_scene_stats(&runtime_stats);
         if (bench_log_file != NULL) {
             fclose(bench_log_file);
             bench_log_file = NULL;
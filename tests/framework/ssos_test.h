@@ -15,6 +15,10 @@ extern const char* current_test_name;
 // Reset all stub/simulated HW state before a test (defined in test_mocks.c)
 void reset_test_state(void);
 
+// Sprite controller stub (test_mocks.c): SP_INIT result and display state
+extern int ss_test_sprite_init_result;
+extern int ss_test_sprite_display_on;
+
 // Test definition macros
 #define TEST(name) \
     void test_##name(void); \
@@ -12,22 +12,29 @@
  *   - ss_task_stack_base        (real: app-provided)        -> static arena
  *   - ss_wakeups_needed (coop.) (real: set by ISR)          -> host-controlled var
  *   - graphics MMIO             (real: VRAM/CRTC/DMAC)      -> RAM seam in vram.c
+ *   - sprite controller setup   (real: IOCS in sprite.c)    -> host-controlled result
+ *
+ * IOCS calls made by the sources themselves (scene input, palette) are
+ * faked one level down, in host/fake_iocs.c.
  */
 
 #include "ssos_test.h"
 #include "kernel.h"
 #include "scheduler.h"
 #include "gfx.h"
-#include "palette.h"
+#include "cursor.h"
 
 #include <stdint.h>
 
 /* ---- 1. Interrupt enable/disable -------------------------------------- */
-/* Real: move.w #0x2700/%sr (disable) / #0x2000/%sr (enable). The scheduler
- * uses these only to guard queue critical sections; no-op is correct because
- * the test is single-threaded. */
+/* Real: move.w #0x2700/%sr (disable) / #0x2000/%sr (enable), and the
+ * ss_irq_save/restore pair that puts the caller's SR back. They only guard
+ * queue critical sections; no-op is correct because the test is
+ * single-threaded. */
 void ss_disable_interrupts(void) { }
 void ss_enable_interrupts(void)  { }
+uint16_t ss_irq_save(void)       { return 0x2000; }
+void ss_irq_restore(uint16_t sr) { (void)sr; }
 
 /* ---- 2. Tick/vsync counters (defined in interrupts.s on real HW) ------ */
 volatile uint32_t ss_tick_counter      = 0;
@@ -54,13 +61,21 @@ uint8_t* ss_task_stack_base = test_stack_mem;
 volatile uint8_t ss_wakeups_needed = 0;
 #endif
 
-/* Palette programming is hardware-only.  Window tests require only the
- * logical 16-color indices used by the shared compositor. */
-uint16_t ss_palette_index(SSPalette color) {
-    static const uint16_t indices[] = {0, 7, 8, 15};
-    return indices[color];
+/* ---- 6. Sprite controller (IOCS SP_INIT/SP_ON/SP_OFF on real HW) ------ */
+/* The registers themselves are RAM in cursor.c; only the IOCS setup calls
+ * are replaced.  Tests choose whether SP_INIT succeeds and observe whether
+ * the display was left on. */
+int ss_test_sprite_init_result = 0;
+int ss_test_sprite_display_on = 0;
+
+int ss_sprite_hw_begin(void) {
+    ss_test_sprite_display_on = 0;
+    return ss_test_sprite_init_result;
 }
 
+void ss_sprite_hw_on(void)  { ss_test_sprite_display_on = 1; }
+void ss_sprite_hw_off(void) { ss_test_sprite_display_on = 0; }
+
 /* ---- 7. Reset --------------------------------------------------------- */
 void reset_test_state(void) {
     ss_tick_counter = 0;
@@ -70,6 +85,8 @@ void reset_test_state(void) {
 #ifdef SS_BUILD_COOPERATIVE
     ss_wakeups_needed = 0;
 #endif
+    ss_test_sprite_init_result = 0;
+    ss_test_sprite_display_on = 0;
     /* scheduler/window static state is reset by ss_sched_init()/ss_win_init()
      * at the start of each test that touches them. */
 }
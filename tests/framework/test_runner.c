@@ -11,9 +11,18 @@ void run_numfmt_tests(void);
 void run_mem_tests(void);
 void run_scheduler_tests(void);
 void run_work_queue_tests(void);
+void run_input_tests(void);
 void run_window_tests(void);
 void run_ipc_tests(void);
 void run_gfx_tests(void);
+void run_region_tests(void);
+void run_cursor_tests(void);
+void run_overlay_tests(void);
+void run_dlist_tests(void);
+void run_console_tests(void);
+void run_textgrid_tests(void);
+void run_compositor_tests(void);
+void run_scene_replay_tests(void);
 
 /* Global statistics, referenced by the ASSERT_* macros in ssos_test.h */
 int total_tests = 0;
@@ -41,9 +50,18 @@ int main(void) {
     run_mem_tests();
     run_scheduler_tests();
     run_work_queue_tests();
+    run_input_tests();
     run_window_tests();
     run_ipc_tests();
     run_gfx_tests();
+    run_region_tests();
+    run_cursor_tests();
+    run_overlay_tests();
+    run_dlist_tests();
+    run_console_tests();
+    run_textgrid_tests();
+    run_compositor_tests();
+    run_scene_replay_tests();
 
     test_framework_report();
     return test_framework_exit_code();
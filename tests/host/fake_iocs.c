@@ -0,0 +1,71 @@
+/* fake_iocs.c - IOCS calls of host builds, over scriptable state. */
+
+#include "fake_iocs.h"
+#include "input.h"
+#include "input_iocs.h"
+#include <x68k/iocs.h>
+#include <string.h>
+
+uint16_t ss_fake_palette[256];
+
+static int mouse_x, mouse_y, mouse_buttons;
+static uint16_t keys[SS_FAKE_KEY_QUEUE];
+static int key_head, key_count;
+/* ss_input_irq_attach(): the receive interrupts run the chained handler. */
+static int irq_chained;
+
+void ss_fake_iocs_reset(void) {
+    memset(ss_fake_palette, 0, sizeof(ss_fake_palette));
+    mouse_x = mouse_y = mouse_buttons = 0;
+    key_head = key_count = 0;
+}
+
+void ss_fake_mouse(int x, int y, int buttons) {
+    mouse_x = x;
+    mouse_y = y;
+    mouse_buttons = buttons;
+    if (irq_chained) ss_input_iocs_mouse();
+}
+
+void ss_fake_key(uint16_t code) {
+    if (key_count == SS_FAKE_KEY_QUEUE) return;
+    keys[(key_head + key_count) % SS_FAKE_KEY_QUEUE] = code;
+    key_count++;
+    if (irq_chained) ss_input_iocs_key();
+}
+
+void ss_input_irq_attach(void) {
+    irq_chained = 1;
+}
+
+void ss_input_irq_detach(void) {
+    irq_chained = 0;
+}
+
+int _iocs_ms_curgt(void) {
+    return (int)(((uint32_t)(mouse_x & 0xFFFF) << 16) | (uint32_t)(mouse_y & 0xFFFF));
+}
+
+int _iocs_ms_getdt(void) {
+    return ((mouse_buttons & SS_INPUT_LEFT) ? 0x0200 : 0) |
+           ((mouse_buttons & SS_INPUT_RIGHT) ? 0x0001 : 0);
+}
+
+int _iocs_b_keysns(void) {
+    return key_count;
+}
+
+int _iocs_b_keyinp(void) {
+    if (key_count == 0) return 0;
+    uint16_t code = keys[key_head];
+    key_head = (key_head + 1) % SS_FAKE_KEY_QUEUE;
+    key_count--;
+    return code;
+}
+
+int _iocs_gpalet(int index, int color) {
+    if (index < 0 || index > 255) return -1;
+    uint16_t old = ss_fake_palette[index];
+    if (color >= 0) ss_fake_palette[index] = (uint16_t)color;
+    return old;
+}
@@ -0,0 +1,26 @@
+/* fake_iocs.h - scriptable IOCS mouse, keyboard and palette for host runs.
+ *
+ * The real code paths (the IOCS input producer, palette programming)
+ * run unchanged against this state: a test or the host scene driver
+ * moves the mouse and types, and reads back the palette a snapshot
+ * needs.  While the producer is attached, each move and key also runs
+ * its receive-interrupt handler, as the chained vectors do on the
+ * X68000. */
+
+#ifndef SS_FAKE_IOCS_H
+#define SS_FAKE_IOCS_H
+
+#include <stdint.h>
+
+#define SS_FAKE_KEY_QUEUE 16
+
+extern uint16_t ss_fake_palette[256];
+
+void ss_fake_iocs_reset(void);
+/* Pointer state MS_CURGT / MS_GETDT report from now on; buttons are
+ * SS_INPUT_LEFT / SS_INPUT_RIGHT bits. */
+void ss_fake_mouse(int x, int y, int buttons);
+/* Queue a key for B_KEYSNS / B_KEYINP; dropped when the queue is full. */
+void ss_fake_key(uint16_t code);
+
+#endif /* SS_FAKE_IOCS_H */
@@ -0,0 +1,228 @@
+/* scene_host.c - the full scene, headless, for compositor perf work.
+ *
+ * Runs the shared ss_scene_run() against the RAM framebuffer with faked
+ * IOCS mouse and keyboard and a fake vsync: every frame the driver
+ * advances the vsync counter, applies the input script for that vsync
+ * through the fake IOCS, and reads the GVRAM counters the frame before
+ * left.  Frames that touched GVRAM are reported one SSPERF line each;
+ * the totals follow at the end, and the displayed page is written out as
+ * PPM snapshots.
+ *
+ *   scene_host [-8|-16] [-frames N] [-snap N] [-out DIR] [-replay FILE]
+ *
+ *   -frames N     stop after N frames (default 240)
+ *   -snap N       also snapshot every N frames (default: last frame only)
+ *   -out DIR      snapshot directory (default .)
+ *   -replay FILE  feed an input trace (standalone -record) instead of the
+ *                 built-in script; stops at its end
+ */
+
+#include "kernel.h"
+#include "gfx.h"
+#include "palette.h"
+#include "profile.h"
+#include "win.h"
+#include "scene.h"
+#include "input.h"
+#include "input_trace.h"
+#include "fake_iocs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_FRAMES 240
+#define TRACE_MAX      (64 * 1024)
+
+/* Built-in session on the default layout: grab the Mouse window's title,
+ * drag it in steps, drop it, then type.  Each step holds from its vsync
+ * until the next one's. */
+typedef struct {
+    uint32_t vsync;
+    int x, y, buttons;
+    uint16_t key;               /* queued on that vsync, 0 = none */
+} ScriptStep;
+
+static const ScriptStep script[] = {
+    {  10, 100, 125, 0, 0 },
+    {  12, 100, 125, SS_INPUT_LEFT, 0 },
+    {  14, 120, 130, SS_INPUT_LEFT, 0 },
+    {  16, 150, 140, SS_INPUT_LEFT, 0 },
+    {  18, 190, 160, SS_INPUT_LEFT, 0 },
+    {  20, 230, 190, SS_INPUT_LEFT, 0 },
+    {  22, 230, 190, 0, 0 },
+    {  40, 60, 30, SS_INPUT_LEFT, 0 },      /* raise Timer */
+    {  42, 60, 30, 0, 0 },
+    {  70, 60, 30, 0, 0x1E61 },             /* 'a' */
+    {  90, 60, 30, 0, 0x3062 },             /* 'b' */
+};
+
+typedef struct {
+    uint32_t frames;            /* -frames */
+    uint32_t snap_every;        /* -snap, 0 = last frame only */
+    const char* out_dir;
+    const char* replay;
+    uint32_t frame;             /* frames started so far */
+    size_t next_step;
+    SSInputTrace trace;
+    SSInputSource trace_src;
+    SSGfxProfile last;          /* counters at the previous frame */
+    uint32_t busy_frames;
+} HostRun;
+
+static void write_ppm(const HostRun* run, const char* name) {
+    char path[512];
+    int w = ss_current_mode->display_w, h = ss_current_mode->display_h;
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    uint16_t mask = (uint16_t)(ss_current_mode->color_count - 1);
+    snprintf(path, sizeof(path), "%s/%s", run->out_dir, name);
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        printf("SSPERF file=open-failed name=%s\n", path);
+        return;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            /* Palette entries are GRB 5-5-5 plus an intensity bit. */
+            uint16_t c = ss_fake_palette[ss_display_page[(uint32_t)y * stride + (uint32_t)x] & mask];
+            int g = (c >> 11) & 0x1F, r = (c >> 6) & 0x1F, b = (c >> 1) & 0x1F;
+            fputc((r << 3) | (r >> 2), f);
+            fputc((g << 3) | (g >> 2), f);
+            fputc((b << 3) | (b >> 2), f);
+        }
+    }
+    fclose(f);
+    printf("SSPERF file=%s\n", path);
+}
+
+/* GVRAM work of the frame that just ended, relative to the last sample. */
+static void report_frame(HostRun* run) {
+    SSGfxProfile now;
+    ss_gfx_profile_snapshot(&now);
+    uint32_t rd = now.gvram_words_read - run->last.gvram_words_read;
+    uint32_t wr = now.gvram_words_written - run->last.gvram_words_written;
+    uint32_t text = now.text_calls - run->last.text_calls;
+    uint32_t wins = now.windows_rendered - run->last.windows_rendered;
+    if (rd != 0 || wr != 0 || text != 0) {
+        printf("SSPERF frame=%lu gvram read=%lu write=%lu text=%lu windows=%lu\n",
+               (unsigned long)run->frame, (unsigned long)rd, (unsigned long)wr,
+               (unsigned long)text, (unsigned long)wins);
+        run->busy_frames++;
+    }
+    run->last = now;
+}
+
+/* Fake vsync: the scene's frame begins here. */
+static int host_wait_vsync(void* ctx) {
+    HostRun* run = ctx;
+    char name[32];
+    if (run->frame > 0) {
+        report_frame(run);
+        if (run->snap_every != 0 && run->frame % run->snap_every == 0) {
+            snprintf(name, sizeof(name), "frame_%05lu.ppm", (unsigned long)run->frame);
+            write_ppm(run, name);
+        }
+    }
+    ss_vsync_counter++;
+    ss_vdisp_fire_count++;
+    run->frame++;
+    while (run->replay == NULL && run->next_step < sizeof(script) / sizeof(script[0]) &&
+           script[run->next_step].vsync <= run->frame) {
+        const ScriptStep* s = &script[run->next_step++];
+        ss_fake_mouse(s->x, s->y, s->buttons);
+        if (s->key != 0) ss_fake_key(s->key);
+    }
+    return 0;
+}
+
+static int host_should_stop(void* ctx) {
+    HostRun* run = ctx;
+    if (run->replay != NULL && ss_trace_done(&run->trace)) return 1;
+    return run->frame > run->frames;
+}
+
+static uint8_t* load_trace(const char* file, uint32_t* len) {
+    uint8_t* buf = malloc(TRACE_MAX);
+    FILE* f = fopen(file, "rb");
+    if (buf == NULL || f == NULL) {
+        free(buf);
+        if (f != NULL) fclose(f);
+        return NULL;
+    }
+    *len = (uint32_t)fread(buf, 1, TRACE_MAX, f);
+    fclose(f);
+    return buf;
+}
+
+int main(int argc, char** argv) {
+    HostRun run;
+    int mode = SS_CRTMOD_16;
+    uint8_t* trace_buf = NULL;
+    uint32_t trace_len = 0;
+
+    memset(&run, 0, sizeof(run));
+    run.frames = DEFAULT_FRAMES;
+    run.out_dir = ".";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-8") == 0) {
+            mode = SS_CRTMOD_8;
+        } else if (strcmp(argv[i], "-16") == 0) {
+            mode = SS_CRTMOD_16;
+        } else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc) {
+            run.frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-snap") == 0 && i + 1 < argc) {
+            run.snap_every = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-out") == 0 && i + 1 < argc) {
+            run.out_dir = argv[++i];
+        } else if (strcmp(argv[i], "-replay") == 0 && i + 1 < argc) {
+            run.replay = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [-8|-16] [-frames N] [-snap N] [-out DIR] [-replay FILE]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    ss_fake_iocs_reset();
+    ss_gfx_set_mode(mode);
+    ss_palette_program_default();
+    ss_gfx_init();
+    ss_win_init();
+
+    SSSceneHooks hooks = { host_wait_vsync, host_should_stop, &run, NULL };
+    if (run.replay != NULL) {
+        trace_buf = load_trace(run.replay, &trace_len);
+        if (trace_buf == NULL || ss_trace_open(&run.trace, trace_buf, trace_len) != SS_OK) {
+            printf("SSPERF trace=open-failed name=%s\n", run.replay);
+            free(trace_buf);
+            return 1;
+        }
+        run.trace_src = ss_trace_source(&run.trace);
+        hooks.input = &run.trace_src;
+    }
+
+    SSSceneStats stats;
+    ss_gfx_profile_reset();
+    ss_scene_run(&hooks, &stats);
+    report_frame(&run);
+
+    SSGfxProfile p;
+    ss_gfx_profile_snapshot(&p);
+    printf("SSPERF phase=host frames=%lu vsync=%lu busy=%lu\n",
+           (unsigned long)stats.frames, (unsigned long)stats.vsyncs,
+           (unsigned long)run.busy_frames);
+    printf("SSPERF scene rendered=%lu skipped=%lu\n",
+           (unsigned long)stats.rendered, (unsigned long)stats.skipped);
+    printf("SSPERF gvram read=%lu write=%lu area=%lu clipped=%lu\n",
+           (unsigned long)p.gvram_words_read, (unsigned long)p.gvram_words_written,
+           (unsigned long)p.submitted_area, (unsigned long)p.clipped_area);
+    printf("SSPERF calls primitive=%lu rect=%lu batch=%lu text=%lu\n",
+           (unsigned long)p.primitive_calls, (unsigned long)p.rect_calls,
+           (unsigned long)p.rect_batch_calls, (unsigned long)p.text_calls);
+    printf("SSPERF windows considered=%lu rendered=%lu\n",
+           (unsigned long)p.windows_considered, (unsigned long)p.windows_rendered);
+    write_ppm(&run, "scene.ppm");
+    free(trace_buf);
+    return 0;
+}
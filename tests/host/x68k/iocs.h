@@ -0,0 +1,16 @@
+/* x68k/iocs.h - host stand-in for the libx68kiocs header.
+ *
+ * Declares only the IOCS calls the host-built sources make; fake_iocs.c
+ * implements them over scriptable state.  A source that starts using
+ * another IOCS call fails to link here, which is the cue to fake it. */
+
+#ifndef SS_HOST_X68K_IOCS_H
+#define SS_HOST_X68K_IOCS_H
+
+int _iocs_ms_curgt(void);               /* X << 16 | Y */
+int _iocs_ms_getdt(void);               /* bit9 = left, bit0 = right */
+int _iocs_b_keysns(void);               /* keys waiting */
+int _iocs_b_keyinp(void);               /* next key: shift << 8 | ascii */
+int _iocs_gpalet(int index, int color); /* GRB 5-5-5 + intensity */
+
+#endif /* SS_HOST_X68K_IOCS_H */
@@ -4,7 +4,7 @@
  * supplies everything it references that isn't the CPU itself:
  *   - the tick/vsync counters (normally bumped by the Timer D / V-DISP ISRs)
  *   - the task stack arena (normally provided by app/main.c)
- *   - memset/memcpy (we build -nostdlib)
+ *   - memset/memcpy/strlen (we build -nostdlib)
  *   - a Goldfish-TTY printer (for test output)
  *
  * The actual context switch lives in ctx_switch.s. */
@@ -40,6 +40,12 @@ void* memcpy(void* dst, const void* src, size_t n) {
     return dst;
 }
 
+size_t strlen(const char* s) {
+    const char* p = s;
+    while (*p) p++;
+    return (size_t)(p - s);
+}
+
 /* ---- Goldfish TTY output (QEMU virt) --------------------------------- */
 #define GOLDFISH_TTY  ((volatile uint32_t*)0xff008000)
 
@@ -0,0 +1,16 @@
+# start.s - QEMU entry for the gfx kernel tests.
+#
+# The kernel tests need no scheduler or interrupts: set a stack, call C
+# main, then park.
+
+        .section .text
+        .align  2
+
+        .globl  _start
+
+_start:
+        move.l  #0x10000, %sp
+        move.w  #0x2700, %sr        | interrupts off
+        bsr     main
+        | main returned — park forever
+1:      bra     1b
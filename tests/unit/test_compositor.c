@@ -0,0 +1,100 @@
+/* test_compositor.c - damage and content updates posted to the compositor.
+ *
+ * Posting must only queue: the grids and the damage list change when the
+ * compositor task drains, all of a frame's updates at once.  A post that
+ * does not fit is refused whole, so a line is never half replaced. */
+
+#include "ssos_test.h"
+#include "gfx.h"
+#include "win.h"
+#include "compositor.h"
+#include "ipc.h"
+#include "scheduler.h"
+#include "kernel.h"
+
+static SSTextGrid grid;
+static uint16_t grid_win;
+
+static SSTextGrid* grid_of(uint16_t win) {
+    return win == grid_win ? &grid : NULL;
+}
+
+static void* comp_entry(void* arg) { (void)arg; return NULL; }
+
+static void start_compositor(void) {
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    ss_sched_init();
+    ss_ipc_init();
+    ss_comp_task = 0;
+    grid_win = ss_win_create(20, 20, 200, 60, 1);
+    ss_win_flush_damage();
+    ss_tgrid_init(&grid);
+    ASSERT_EQ(ss_comp_start(comp_entry, 8), (uint16_t)SS_OK);
+    ASSERT_NEQ(ss_comp_task, 0);
+}
+
+TEST(comp_updates_apply_only_when_the_compositor_drains) {
+    SSGfxRect d[SS_DAMAGE_MAX];
+    uint32_t mask;
+    int n;
+    start_compositor();
+    ASSERT_EQ(ss_comp_set_line(grid_win, 0, "Tick: 12345"), (int16_t)SS_OK);
+    ASSERT_EQ(ss_comp_put(grid_win, 1, 20, "abcdefghijklmnop"), (int16_t)SS_OK);
+    ASSERT_EQ(ss_comp_damage(grid_win, 4, 5, 6, 7), (int16_t)SS_OK);
+    /* 28 columns are three messages, the 8 that fit from column 20 one. */
+    ASSERT_EQ(ss_comp_pending(), 5);
+    ASSERT_EQ(grid.cell[0][0], ' ');
+    ASSERT_EQ(ss_win_pending_damage(NULL, 0), 0);
+
+    /* Only the compositor task receives. */
+    ss_curr_task = &tcb_table[ss_comp_task % SS_MAX_TASKS];
+    ASSERT_EQ(ss_comp_drain(grid_of), 0);
+    ss_curr_task = &tcb_table[ss_comp_task - 1];
+    n = ss_comp_drain(grid_of);
+    ASSERT_EQ(n, 5);
+    ASSERT_EQ(ss_comp_pending(), 0);
+
+    ASSERT_STR_EQ(grid.cell[0], "Tick: 12345                 ");
+    mask = ss_tgrid_take(&grid, 0);
+    ASSERT_EQ(mask, 0x7DFu);
+    ASSERT_EQ(grid.cell[1][20], 'a');
+    ASSERT_EQ(grid.cell[1][27], 'h');
+    ASSERT_EQ(grid.cell[1][SS_TGRID_COLS], '\0');
+    mask = ss_tgrid_take(&grid, 1);
+    ASSERT_EQ(mask, 0xFF00000u);
+    ASSERT_EQ(ss_win_pending_damage(d, SS_DAMAGE_MAX), 1);
+    ASSERT_EQ(d[0].x, 24);
+    ASSERT_EQ(d[0].y, 25);
+    ASSERT_EQ(d[0].w, 6);
+    ASSERT_EQ(d[0].h, 7);
+
+    /* Text for a window without a grid is dropped. */
+    ASSERT_EQ(ss_comp_put(grid_win + 1, 0, 0, "x"), (int16_t)SS_OK);
+    n = ss_comp_drain(grid_of);
+    ASSERT_EQ(n, 1);
+}
+
+TEST(comp_post_is_refused_whole_when_it_does_not_fit) {
+    start_compositor();
+    for (int i = 0; i < SS_MSG_MAX - 2; i++)
+        ASSERT_EQ(ss_comp_damage(grid_win, 0, 0, 1, 1), (int16_t)SS_OK);
+    ASSERT_EQ(ss_comp_set_line(grid_win, 2, "needs three"), (int16_t)SS_ERR_LIMIT);
+    ASSERT_EQ(ss_comp_pending(), SS_MSG_MAX - 2);
+    ASSERT_EQ(ss_comp_put(grid_win, 2, 0, "fits"), (int16_t)SS_OK);
+    ASSERT_EQ(ss_comp_put(grid_win, 2, SS_TGRID_COLS, "x"), (int16_t)SS_ERR_PARAM);
+
+    ss_curr_task = &tcb_table[ss_comp_task - 1];
+    ASSERT_EQ(ss_comp_drain(grid_of), SS_MSG_MAX - 1);
+    ASSERT_STR_EQ(grid.cell[2], "fits                        ");
+
+    ss_comp_task = 0;
+    ASSERT_EQ(ss_comp_damage(grid_win, 0, 0, 1, 1), (int16_t)SS_ERR_STATE);
+    ASSERT_EQ(ss_comp_drain(grid_of), 0);
+}
+
+void run_compositor_tests(void) {
+    RUN_TEST(comp_updates_apply_only_when_the_compositor_drains);
+    RUN_TEST(comp_post_is_refused_whole_when_it_does_not_fit);
+}
@@ -0,0 +1,162 @@
+/* test_console.c - text console windows.
+ *
+ * Every frame is checked against a full repaint of the same state: the
+ * blit scroll and the per-cell damage must never leave stale pixels, and
+ * must repaint only the rows and cells that changed. */
+
+#include "ssos_test.h"
+#include "gfx.h"
+#include "profile.h"
+#include "win.h"
+#include "console.h"
+#include <string.h>
+
+#define CON_X    40
+#define CON_Y    40
+#define CON_COLS 20
+#define CON_ROWS 5
+/* A few pixels past the grid on both sides, for the bg strips. */
+#define CON_W    (CON_COLS * SS_FONT_ADV + 3)
+#define CON_H    (CON_ROWS * SS_FONT_H + 4)
+
+static SSConsole con;
+static char ring[8 * CON_COLS];
+static uint16_t shown[CON_H][CON_W];
+static uint16_t con_win;
+
+static uint16_t pixel(int x, int y) {
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    return ss_draw_page[(uint32_t)y * stride + (uint32_t)x];
+}
+
+static void open_console(void) {
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_console_close(&con);
+    ss_win_init();
+    con_win = ss_win_create(CON_X, CON_Y, CON_W, CON_H, 1);
+    ASSERT_EQ(ss_console_open(&con, con_win, ring, sizeof(ring), 0x0002, 0x00F0), 0);
+    ss_win_render_all();
+    ss_win_flush_damage();
+}
+
+static void frame(void) {
+    ss_console_flush(&con);
+    ss_win_flush_damage();
+}
+
+/* The window as the incremental path left it must equal a full repaint. */
+static void assert_matches_full_repaint(void) {
+    for (int y = 0; y < CON_H; y++)
+        for (int x = 0; x < CON_W; x++) shown[y][x] = pixel(CON_X + x, CON_Y + y);
+    ss_win_render_all();
+    for (int y = 0; y < CON_H; y++)
+        for (int x = 0; x < CON_W; x++) ASSERT_EQ(shown[y][x], pixel(CON_X + x, CON_Y + y));
+}
+
+TEST(console_append_scrolls_by_blit_and_draws_one_row) {
+    SSGfxProfile p;
+    open_console();
+    ASSERT_EQ(con.cols, CON_COLS);
+    ASSERT_EQ(con.rows, CON_ROWS);
+    ASSERT_EQ(con.cap, 8);
+    ss_console_write(&con, "line 0\nline 1\nline 2\nline 3\nline 4");
+    frame();
+    assert_matches_full_repaint();
+    ASSERT_EQ(pixel(CON_X + CON_W - 1, CON_Y + CON_H - 1), 0x00F0);
+
+    ss_console_write(&con, "\nline 5");
+    ss_gfx_profile_reset();
+    frame();
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.text_calls, 1u);            /* only the row scrolled in */
+    ASSERT_EQ(con.shown_top, 1u);
+    assert_matches_full_repaint();
+}
+
+TEST(console_put_damages_only_changed_cells) {
+    SSGfxRect d[SS_DAMAGE_MAX];
+    open_console();
+    ss_console_write(&con, "alpha\nbeta\ngamma");
+    frame();
+
+    ss_console_put(&con, 1, 3, "TA");
+    ss_console_flush(&con);
+    ASSERT_EQ(ss_win_pending_damage(d, SS_DAMAGE_MAX), 1);
+    ASSERT_EQ(d[0].x, CON_X + 3 * SS_FONT_ADV);
+    ASSERT_EQ(d[0].y, CON_Y + SS_FONT_H);
+    ASSERT_EQ(d[0].w, 2 * SS_FONT_ADV);
+    ASSERT_EQ(d[0].h, SS_FONT_H);
+    ss_win_flush_damage();
+    assert_matches_full_repaint();
+
+    /* Appending to the newest line touches just the new cells. */
+    ss_console_write(&con, "!!");
+    ss_console_flush(&con);
+    ASSERT_EQ(ss_win_pending_damage(d, SS_DAMAGE_MAX), 1);
+    ASSERT_EQ(d[0].x, CON_X + 5 * SS_FONT_ADV);
+    ASSERT_EQ(d[0].w, 2 * SS_FONT_ADV);
+    ss_win_flush_damage();
+    assert_matches_full_repaint();
+}
+
+TEST(console_ring_wraps_and_scrollback_blits_both_ways) {
+    char msg[16];
+    open_console();
+    for (int i = 0; i < 12; i++) {
+        strcpy(msg, "\nrow ");
+        msg[5] = (char)('a' + i);
+        msg[6] = '\0';
+        ss_console_write(&con, i == 0 ? msg + 1 : msg);
+        frame();
+    }
+    assert_matches_full_repaint();
+    ASSERT_EQ(ss_console_last_line(&con), 11u);
+
+    /* Back past the oldest retained line stops at it. */
+    ss_console_scroll(&con, -100);
+    ASSERT_FALSE(con.follow);
+    frame();
+    ASSERT_EQ(con.shown_top, 4u);
+    assert_matches_full_repaint();
+
+    /* Dropped lines cannot be edited; output while scrolled back only
+     * damages what is on screen. */
+    ss_console_put(&con, 0, 0, "zz");
+    ss_console_write(&con, "\nrow m");
+    frame();
+    ASSERT_EQ(con.shown_top, 5u);       /* line 4 was dropped from the ring */
+    assert_matches_full_repaint();
+
+    ss_console_scroll(&con, 100);
+    ASSERT_TRUE(con.follow);
+    frame();
+    ASSERT_EQ(con.shown_top, 8u);
+    assert_matches_full_repaint();
+}
+
+TEST(console_covered_window_repaints_instead_of_blitting) {
+    SSGfxRect d[SS_DAMAGE_MAX];
+    open_console();
+    ss_console_write(&con, "0\n1\n2\n3\n4");
+    frame();
+    ss_win_create(CON_X + 30, CON_Y + 10, 40, 12, 2);
+    ss_win_flush_damage();
+
+    ss_console_write(&con, "\n5");
+    ss_console_flush(&con);
+    ASSERT_EQ(ss_win_pending_damage(d, SS_DAMAGE_MAX), 1);
+    ASSERT_EQ(d[0].x, CON_X);
+    ASSERT_EQ(d[0].y, CON_Y);
+    ASSERT_EQ(d[0].w, CON_COLS * SS_FONT_ADV);
+    ASSERT_EQ(d[0].h, CON_ROWS * SS_FONT_H);
+    ss_win_flush_damage();
+    assert_matches_full_repaint();
+}
+
+void run_console_tests(void) {
+    RUN_TEST(console_append_scrolls_by_blit_and_draws_one_row);
+    RUN_TEST(console_put_damages_only_changed_cells);
+    RUN_TEST(console_ring_wraps_and_scrollback_blits_both_ways);
+    RUN_TEST(console_covered_window_repaints_instead_of_blitting);
+}
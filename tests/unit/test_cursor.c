@@ -0,0 +1,119 @@
+/* test_cursor.c - mouse cursor backends.
+ *
+ * The sprite registers, PCG RAM and sprite palette are RAM in the native
+ * build, so a test can read back exactly what the target would write.  The
+ * IOCS setup calls are stubbed in test_mocks.c. */
+
+#include "ssos_test.h"
+#include "gfx.h"
+#include "profile.h"
+#include "cursor.h"
+
+static uint16_t pixel(int x, int y) {
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    return ss_draw_page[(uint32_t)y * stride + (uint32_t)x];
+}
+
+/* 4-bit PCG pixel at (x, y) of the cursor pattern. */
+static int pcg_pixel(int x, int y) {
+    const volatile uint16_t* pcg = SS_PCG_BASE + SS_CURSOR_PCG_NO * SS_PCG_WORDS;
+    int cell = (x >> 3) * 2 + (y >> 3);
+    uint16_t w = pcg[cell * 16 + (y & 7) * 2 + ((x & 7) >> 2)];
+    return (w >> ((3 - (x & 3)) * 4)) & 0xF;
+}
+
+TEST(cursor_sprite_move_writes_registers_not_gvram) {
+    SSGfxProfile p;
+    reset_test_state();
+    ss_gfx_set_mode(SS_CRTMOD_8);
+    ss_gfx_init();
+    ss_gfx_clear(0x1234);
+    ASSERT_EQ(ss_cursor_init(), SS_CURSOR_SPRITE);
+    ASSERT_EQ(ss_test_sprite_display_on, 1);
+
+    volatile uint16_t* spr = SS_SPRITE_REG_BASE + SS_CURSOR_SPRITE_NO * SS_SPRITE_REG_WORDS;
+    ASSERT_EQ(spr[3], 0);                       /* hidden before the first move */
+    ASSERT_EQ(spr[2], (SS_CURSOR_PALETTE << 8) | SS_CURSOR_PCG_NO);
+
+    ss_gfx_profile_reset();
+    ss_cursor_begin_repaint();
+    ss_cursor_move(100, 50);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.gvram_words_read, 0u);
+    ASSERT_EQ(p.gvram_words_written, 0u);
+    ASSERT_EQ(spr[0], 100 + SS_SPRITE_ORIGIN);
+    ASSERT_EQ(spr[1], 50 + SS_SPRITE_ORIGIN);
+    ASSERT_NEQ(spr[3], 0);
+    ASSERT_EQ(pixel(100, 50), 0x1234);
+
+    ss_cursor_shutdown();
+    ASSERT_EQ(spr[3], 0);
+    ASSERT_EQ(ss_test_sprite_display_on, 0);
+}
+
+TEST(cursor_sprite_pattern_is_bordered_box) {
+    reset_test_state();
+    ss_gfx_set_mode(SS_CRTMOD_8);
+    ss_gfx_init();
+    ASSERT_EQ(ss_cursor_init(), SS_CURSOR_SPRITE);
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 16; x++) {
+            int want = 0;
+            if (x < SS_CURSOR_SIZE && y < SS_CURSOR_SIZE) {
+                int edge = x == 0 || y == 0 ||
+                           x == SS_CURSOR_SIZE - 1 || y == SS_CURSOR_SIZE - 1;
+                want = edge ? 1 : 2;
+            }
+            ASSERT_EQ(pcg_pixel(x, y), want);
+        }
+    }
+    /* Both colours are opaque: entry 0 of a sprite palette is transparent. */
+    const volatile uint16_t* pal = SS_SPRITE_PAL_BASE + SS_CURSOR_PALETTE * 16;
+    ASSERT_NEQ(pal[1], 0);
+    ASSERT_NEQ(pal[2], 0);
+    ss_cursor_shutdown();
+}
+
+TEST(cursor_falls_back_to_xor_in_768_mode_and_when_init_fails) {
+    reset_test_state();
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ASSERT_EQ(ss_cursor_init(), SS_CURSOR_XOR);
+    ASSERT_EQ(ss_test_sprite_display_on, 0);
+
+    ss_gfx_set_mode(SS_CRTMOD_8);
+    ss_gfx_init();
+    ss_test_sprite_init_result = -1;
+    ASSERT_EQ(ss_cursor_init(), SS_CURSOR_XOR);
+    ASSERT_EQ(ss_test_sprite_display_on, 0);
+}
+
+TEST(cursor_xor_erases_before_repaint_and_moves) {
+    reset_test_state();
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_gfx_clear(0x0f0f);
+    ASSERT_EQ(ss_cursor_init(), SS_CURSOR_XOR);
+
+    ss_cursor_move(10, 10);
+    ASSERT_EQ(pixel(10, 10), (uint16_t)(0x0f0f ^ 0xffff));
+    ss_cursor_begin_repaint();
+    ASSERT_EQ(pixel(10, 10), 0x0f0f);
+    ss_cursor_begin_repaint();                  /* nothing left to erase */
+    ASSERT_EQ(pixel(10, 10), 0x0f0f);
+
+    /* A move without begin_repaint still erases the old box. */
+    ss_cursor_move(10, 10);
+    ss_cursor_move(40, 20);
+    ASSERT_EQ(pixel(10, 10), 0x0f0f);
+    ASSERT_EQ(pixel(40, 20), (uint16_t)(0x0f0f ^ 0xffff));
+    ss_cursor_shutdown();
+    ASSERT_EQ(pixel(40, 20), 0x0f0f);
+}
+
+void run_cursor_tests(void) {
+    RUN_TEST(cursor_sprite_move_writes_registers_not_gvram);
+    RUN_TEST(cursor_sprite_pattern_is_bordered_box);
+    RUN_TEST(cursor_falls_back_to_xor_in_768_mode_and_when_init_fails);
+    RUN_TEST(cursor_xor_erases_before_repaint_and_moves);
+}
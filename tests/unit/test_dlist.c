@@ -0,0 +1,137 @@
+/* test_dlist.c - retained display lists.
+ *
+ * A replay must paint exactly what the equivalent immediate draw calls
+ * paint, and a clipped replay must touch only the nodes (and pixels) that
+ * intersect its clip. */
+
+#include "ssos_test.h"
+#include "gfx.h"
+#include "profile.h"
+#include "dlist.h"
+#include <string.h>
+
+static uint16_t pixel(int x, int y) {
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    return ss_draw_page[(uint32_t)y * stride + (uint32_t)x];
+}
+
+static void set_pixel(int x, int y, uint16_t c) {
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    ss_draw_page[(uint32_t)y * stride + (uint32_t)x] = c;
+}
+
+static SSDlNode nodes[8];
+static SSDisplayList dl;
+static char line[12];
+static int bg_node, text_node, hidden_node;
+
+/* A 100x40 panel: background, border line, a text line and a hidden bar. */
+static void build_panel(void) {
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_gfx_clear(0x0001);
+    strcpy(line, "Count: 100");
+    ss_dl_init(&dl, nodes, 8);
+    bg_node = ss_dl_rect(&dl, 0, 0, 100, 40, 0x00F0);
+    ss_dl_rect(&dl, 0, 0, 100, 1, 0x0F00);
+    text_node = ss_dl_text(&dl, 4, 10, line, 0x0002, 0x00F0);
+    hidden_node = ss_dl_rect(&dl, 0, 30, 100, 4, 0x7777);
+    ss_dl_set_hidden(&dl, hidden_node, 1);
+}
+
+TEST(dlist_replay_matches_immediate_draw) {
+    build_panel();
+    ss_dl_replay(&dl, 20, 30, NULL);
+
+    uint16_t got[40][100];
+    for (int y = 0; y < 40; y++)
+        for (int x = 0; x < 100; x++) got[y][x] = pixel(20 + x, 30 + y);
+
+    ss_gfx_clear(0x0001);
+    ss_gfx_rect(20, 30, 100, 40, 0x00F0);
+    ss_gfx_rect(20, 30, 100, 1, 0x0F00);
+    ss_gfx_draw_text_fast(24, 40, line, 0x0002, 0x00F0);
+    for (int y = 0; y < 40; y++)
+        for (int x = 0; x < 100; x++) ASSERT_EQ(got[y][x], pixel(20 + x, 30 + y));
+    ASSERT_EQ(pixel(20, 61), 0x00F0);          /* hidden bar not drawn */
+}
+
+TEST(dlist_query_starts_at_covering_node) {
+    uint8_t idx[8];
+    build_panel();
+    ASSERT_EQ(ss_dl_bounds(&dl, text_node).w, 10 * SS_FONT_ADV);
+
+    /* Inside the text run: the run covers the clip, nothing below shows. */
+    SSGfxRect cell = ss_dl_cells(&dl, text_node, 9, 1);
+    cell.x += 20;
+    cell.y += 30;
+    ASSERT_EQ(ss_dl_query(&dl, 20, 30, &cell, idx, 8), 1);
+    ASSERT_EQ(idx[0], text_node);
+
+    /* Across the border and the background; the hidden node is ignored. */
+    SSGfxRect edge = { 30, 29, 8, 3 };
+    ASSERT_EQ(ss_dl_query(&dl, 20, 30, &edge, idx, 8), 2);
+    ASSERT_EQ(idx[0], bg_node);
+    SSGfxRect bar = { 30, 62, 8, 2 };
+    ASSERT_EQ(ss_dl_query(&dl, 20, 30, &bar, NULL, 0), 1);
+
+    /* Outside the list. */
+    SSGfxRect away = { 300, 300, 10, 10 };
+    ASSERT_EQ(ss_dl_query(&dl, 20, 30, &away, idx, 8), 0);
+}
+
+TEST(dlist_cell_update_repaints_only_that_cell) {
+    SSGfxProfile p;
+    build_panel();
+    ss_dl_replay(&dl, 20, 30, NULL);
+    /* Sentinels just outside the changed cell. */
+    SSGfxRect cell = ss_dl_cells(&dl, text_node, 9, 1);
+    int cx = 20 + cell.x, cy = 30 + cell.y;
+    set_pixel(cx - 1, cy, 0x5555);
+    set_pixel(cx + cell.w, cy, 0x5555);
+
+    line[9] = '1';
+    ss_gfx_profile_reset();
+    SSGfxRect clip = { cx, cy, cell.w, cell.h };
+    ss_dl_replay(&dl, 20, 30, &clip);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.dl_nodes_replayed, 1u);
+    ASSERT_EQ(p.gvram_words_written, (uint32_t)(SS_FONT_ADV * SS_FONT_H));
+    ASSERT_EQ(pixel(cx - 1, cy), 0x5555);
+    ASSERT_EQ(pixel(cx + cell.w, cy), 0x5555);
+
+    uint16_t got[SS_FONT_H][SS_FONT_ADV];
+    for (int y = 0; y < SS_FONT_H; y++)
+        for (int x = 0; x < SS_FONT_ADV; x++) got[y][x] = pixel(cx + x, cy + y);
+    ss_gfx_draw_text_fast(cx, cy, "1", 0x0002, 0x00F0);
+    for (int y = 0; y < SS_FONT_H; y++)
+        for (int x = 0; x < SS_FONT_ADV; x++) ASSERT_EQ(got[y][x], pixel(cx + x, cy + y));
+}
+
+TEST(dlist_node_updates_and_capacity) {
+    SSDlNode small[2];
+    SSDisplayList s;
+    ss_dl_init(&s, small, 2);
+    ASSERT_EQ(ss_dl_rect(&s, 0, 0, 4, 4, 1), 0);
+    ASSERT_EQ(ss_dl_text(&s, 0, 0, "ab", 1, 2), 1);
+    ASSERT_EQ(ss_dl_rect(&s, 0, 0, 4, 4, 1), -1);
+
+    build_panel();
+    ss_dl_set_color(&dl, bg_node, 0x0033, 0);
+    ss_dl_set_hidden(&dl, hidden_node, 0);
+    ss_dl_replay(&dl, 0, 0, NULL);
+    ASSERT_EQ(pixel(50, 20), 0x0033);
+    ASSERT_EQ(pixel(50, 31), 0x7777);
+
+    ss_dl_set_text(&dl, text_node, "ab");
+    ASSERT_EQ(ss_dl_bounds(&dl, text_node).w, 2 * SS_FONT_ADV);
+    ss_dl_clear(&dl);
+    ASSERT_EQ(ss_dl_query(&dl, 0, 0, NULL, NULL, 0), 0);
+}
+
+void run_dlist_tests(void) {
+    RUN_TEST(dlist_replay_matches_immediate_draw);
+    RUN_TEST(dlist_query_starts_at_covering_node);
+    RUN_TEST(dlist_cell_update_repaints_only_that_cell);
+    RUN_TEST(dlist_node_updates_and_capacity);
+}
@@ -1,5 +1,6 @@
 #include "ssos_test.h"
 #include "gfx.h"
+#include "profile.h"
 
 static uint32_t stride(void) {
     return (uint32_t)ss_current_mode->bytes_per_line / 2;
@@ -44,13 +45,49 @@ TEST(gfx_rect_handles_odd_alignment) {
 TEST(gfx_stipple_phase_and_clip) {
     reset_gfx(SS_CRTMOD_16, 0x1111);
     ss_gfx_fill_stipple(-1, 1, 3, 2, 0x2222, 0x3333);
-    ASSERT_EQ(pixel(0, 1), 0x3333);
-    ASSERT_EQ(pixel(1, 1), 0x2222);
-    ASSERT_EQ(pixel(0, 2), 0x2222);
-    ASSERT_EQ(pixel(1, 2), 0x3333);
+    /* c1 where x + y is odd, matching the big-endian target. */
+    ASSERT_EQ(pixel(0, 1), 0x2222);
+    ASSERT_EQ(pixel(1, 1), 0x3333);
+    ASSERT_EQ(pixel(0, 2), 0x3333);
+    ASSERT_EQ(pixel(1, 2), 0x2222);
     ASSERT_EQ(pixel(2, 1), 0x1111);
 }
 
+TEST(gfx_rect_multirow_fills_exact_block) {
+    reset_gfx(SS_CRTMOD_16, 0x1111);
+    ss_gfx_rect(5, 2, 7, 4, 0x2222);
+    for (int y = 1; y < 7; y++) {
+        for (int x = 4; x < 13; x++) {
+            int inside = x >= 5 && x < 12 && y >= 2 && y < 6;
+            ASSERT_EQ(pixel(x, y), inside ? 0x2222 : 0x1111);
+        }
+    }
+}
+
+TEST(gfx_stipple_multirow_keeps_checker_phase) {
+    reset_gfx(SS_CRTMOD_16, 0x1111);
+    ss_gfx_fill_stipple(3, 5, 8, 5, 0x2222, 0x3333);
+    for (int y = 4; y < 11; y++) {
+        for (int x = 2; x < 12; x++) {
+            uint16_t want = 0x1111;
+            if (x >= 3 && x < 11 && y >= 5 && y < 10)
+                want = ((x + y) & 1) ? 0x2222 : 0x3333;
+            ASSERT_EQ(pixel(x, y), want);
+        }
+    }
+}
+
+TEST(gfx_copy_long_handles_overlap_both_ways) {
+    uint32_t buf[40];
+    for (int i = 0; i < 40; i++) buf[i] = (uint32_t)i;
+    ss_copy_long(buf + 3, buf, 30);
+    for (int i = 0; i < 30; i++) ASSERT_EQ(buf[3 + i], (uint32_t)i);
+    for (int i = 0; i < 40; i++) buf[i] = (uint32_t)i;
+    ss_copy_long(buf, buf + 5, 30);
+    for (int i = 0; i < 30; i++) ASSERT_EQ(buf[i], (uint32_t)(i + 5));
+    ASSERT_EQ(buf[35], 35u);
+}
+
 TEST(gfx_region_intersects_rect) {
     reset_gfx(SS_CRTMOD_16, 0x1111);
     SSGfxRect clip = { 4, 3, 3, 2 };
@@ -75,6 +112,176 @@ TEST(gfx_char_fast_matches_slow) {
     }
 }
 
+TEST(gfx_char_fast_matches_slow_at_both_parities) {
+    static const char chars[] = { 'A', 'W', '@', 'g', '~', ' ' };
+    for (int x = 40; x < 42; x++) {
+        for (unsigned i = 0; i < sizeof(chars); i++) {
+            uint16_t expected[SS_FONT_H][SS_FONT_W + 2];
+            reset_gfx(SS_CRTMOD_16, 0x1111);
+            ss_gfx_char(x, 30, chars[i], 0x2222, 0x3333);
+            for (int y = 0; y < SS_FONT_H; y++)
+                for (int c = -1; c <= SS_FONT_W; c++)
+                    expected[y][c + 1] = pixel(x + c, 30 + y);
+            ss_gfx_clear(0x1111);
+            ss_gfx_char_fast(x, 30, chars[i], 0x2222, 0x3333);
+            for (int y = 0; y < SS_FONT_H; y++)
+                for (int c = -1; c <= SS_FONT_W; c++)
+                    ASSERT_EQ(pixel(x + c, 30 + y), expected[y][c + 1]);
+        }
+    }
+}
+
+TEST(gfx_glyph_table_rebuilds_only_on_color_change) {
+    SSGfxProfile p;
+    reset_gfx(SS_CRTMOD_16, 0x1111);
+    ss_gfx_profile_reset();
+    ss_gfx_char_fast(10, 10, 'a', 0x0A0A, 0x0B0B);
+    ss_gfx_char_fast(16, 10, 'b', 0x0A0A, 0x0B0B);
+    ss_gfx_char_fast(23, 10, 'c', 0x0A0A, 0x0B0B);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.glyph_table_builds, 1u);
+    ss_gfx_char_fast(29, 10, 'd', 0x0C0C, 0x0B0B);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.glyph_table_builds, 2u);
+    /* Three stores per row at either parity instead of five. */
+    ASSERT_EQ(p.glyph_stores, 4u * 3u * SS_FONT_H);
+    ASSERT_EQ(p.gvram_words_written, 4u * SS_FONT_W * SS_FONT_H);
+}
+
+#define RUN_TEXT "Hi@W ~q"
+#define RUN_LEN  7
+#define RUN_W    (RUN_LEN * SS_FONT_ADV)
+
+/* Reference: per-glyph slow blits plus the bg gap column of each slice. */
+static void capture_reference_run(int x, int y, uint16_t ref[SS_FONT_H][RUN_W + 2]) {
+    reset_gfx(SS_CRTMOD_16, 0x1111);
+    for (int k = 0; k < RUN_LEN; k++) {
+        ss_gfx_char(x + k * SS_FONT_ADV, y, RUN_TEXT[k], 0x2222, 0x3333);
+        ss_gfx_rect(x + k * SS_FONT_ADV + SS_FONT_W, y, 1, SS_FONT_H, 0x3333);
+    }
+    for (int r = 0; r < SS_FONT_H; r++)
+        for (int c = -1; c <= RUN_W; c++) ref[r][c + 1] = pixel(x + c, y + r);
+}
+
+TEST(gfx_text_run_matches_glyphs_with_gap_at_both_parities) {
+    uint16_t ref[SS_FONT_H][RUN_W + 2];
+    for (int x = 50; x < 52; x++) {
+        capture_reference_run(x, 20, ref);
+        ss_gfx_clear(0x1111);
+        ss_gfx_draw_text_fast(x, 20, RUN_TEXT, 0x2222, 0x3333);
+        for (int r = 0; r < SS_FONT_H; r++)
+            for (int c = -1; c <= RUN_W; c++)
+                ASSERT_EQ(pixel(x + c, 20 + r), ref[r][c + 1]);
+        /* Rows just outside the run stay untouched. */
+        ASSERT_EQ(pixel(x, 19), 0x1111);
+        ASSERT_EQ(pixel(x, 20 + SS_FONT_H), 0x1111);
+    }
+}
+
+TEST(gfx_text_region_clips_mid_glyph) {
+    uint16_t ref[SS_FONT_H][RUN_W + 2];
+    for (int x = 50; x < 52; x++) {
+        capture_reference_run(x, 20, ref);
+        ss_gfx_clear(0x1111);
+        SSGfxRect clip = { x + 3, 22, 20, 4 };
+        ss_gfx_draw_text_region(x, 20, RUN_TEXT, 0x2222, 0x3333, &clip);
+        for (int r = 0; r < SS_FONT_H; r++) {
+            for (int c = -1; c <= RUN_W; c++) {
+                int xx = x + c, yy = 20 + r;
+                int in = xx >= clip.x && xx < clip.x + clip.w &&
+                         yy >= clip.y && yy < clip.y + clip.h;
+                ASSERT_EQ(pixel(xx, yy), in ? ref[r][c + 1] : 0x1111);
+            }
+        }
+    }
+}
+
+TEST(gfx_text_clip_skips_higher_windows_only) {
+    uint16_t ref[SS_FONT_H][RUN_W + 2];
+    int x = 51;
+    capture_reference_run(x, 20, ref);
+    ss_gfx_clear(0x1111);
+    /* Target at z position 1; [0] is below it, [2] is above it. */
+    int wins[3 * 4] = {
+        x + 1, 20, 10, 8,
+        0, 0, 200, 100,
+        x + 9, 23, 7, 2,
+    };
+    ss_gfx_draw_text_clip(x, 20, RUN_TEXT, 0x2222, 0x3333, wins, 3, 1);
+    for (int r = 0; r < SS_FONT_H; r++) {
+        for (int c = -1; c <= RUN_W; c++) {
+            int xx = x + c, yy = 20 + r;
+            int above = xx >= x + 9 && xx < x + 16 && yy >= 23 && yy < 25;
+            int in_run = c >= 0 && c < RUN_W;
+            ASSERT_EQ(pixel(xx, yy), (in_run && !above) ? ref[r][c + 1] : 0x1111);
+        }
+    }
+}
+
+/* Stacked, abutting and overlapping occluders split the run into several
+ * bands and spans; every pixel must match a per-pixel window test. */
+static int covered_by(const int* wins, int n, int zpos, int xx, int yy) {
+    for (int k = zpos + 1; k < n; k++) {
+        const int* w = &wins[k * 4];
+        if (xx >= w[0] && xx < w[0] + w[2] && yy >= w[1] && yy < w[1] + w[3]) return 1;
+    }
+    return 0;
+}
+
+TEST(gfx_text_clip_spans_match_per_pixel_occlusion) {
+    uint16_t ref[SS_FONT_H][RUN_W + 2];
+    int x = 50;
+    capture_reference_run(x, 20, ref);
+    ss_gfx_clear(0x1111);
+    int wins[6 * 4] = {
+        x, 20, RUN_W, 8,            /* target */
+        x + 3, 19, 4, 3,            /* top edge above the run */
+        x + 7, 21, 5, 4,            /* abuts the previous one */
+        x + 9, 22, 2, 2,            /* nested inside the previous one */
+        x + 20, 25, 30, 10,         /* runs past the bottom and the end */
+        x + 30, 18, 0, 20,          /* empty: covers nothing */
+    };
+    ss_gfx_draw_text_clip(x, 20, RUN_TEXT, 0x2222, 0x3333, wins, 6, 0);
+    for (int r = 0; r < SS_FONT_H; r++) {
+        for (int c = -1; c <= RUN_W; c++) {
+            int xx = x + c, yy = 20 + r;
+            int in_run = c >= 0 && c < RUN_W;
+            ASSERT_EQ(pixel(xx, yy), (in_run && !covered_by(wins, 6, 0, xx, yy))
+                                         ? ref[r][c + 1] : 0x1111);
+        }
+    }
+
+    ss_gfx_clear(0x1111);
+    ss_gfx_char_clip(x + 6, 20, 'i', 0x2222, 0x3333, wins, 6, 0);
+    for (int r = 0; r < SS_FONT_H; r++) {
+        for (int c = 0; c < SS_FONT_W; c++) {
+            int xx = x + 6 + c, yy = 20 + r;
+            ASSERT_EQ(pixel(xx, yy), covered_by(wins, 6, 0, xx, yy)
+                                         ? 0x1111 : ref[r][6 + c + 1]);
+        }
+    }
+}
+
+TEST(gfx_blit_overlapping_in_both_directions) {
+    /* Odd widths and odd x exercise the word tail on either side of the
+     * long copy; overlapping moves must read each source pixel before it
+     * is overwritten. */
+    static const int moves[4][2] = { { 3, 2 }, { -3, -2 }, { 1, 0 }, { 0, -1 } };
+    for (int m = 0; m < 4; m++) {
+        reset_gfx(SS_CRTMOD_16, 0);
+        for (int y = 20; y < 27; y++) {
+            for (int x = 21; x < 30; x++) ss_draw_page[(uint32_t)y * stride() + (uint32_t)x] = (uint16_t)(y * 64 + x);
+        }
+        int dx = 21 + moves[m][0], dy = 20 + moves[m][1];
+        ss_gfx_blit(21, 20, dx, dy, 9, 7);
+        for (int y = 0; y < 7; y++) {
+            for (int x = 0; x < 9; x++) {
+                ASSERT_EQ(pixel(dx + x, dy + y), (uint16_t)((20 + y) * 64 + 21 + x));
+            }
+        }
+    }
+}
+
 TEST(gfx_xor_perimeter_twice_restores) {
     reset_gfx(SS_CRTMOD_16, 0x1111);
     ss_gfx_rect(10, 10, 4, 3, 0x2468);
@@ -101,13 +308,131 @@ TEST(gfx_flip_switches_pages) {
     ASSERT_EQ(ss_gfx_test_crtc[SS_CRTC_SCROLL_Y], 512);
 }
 
+/* A batch must paint exactly what the same rects drawn one by one paint,
+ * including overlaps of different colours in submission order. */
+TEST(gfx_rect_batch_matches_sequential_rects) {
+    static const SSGfxRect rects[] = {
+        { 10, 10, 60, 30 }, { 12, 40, 20, 5 }, { 0, 5, 30, 8 },
+        { 20, 12, 10, 40 }, { 40, 0, 8, 8 }, { 48, 0, 8, 8 },
+        { 15, 15, 0, 10 }, { -5, 30, 12, 4 }, { 25, 25, 30, 3 },
+    };
+    static const uint16_t colors[] = {
+        0x1000, 0x2000, 0x3000, 0x1000, 0x4000, 0x4000, 0x5000, 0x2000, 0x1000,
+    };
+    enum { N = sizeof(rects) / sizeof(rects[0]) };
+    static const SSGfxRect clips[] = { { 0, 0, 0, 0 }, { 14, 8, 30, 30 } };
+    uint16_t want[60][80];
+
+    for (int k = 0; k < 2; k++) {
+        const SSGfxRect* clip = k == 0 ? NULL : &clips[1];
+        reset_gfx(SS_CRTMOD_16, 0x0001);
+        for (int i = 0; i < N; i++) ss_gfx_rect_region(rects[i], clip, colors[i]);
+        for (int y = 0; y < 60; y++)
+            for (int x = 0; x < 80; x++) want[y][x] = pixel(x, y);
+
+        reset_gfx(SS_CRTMOD_16, 0x0001);
+        ss_gfx_rect_batch(rects, colors, N, clip);
+        for (int y = 0; y < 60; y++)
+            for (int x = 0; x < 80; x++) ASSERT_EQ(pixel(x, y), want[y][x]);
+    }
+}
+
+TEST(gfx_rect_batch_merges_frame_edges_and_drops_empty) {
+    SSGfxProfile p;
+    /* A one-pixel frame: top, bottom, left and right edges, all black, plus
+     * an empty rect and one wholly outside the clip. */
+    static const SSGfxRect rects[] = {
+        { 100, 100, 50, 1 }, { 100, 129, 50, 1 },
+        { 100, 101, 1, 28 }, { 149, 101, 1, 28 },
+        { 120, 110, 0, 5 }, { 400, 400, 10, 10 },
+    };
+    static const uint16_t colors[] = { 7, 7, 7, 7, 7, 7 };
+    SSGfxRect clip = { 0, 0, 300, 300 };
+    reset_gfx(SS_CRTMOD_16, 0x0001);
+    ss_gfx_profile_reset();
+    ss_gfx_rect_batch(rects, colors, 6, &clip);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.rect_batch_calls, 1u);
+    /* The edges meet only at corners, so they stay four fills; the empty
+     * and off-clip rects are dropped before any fill. */
+    ASSERT_EQ(p.rect_calls, 4u);
+    ASSERT_EQ(p.gvram_words_written, (uint32_t)(2 * 50 + 2 * 28));
+    ASSERT_EQ(pixel(100, 100), 7);
+    ASSERT_EQ(pixel(149, 128), 7);
+    ASSERT_EQ(pixel(120, 110), 0x0001);
+
+    /* Stacked rows of one colour collapse into a single fill. */
+    static const SSGfxRect rows[] = { { 10, 10, 20, 2 }, { 10, 14, 20, 2 }, { 10, 12, 20, 2 } };
+    static const uint16_t rc[] = { 3, 3, 3 };
+    ss_gfx_profile_reset();
+    ss_gfx_rect_batch(rows, rc, 3, NULL);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.rect_calls, 1u);
+    ASSERT_EQ(p.rect_batch_merges, 2u);
+    for (int y = 10; y < 16; y++) ASSERT_EQ(pixel(15, y), 3);
+}
+
+/* Each mode runs its own kernel instance; drive them at the bottom-right
+ * corner, where a wrong stride or bound shows up as a wrapped pixel. */
+TEST(gfx_mode_kernels_clip_at_their_own_bounds) {
+    static const int modes[] = { SS_CRTMOD_8, SS_CRTMOD_16 };
+    for (unsigned m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        reset_gfx(modes[m], 0x1111);
+        int W = ss_current_mode->display_w, H = ss_current_mode->display_h;
+        ss_gfx_rect(W - 2, H - 2, 5, 5, 0x2222);
+        ASSERT_EQ(pixel(W - 1, H - 1), 0x2222);
+        ASSERT_EQ(pixel(W - 3, H - 1), 0x1111);
+        ASSERT_EQ(pixel(0, H - 1), 0x1111);          /* no wrap onto the next row */
+        ASSERT_EQ(pixel(0, 0), 0x1111);
+
+        ss_gfx_fill_stipple(W - 3, 0, 6, 2, 0x3333, 0x4444);
+        ASSERT_EQ(pixel(W - 1, 0), 0x3333);          /* c1 where x + y is odd */
+        ASSERT_EQ(pixel(0, 1), 0x1111);
+
+        ss_gfx_xor_rect(W - 4, H - 4, 8, 8);
+        ASSERT_EQ(pixel(W - 4, H - 1), (uint16_t)(0x1111 ^ 0xffff));
+        ASSERT_EQ(pixel(W - 1, H - 4), (uint16_t)(0x1111 ^ 0xffff));
+        ASSERT_EQ(pixel(W - 3, H - 3), 0x1111);
+
+        ss_gfx_blit(W - 2, H - 2, 0, 0, 4, 4);
+        ASSERT_EQ(pixel(0, 0), 0x2222);
+        ASSERT_EQ(pixel(2, 0), 0x1111);
+
+        ss_gfx_char_fast(W - SS_FONT_W, H - SS_FONT_H, 'A', 0x5555, 0x6666);
+        uint16_t fast[SS_FONT_H][SS_FONT_W];
+        for (int y = 0; y < SS_FONT_H; y++)
+            for (int x = 0; x < SS_FONT_W; x++)
+                fast[y][x] = pixel(W - SS_FONT_W + x, H - SS_FONT_H + y);
+        ss_gfx_char(W - SS_FONT_W, H - SS_FONT_H, 'A', 0x5555, 0x6666);
+        for (int y = 0; y < SS_FONT_H; y++)
+            for (int x = 0; x < SS_FONT_W; x++)
+                ASSERT_EQ(fast[y][x], pixel(W - SS_FONT_W + x, H - SS_FONT_H + y));
+
+        ss_gfx_draw_text(W - 3, 20, "AB", 0x5555, 0x6666);
+        ASSERT_EQ(pixel(0, 20), 0x1111);
+    }
+}
+
 void run_gfx_tests(void) {
     RUN_TEST(gfx_set_mode_rejects_unimplemented_values);
     RUN_TEST(gfx_rect_clips_and_preserves_outside);
     RUN_TEST(gfx_rect_handles_odd_alignment);
     RUN_TEST(gfx_stipple_phase_and_clip);
+    RUN_TEST(gfx_rect_multirow_fills_exact_block);
+    RUN_TEST(gfx_stipple_multirow_keeps_checker_phase);
+    RUN_TEST(gfx_copy_long_handles_overlap_both_ways);
     RUN_TEST(gfx_region_intersects_rect);
     RUN_TEST(gfx_char_fast_matches_slow);
+    RUN_TEST(gfx_char_fast_matches_slow_at_both_parities);
+    RUN_TEST(gfx_glyph_table_rebuilds_only_on_color_change);
+    RUN_TEST(gfx_text_run_matches_glyphs_with_gap_at_both_parities);
+    RUN_TEST(gfx_text_region_clips_mid_glyph);
+    RUN_TEST(gfx_text_clip_skips_higher_windows_only);
+    RUN_TEST(gfx_text_clip_spans_match_per_pixel_occlusion);
+    RUN_TEST(gfx_blit_overlapping_in_both_directions);
     RUN_TEST(gfx_xor_perimeter_twice_restores);
     RUN_TEST(gfx_flip_switches_pages);
+    RUN_TEST(gfx_mode_kernels_clip_at_their_own_bounds);
+    RUN_TEST(gfx_rect_batch_matches_sequential_rects);
+    RUN_TEST(gfx_rect_batch_merges_frame_edges_and_drops_empty);
 }
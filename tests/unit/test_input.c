@@ -0,0 +1,177 @@
+#include "kernel.h"
+#include "ssos_test.h"
+#include "input.h"
+#include "scheduler.h"
+#include "input_iocs.h"
+#include "fake_iocs.h"
+#include <string.h>
+
+static SSInputEvent make_event(uint8_t type, int x, int y, uint16_t key) {
+    SSInputEvent ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.x = (int16_t)x;
+    ev.y = (int16_t)y;
+    ev.key = key;
+    return ev;
+}
+
+TEST(input_fifo_coalesces_queued_motion) {
+    SSInputEvent ev;
+    ss_input_init(NULL);
+
+    ev = make_event(SS_INPUT_MOTION, 1, 1, 0);
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    ev = make_event(SS_INPUT_MOTION, 5, 6, 0);
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    ev = make_event(SS_INPUT_KEY, 0, 0, 0x1E61);
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    ev = make_event(SS_INPUT_MOTION, 7, 8, 0);
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    ev = make_event(SS_INPUT_BUTTON, 7, 8, 0);
+    ev.buttons = SS_INPUT_LEFT;
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    /* A move after the button is not merged into the earlier one. */
+    ev = make_event(SS_INPUT_MOTION, 9, 9, 0);
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    ASSERT_EQ(ss_input_pending(), 5);
+
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.type, SS_INPUT_MOTION);
+    ASSERT_EQ(ev.x, 5);
+    ASSERT_EQ(ev.y, 6);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.key, 0x1E61);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.x, 7);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.type, SS_INPUT_BUTTON);
+    ASSERT_EQ(ev.buttons, SS_INPUT_LEFT);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.x, 9);
+    ASSERT_EQ(ss_input_poll(&ev), SS_ERR_LIMIT);
+}
+
+TEST(input_full_ring_drops_and_counts) {
+    SSInputEvent ev;
+    ss_input_init(NULL);
+    for (int i = 0; i < SS_INPUT_QUEUE_SIZE; i++) {
+        ev = make_event(SS_INPUT_KEY, 0, 0, (uint16_t)i);
+        ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    }
+    ev = make_event(SS_INPUT_KEY, 0, 0, 0xFF);
+    ASSERT_EQ(ss_input_post(&ev), SS_ERR_LIMIT);
+    ASSERT_EQ(ss_input_dropped, 1u);
+    ASSERT_EQ(ss_input_post(NULL), SS_ERR_PARAM);
+
+    /* The ring wraps without losing order. */
+    for (int i = 0; i < SS_INPUT_QUEUE_SIZE; i++) {
+        ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+        ASSERT_EQ(ev.key, (uint16_t)i);
+    }
+    ev = make_event(SS_INPUT_KEY, 0, 0, 0x42);
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.key, 0x42);
+}
+
+/* A scripted source, as host runs inject input: one event per pump. */
+static const uint16_t script_keys[] = { 0x0141, 0x0142, 0x0143 };
+static int script_pos;
+static int script_pumps;
+
+static void script_pump(void* ctx) {
+    const uint16_t* keys = ctx;
+    script_pumps++;
+    if (script_pos < 3) {
+        SSInputEvent ev = make_event(SS_INPUT_KEY, 0, 0, keys[script_pos++]);
+        ss_input_post(&ev);
+    }
+}
+
+TEST(input_wait_pumps_source_until_event) {
+    SSInputSource src = { script_pump, (void*)script_keys };
+    SSInputEvent ev;
+    script_pos = 0;
+    script_pumps = 0;
+    ss_input_init(&src);
+
+    /* Polling never runs the source. */
+    ASSERT_EQ(ss_input_poll(&ev), SS_ERR_LIMIT);
+    ASSERT_EQ(script_pumps, 0);
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(ss_input_wait(&ev), SS_OK);
+        ASSERT_EQ(ev.type, SS_INPUT_KEY);
+        ASSERT_EQ(ev.key, script_keys[i]);
+    }
+    ASSERT_EQ(script_pumps, 3);
+    ss_input_pump();
+    ASSERT_EQ(ss_input_pending(), 0);
+    ss_input_init(NULL);
+}
+
+/* Every post, merged or not, signals the notified task. */
+TEST(input_post_signals_notified_task) {
+    static SSTask task;
+    SSInputEvent ev = make_event(SS_INPUT_MOTION, 1, 1, 0);
+    ss_input_init(NULL);
+    ss_input_notify(&task);
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    ASSERT_EQ(task.signals, SS_SIG_INPUT);
+    task.signals = 0;
+    ev.x = 2;
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);   /* merged into the first */
+    ASSERT_EQ(task.signals, SS_SIG_INPUT);
+    ss_input_notify(NULL);
+    task.signals = 0;
+    ASSERT_EQ(ss_input_post(&ev), SS_OK);
+    ASSERT_EQ(task.signals, 0);
+}
+
+/* The IOCS producer posts from the receive interrupts: keys typed between
+ * frames all arrive, with nobody pumping, until it is detached. */
+TEST(input_iocs_posts_from_receive_interrupts) {
+    SSInputEvent ev;
+    ss_fake_iocs_reset();
+    ss_fake_mouse(10, 20, 0);
+    ss_input_iocs_attach();
+    /* Attaching posts where the pointer already is. */
+    ASSERT_EQ(ss_input_pending(), 1);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.type, SS_INPUT_MOTION);
+    ASSERT_EQ(ev.x, 10);
+    ASSERT_EQ(ev.y, 20);
+
+    ss_fake_key(0x1E61);
+    ss_fake_key(0x3062);
+    ss_fake_mouse(30, 40, 0);
+    ss_fake_mouse(30, 40, SS_INPUT_LEFT);
+    ASSERT_EQ(ss_input_pending(), 4);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.key, 0x1E61);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.key, 0x3062);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.type, SS_INPUT_MOTION);
+    ASSERT_EQ(ss_input_poll(&ev), SS_OK);
+    ASSERT_EQ(ev.type, SS_INPUT_BUTTON);
+    ASSERT_EQ(ev.buttons, SS_INPUT_LEFT);
+    /* A receive that changes nothing posts nothing. */
+    ss_fake_mouse(30, 40, SS_INPUT_LEFT);
+    ASSERT_EQ(ss_input_pending(), 0);
+
+    ss_input_iocs_detach();
+    ss_fake_key(0x1E61);
+    ss_fake_mouse(50, 60, 0);
+    ASSERT_EQ(ss_input_pending(), 0);
+    ss_fake_iocs_reset();
+}
+
+void run_input_tests(void) {
+    RUN_TEST(input_fifo_coalesces_queued_motion);
+    RUN_TEST(input_full_ring_drops_and_counts);
+    RUN_TEST(input_wait_pumps_source_until_event);
+    RUN_TEST(input_post_signals_notified_task);
+    RUN_TEST(input_iocs_posts_from_receive_interrupts);
+}
@@ -62,6 +62,18 @@ TEST(send_then_recv_nb) {
     ASSERT_EQ(memcmp(out.payload, "hello", 5), 0);
 }
 
+/* A send wakes the receiver from ss_task_wait(). */
+TEST(send_signals_receiver) {
+    ss_ipc_init();
+    set_recv_task(0);
+    tcb_table[0].signals = 0;
+
+    SSMessage in = make_msg(7, 2, NULL);
+    ASSERT_EQ(ss_send(1, &in), (int16_t)SS_OK);
+    ASSERT_EQ(tcb_table[0].signals, SS_SIG_MSG);
+    tcb_table[0].signals = 0;
+}
+
 TEST(send_invalid_id) {
     ss_ipc_init();
     SSMessage in = make_msg(1, 0, "x");
@@ -172,6 +184,7 @@ TEST(recv_uses_current_task_queue) {
 void run_ipc_tests(void) {
     RUN_TEST(ipc_init_empty);
     RUN_TEST(send_then_recv_nb);
+    RUN_TEST(send_signals_receiver);
     RUN_TEST(send_invalid_id);
     RUN_TEST(send_null_msg);
     RUN_TEST(recv_nb_null);
@@ -0,0 +1,125 @@
+/* test_overlay.c - text VRAM overlay plane.
+ *
+ * The text planes and the video controller registers are RAM in the
+ * native build.
+ * Each shape is compared with a per-pixel reference, and the overlay must
+ * never touch the graphics page underneath. */
+
+#include "ssos_test.h"
+#include "gfx.h"
+#include "profile.h"
+#include "overlay.h"
+
+static int plane_pixel(int x, int y) {
+    uint16_t w = SS_TVRAM_BASE[(uint32_t)y * SS_TVRAM_WORDS_PER_LINE + (uint32_t)(x >> 4)];
+    return (w >> (15 - (x & 15))) & 1;
+}
+
+static void reset_overlay(void) {
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    *SS_VC_PRIORITY = 0x12E4;
+    *SS_VC_LAYERS = 0x001E;
+    SS_TEXT_PAL_BASE[1] = 0x0842;
+    ss_overlay_init();
+}
+
+TEST(overlay_init_enables_text_layer_and_shutdown_restores) {
+    /* Text the host left in any plane would show over the graphics. */
+    for (int plane = 0; plane < SS_TVRAM_PLANES; plane++)
+        SS_TVRAM_BASE[(uint32_t)plane * SS_TVRAM_PLANE_WORDS + 5 * SS_TVRAM_WORDS_PER_LINE] = 0xFFFF;
+    reset_overlay();
+    ASSERT_TRUE(ss_overlay_active());
+    ASSERT_EQ(*SS_VC_LAYERS & 0x0020, 0x0020);
+    ASSERT_EQ(*SS_VC_PRIORITY & 0x00FF, 0x00E4);       /* page order kept */
+    ASSERT_EQ(SS_TEXT_PAL_BASE[1], 0xFFFE);
+    for (int plane = 0; plane < SS_TVRAM_PLANES; plane++)
+        ASSERT_EQ(SS_TVRAM_BASE[(uint32_t)plane * SS_TVRAM_PLANE_WORDS + 5 * SS_TVRAM_WORDS_PER_LINE], 0);
+    ss_overlay_fill(0, 0, 32, 2, 1);
+    ss_overlay_shutdown();
+    ASSERT_FALSE(ss_overlay_active());
+    ASSERT_EQ(*SS_VC_LAYERS, 0x001E);
+    ASSERT_EQ(*SS_VC_PRIORITY, 0x12E4);
+    ASSERT_EQ(SS_TEXT_PAL_BASE[1], 0x0842);
+    /* The planes are the caller's: shutdown does not wipe them. */
+    ASSERT_EQ(plane_pixel(0, 0), 1);
+}
+
+TEST(overlay_fill_matches_reference_at_word_edges) {
+    static const int spans[][2] = {
+        { 3, 5 }, { 14, 4 }, { 16, 16 }, { 5, 40 }, { 0, 48 }, { 31, 1 },
+    };
+    for (unsigned s = 0; s < sizeof(spans) / sizeof(spans[0]); s++) {
+        reset_overlay();
+        ss_overlay_fill(0, 10, 80, 1, 1);
+        int x = spans[s][0], w = spans[s][1];
+        ss_overlay_fill(x, 10, w, 1, 0);
+        for (int px = 0; px < 96; px++) {
+            int want = px < 80 && !(px >= x && px < x + w);
+            ASSERT_EQ(plane_pixel(px, 10), want);
+        }
+        ASSERT_EQ(plane_pixel(0, 9), 0);
+        ASSERT_EQ(plane_pixel(0, 11), 0);
+    }
+}
+
+TEST(overlay_aligned_span_is_one_word_write_and_no_gvram) {
+    SSGfxProfile p;
+    reset_overlay();
+    ss_gfx_profile_reset();
+    ss_overlay_fill(32, 20, 16, 1, 1);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.overlay_words_written, 1u);
+    ASSERT_EQ(p.overlay_words_read, 0u);
+
+    /* A frame and its erase leave GVRAM alone; XOR reads and writes the
+     * perimeter twice. */
+    ss_gfx_profile_reset();
+    ss_overlay_frame(40, 40, 100, 50, 1);
+    ss_overlay_frame(40, 40, 100, 50, 0);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.gvram_words_read, 0u);
+    ASSERT_EQ(p.gvram_words_written, 0u);
+    ASSERT_TRUE(p.overlay_words_written > 0);
+    for (int y = 38; y < 92; y++) {
+        for (int x = 38; x < 142; x++) ASSERT_EQ(plane_pixel(x, y), 0);
+    }
+}
+
+TEST(overlay_frame_draws_perimeter_only) {
+    reset_overlay();
+    ss_overlay_frame(7, 5, 20, 6, 1);
+    for (int y = 4; y < 12; y++) {
+        for (int x = 6; x < 28; x++) {
+            int in = x >= 7 && x < 27 && y >= 5 && y < 11;
+            int edge = in && (x == 7 || x == 26 || y == 5 || y == 10);
+            ASSERT_EQ(plane_pixel(x, y), edge);
+        }
+    }
+}
+
+TEST(overlay_text_sets_glyph_pixels_and_clips) {
+    reset_overlay();
+    /* 'H' straddles a word boundary at x = 13. */
+    ss_overlay_text(13, 30, "H");
+    for (int r = 0; r < SS_FONT_H; r++) {
+        uint8_t g = ss_font_data['H' - 0x20][r];
+        for (int c = 0; c < SS_FONT_W; c++) {
+            ASSERT_EQ(plane_pixel(13 + c, 30 + r), (g >> (7 - c)) & 1);
+        }
+    }
+    /* Off-screen columns and rows are dropped, not wrapped. */
+    int W = ss_current_mode->display_w;
+    ss_overlay_text(-3, -2, "HH");
+    ss_overlay_text(W - 3, 100, "H");
+    ASSERT_EQ(plane_pixel(SS_FONT_ADV - 3, 0), (ss_font_data['H' - 0x20][2] >> 7) & 1);
+    ASSERT_EQ(plane_pixel(0, 101), 0);
+}
+
+void run_overlay_tests(void) {
+    RUN_TEST(overlay_init_enables_text_layer_and_shutdown_restores);
+    RUN_TEST(overlay_fill_matches_reference_at_word_edges);
+    RUN_TEST(overlay_aligned_span_is_one_word_write_and_no_gvram);
+    RUN_TEST(overlay_frame_draws_perimeter_only);
+    RUN_TEST(overlay_text_sets_glyph_pixels_and_clips);
+}
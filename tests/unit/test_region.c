@@ -0,0 +1,286 @@
+/* test_region.c - rectangle-list region algebra.
+ *
+ * Every operation is checked against a brute-force bitmap oracle on a
+ * small grid: random rectangle sets are rasterised, combined bit by bit,
+ * and compared pixel for pixel with the region result.  Each result must
+ * also be in canonical y-x banded form, since the band sweep relies on
+ * it for its inputs. */
+
+#include "ssos_test.h"
+#include "gfx.h"
+#include "region.h"
+
+#define GRID_W 48
+#define GRID_H 40
+#define GRID_OFF 4      /* rects may start at -GRID_OFF */
+
+typedef uint8_t Bitmap[GRID_H][GRID_W];
+
+static uint32_t lcg_state;
+
+static int lcg(int n) {
+    lcg_state = lcg_state * 1103515245u + 12345u;
+    return (int)((lcg_state >> 16) % (uint32_t)n);
+}
+
+static SSGfxRect random_rect(void) {
+    SSGfxRect r;
+    r.x = lcg(GRID_W - GRID_OFF) - GRID_OFF;
+    r.y = lcg(GRID_H - GRID_OFF) - GRID_OFF;
+    r.w = lcg(20);
+    r.h = lcg(16);
+    return r;
+}
+
+static void bitmap_rect(Bitmap bm, SSGfxRect r, int value) {
+    for (int y = r.y; y < r.y + r.h; y++) {
+        for (int x = r.x; x < r.x + r.w; x++) {
+            int gx = x + GRID_OFF, gy = y + GRID_OFF;
+            if (gx >= 0 && gx < GRID_W && gy >= 0 && gy < GRID_H) bm[gy][gx] = (uint8_t)value;
+        }
+    }
+}
+
+/* Random region built by union_rect, mirrored into its bitmap. */
+static void random_region(SSRegion* r, Bitmap bm, int rects) {
+    memset(bm, 0, sizeof(Bitmap));
+    ss_region_init(r);
+    for (int i = 0; i < rects; i++) {
+        SSGfxRect rect = random_rect();
+        ss_region_union_rect(r, rect);
+        bitmap_rect(bm, rect, 1);
+    }
+}
+
+/* Number of grid pixels where the region and the bitmap disagree. */
+static int bitmap_mismatches(const SSRegion* r, Bitmap bm) {
+    int bad = 0;
+    for (int gy = 0; gy < GRID_H; gy++) {
+        for (int gx = 0; gx < GRID_W; gx++) {
+            if (ss_region_contains(r, gx - GRID_OFF, gy - GRID_OFF) != bm[gy][gx]) bad++;
+        }
+    }
+    return bad;
+}
+
+/* 1 when boxes are non-empty, sorted, banded, non-touching in a band and
+ * vertically coalesced. */
+static int region_is_canonical(const SSRegion* r) {
+    for (int i = 0; i < r->count; i++) {
+        const SSRegionBox* b = &r->box[i];
+        if (b->x0 >= b->x1 || b->y0 >= b->y1) return 0;
+        if (i == 0) continue;
+        const SSRegionBox* p = &r->box[i - 1];
+        if (b->y0 == p->y0) {
+            if (b->y1 != p->y1 || b->x0 <= p->x1) return 0;
+        } else if (b->y0 < p->y1) {
+            return 0;
+        }
+    }
+    /* Coalescing: adjacent bands with the same spans must have merged. */
+    int start = 0;
+    int pstart = -1, pn = 0;
+    while (start < r->count) {
+        int end = start + 1;
+        while (end < r->count && r->box[end].y0 == r->box[start].y0) end++;
+        int n = end - start;
+        if (pstart >= 0 && pn == n && r->box[pstart].y1 == r->box[start].y0) {
+            int same = 1;
+            for (int k = 0; k < n; k++) {
+                if (r->box[pstart + k].x0 != r->box[start + k].x0 ||
+                    r->box[pstart + k].x1 != r->box[start + k].x1) same = 0;
+            }
+            if (same) return 0;
+        }
+        pstart = start;
+        pn = n;
+        start = end;
+    }
+    return 1;
+}
+
+static uint32_t bitmap_area(Bitmap bm) {
+    uint32_t area = 0;
+    for (int gy = 0; gy < GRID_H; gy++)
+        for (int gx = 0; gx < GRID_W; gx++) area += bm[gy][gx];
+    return area;
+}
+
+TEST(region_set_rect_and_empty) {
+    SSRegion r;
+    ss_region_set_rect(&r, (SSGfxRect){ 3, 4, 0, 5 });
+    ASSERT_TRUE(ss_region_is_empty(&r));
+    ss_region_set_rect(&r, (SSGfxRect){ 3, 4, 5, 6 });
+    ASSERT_EQ(r.count, 1);
+    ASSERT_EQ(ss_region_area(&r), 30u);
+    ASSERT_TRUE(ss_region_contains(&r, 3, 4));
+    ASSERT_FALSE(ss_region_contains(&r, 8, 4));
+    SSGfxRect e = ss_region_extents(&r);
+    ASSERT_EQ(e.x, 3);
+    ASSERT_EQ(e.w, 5);
+    ASSERT_EQ(e.h, 6);
+}
+
+TEST(region_union_coalesces_abutting_rects) {
+    SSRegion r;
+    ss_region_set_rect(&r, (SSGfxRect){ 0, 0, 10, 5 });
+    ss_region_union_rect(&r, (SSGfxRect){ 10, 0, 6, 5 });   /* touches right */
+    ss_region_union_rect(&r, (SSGfxRect){ 0, 5, 16, 3 });   /* touches below */
+    ASSERT_EQ(r.count, 1);
+    ASSERT_EQ(r.box[0].x1, 16);
+    ASSERT_EQ(r.box[0].y1, 8);
+}
+
+TEST(region_subtract_punches_hole_into_four_boxes) {
+    SSRegion r;
+    ss_region_set_rect(&r, (SSGfxRect){ 0, 0, 10, 10 });
+    ss_region_subtract_rect(&r, (SSGfxRect){ 3, 3, 4, 4 });
+    /* Top band, two middle spans, bottom band. */
+    ASSERT_EQ(r.count, 4);
+    ASSERT_EQ(ss_region_area(&r), 84u);
+    ASSERT_TRUE(region_is_canonical(&r));
+    ASSERT_FALSE(ss_region_contains(&r, 5, 5));
+    ASSERT_TRUE(ss_region_contains(&r, 2, 5));
+}
+
+TEST(region_ops_match_bitmap_oracle) {
+    static Bitmap ba, bb, bo;
+    SSRegion a, b, r;
+    lcg_state = 0x5eed;
+    for (int iter = 0; iter < 300; iter++) {
+        random_region(&a, ba, 1 + lcg(5));
+        random_region(&b, bb, 1 + lcg(5));
+        if (a.overflow || b.overflow) continue;
+        ASSERT_EQ(bitmap_mismatches(&a, ba), 0);
+        ASSERT_TRUE(region_is_canonical(&a));
+
+        for (int op = 0; op < 3; op++) {
+            for (int gy = 0; gy < GRID_H; gy++) {
+                for (int gx = 0; gx < GRID_W; gx++) {
+                    int va = ba[gy][gx], vb = bb[gy][gx];
+                    bo[gy][gx] = (uint8_t)(op == 0 ? (va | vb)
+                                         : op == 1 ? (va & vb) : (va & !vb));
+                }
+            }
+            if (op == 0) ss_region_union(&r, &a, &b);
+            else if (op == 1) ss_region_intersect(&r, &a, &b);
+            else ss_region_subtract(&r, &a, &b);
+            if (r.overflow) continue;
+            ASSERT_EQ(bitmap_mismatches(&r, bo), 0);
+            ASSERT_TRUE(region_is_canonical(&r));
+            ss_region_intersect_rect(&r, (SSGfxRect){ -GRID_OFF, -GRID_OFF, GRID_W, GRID_H });
+            ASSERT_EQ(ss_region_area(&r), bitmap_area(bo));
+        }
+    }
+}
+
+TEST(region_ops_allow_dst_alias) {
+    static Bitmap ba, bb;
+    SSRegion a, b, expect;
+    lcg_state = 77;
+    for (int iter = 0; iter < 50; iter++) {
+        random_region(&a, ba, 4);
+        random_region(&b, bb, 4);
+        ss_region_subtract(&expect, &a, &b);
+        ss_region_subtract(&a, &a, &b);
+        ASSERT_EQ(a.count, expect.count);
+        ASSERT_EQ(memcmp(a.box, expect.box, a.count * sizeof(SSRegionBox)), 0);
+        ss_region_union(&b, &a, &b);
+        ASSERT_TRUE(region_is_canonical(&b));
+    }
+}
+
+TEST(region_translate_and_extents_follow_bitmap) {
+    static Bitmap bm;
+    SSRegion r, moved;
+    lcg_state = 4242;
+    random_region(&r, bm, 6);
+    ss_region_copy(&moved, &r);
+    ss_region_translate(&moved, -3, 2);
+    for (int y = -GRID_OFF; y < GRID_H; y++) {
+        for (int x = -GRID_OFF; x < GRID_W; x++) {
+            ASSERT_EQ(ss_region_contains(&moved, x, y), ss_region_contains(&r, x + 3, y - 2));
+        }
+    }
+    ASSERT_EQ(ss_region_area(&moved), ss_region_area(&r));
+
+    SSGfxRect e = ss_region_extents(&moved);
+    for (int i = 0; i < moved.count; i++) {
+        SSGfxRect b = ss_region_rect(&moved, i);
+        ASSERT_TRUE(b.x >= e.x && b.x + b.w <= e.x + e.w);
+        ASSERT_TRUE(b.y >= e.y && b.y + b.h <= e.y + e.h);
+    }
+}
+
+TEST(region_overflow_falls_back_to_covering_box) {
+    SSRegion r;
+    ss_region_init(&r);
+    /* A diagonal staircase needs one band per step. */
+    for (int i = 0; i <= SS_REGION_MAX_BOXES; i++) {
+        ss_region_union_rect(&r, (SSGfxRect){ i * 2, i, 1, 1 });
+    }
+    ASSERT_TRUE(r.overflow);
+    for (int i = 0; i <= SS_REGION_MAX_BOXES; i++) {
+        ASSERT_TRUE(ss_region_contains(&r, i * 2, i));
+    }
+    /* The flag sticks through later operations. */
+    ss_region_intersect_rect(&r, (SSGfxRect){ 0, 0, 4, 4 });
+    ASSERT_TRUE(r.overflow);
+}
+
+static uint16_t pixel(int x, int y) {
+    return ss_draw_page[(uint32_t)y * (ss_current_mode->bytes_per_line / 2) + (uint32_t)x];
+}
+
+TEST(region_clipped_primitives_draw_only_inside) {
+    SSRegion clip;
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_gfx_clear(0x1111);
+    ss_region_set_rect(&clip, (SSGfxRect){ 10, 10, 30, 20 });
+    ss_region_subtract_rect(&clip, (SSGfxRect){ 18, 14, 6, 6 });
+
+    ss_gfx_rect_rgn((SSGfxRect){ 5, 5, 40, 30 }, &clip, 0x2222);
+    for (int y = 5; y < 35; y++) {
+        for (int x = 5; x < 45; x++) {
+            ASSERT_EQ(pixel(x, y), ss_region_contains(&clip, x, y) ? 0x2222 : 0x1111);
+        }
+    }
+
+    ss_gfx_clear(0x1111);
+    ss_gfx_fill_stipple_rgn((SSGfxRect){ 5, 5, 40, 30 }, &clip, 0x0A0A, 0x0B0B);
+    for (int y = 5; y < 35; y++) {
+        for (int x = 5; x < 45; x++) {
+            uint16_t want = ss_region_contains(&clip, x, y)
+                                ? (((x + y) & 1) ? 0x0A0A : 0x0B0B) : 0x1111;
+            ASSERT_EQ(pixel(x, y), want);
+        }
+    }
+
+    /* Text matches the unclipped run wherever the region admits it. */
+    static uint16_t ref[SS_FONT_H][40];
+    ss_gfx_clear(0x1111);
+    ss_gfx_draw_text_fast(11, 13, "region", 0x2222, 0x3333);
+    for (int r = 0; r < SS_FONT_H; r++)
+        for (int c = 0; c < 40; c++) ref[r][c] = pixel(8 + c, 13 + r);
+    ss_gfx_clear(0x1111);
+    ss_gfx_draw_text_rgn(11, 13, "region", 0x2222, 0x3333, &clip);
+    for (int r = 0; r < SS_FONT_H; r++) {
+        for (int c = 0; c < 40; c++) {
+            int x = 8 + c, y = 13 + r;
+            int in = x >= 11 && x < 11 + 6 * SS_FONT_ADV && ss_region_contains(&clip, x, y);
+            ASSERT_EQ(pixel(x, y), in ? ref[r][c] : 0x1111);
+        }
+    }
+}
+
+void run_region_tests(void) {
+    RUN_TEST(region_set_rect_and_empty);
+    RUN_TEST(region_union_coalesces_abutting_rects);
+    RUN_TEST(region_subtract_punches_hole_into_four_boxes);
+    RUN_TEST(region_ops_match_bitmap_oracle);
+    RUN_TEST(region_ops_allow_dst_alias);
+    RUN_TEST(region_translate_and_extents_follow_bitmap);
+    RUN_TEST(region_overflow_falls_back_to_covering_box);
+    RUN_TEST(region_clipped_primitives_draw_only_inside);
+}
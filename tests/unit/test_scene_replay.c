@@ -0,0 +1,287 @@
+/* test_scene_replay.c - headless replay of a recorded input trace.
+ *
+ * A scripted session (drag the Mouse window by its title, type two keys)
+ * is recorded through the input ring, then replayed into the real scene
+ * loop twice.  Both replays must land on the same frames, counters and
+ * framebuffer hash; the SSPERF lines are what a UI change is compared
+ * on.  The same drag is also driven through the faked IOCS mouse, which
+ * covers the scene's own IOCS input producer, and again with a step the
+ * opaque drag cannot afford, which must fall back to the outline. */
+
+#include "ssos_test.h"
+#include "gfx.h"
+#include "profile.h"
+#include "win.h"
+#include "scene.h"
+#include "input.h"
+#include "input_trace.h"
+#include "kernel.h"
+#include "fake_iocs.h"
+#include "overlay.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SETTLE_FRAMES 4
+
+static uint8_t trace_buf[512];
+static uint32_t trace_len;
+
+typedef struct {
+    uint32_t vsync;
+    SSInputEvent ev;
+} Step;
+
+/* Mouse window: (80,120) 240 wide, title bar 12 high. */
+static const Step session[] = {
+    {  2, { SS_INPUT_MOTION, 0, 100, 125, 0, 0 } },
+    {  3, { SS_INPUT_BUTTON, SS_INPUT_LEFT, 100, 125, 0, 0 } },
+    {  4, { SS_INPUT_MOTION, SS_INPUT_LEFT, 110, 130, 0, 0 } },
+    {  5, { SS_INPUT_MOTION, SS_INPUT_LEFT, 130, 140, 0, 0 } },
+    {  5, { SS_INPUT_MOTION, SS_INPUT_LEFT, 140, 150, 0, 0 } },
+    {  7, { SS_INPUT_BUTTON, 0, 140, 150, 0, 0 } },
+    { 40, { SS_INPUT_KEY, 0, 140, 150, 0x1E61, 0 } },
+    {300, { SS_INPUT_KEY, 0, 140, 150, 0x3062, 0 } },
+};
+
+/* What the scene would have consumed: post each step on its vsync and
+ * poll it back, which is where the trace records. */
+static void record_session(void) {
+    SSInputTrace t;
+    SSInputEvent ev;
+    ss_input_init(NULL);
+    ss_vsync_counter = 1000;
+    ASSERT_EQ(ss_trace_record(&t, trace_buf, sizeof(trace_buf)), (int16_t)SS_OK);
+    for (size_t i = 0; i < sizeof(session) / sizeof(session[0]); i++) {
+        ss_vsync_counter = 1000 + session[i].vsync;
+        ss_input_post(&session[i].ev);
+        while (ss_input_poll(&ev) == SS_OK) {}
+    }
+    ss_trace_stop();
+    ASSERT_FALSE(t.overflow);
+    trace_len = t.len;
+}
+
+typedef struct {
+    SSInputTrace trace;
+    uint32_t settle;
+} Replay;
+
+static int replay_wait_vsync(void* ctx) {
+    (void)ctx;
+    ss_vsync_counter++;
+    return 0;
+}
+
+static int replay_should_stop(void* ctx) {
+    Replay* r = ctx;
+    return ss_trace_done(&r->trace) && r->settle++ >= SETTLE_FRAMES;
+}
+
+typedef struct {
+    SSSceneStats stats;
+    SSGfxProfile prof;
+    uint32_t hash;
+    int mouse_x, mouse_y;
+} ReplayResult;
+
+/* FNV-1a over the visible part of the displayed page. */
+static uint32_t frame_hash(void) {
+    uint32_t h = 2166136261UL;
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    for (int y = 0; y < ss_current_mode->display_h; y++) {
+        for (int x = 0; x < ss_current_mode->display_w; x++) {
+            uint16_t px = ss_display_page[(uint32_t)y * stride + (uint32_t)x];
+            h = (h ^ (px & 0xFF)) * 16777619UL;
+            h = (h ^ (px >> 8)) * 16777619UL;
+        }
+    }
+    return h;
+}
+
+static void replay(ReplayResult* out) {
+    Replay r;
+    SSInputSource src;
+    memset(&r, 0, sizeof(r));
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    ss_vsync_counter = 0;
+    ASSERT_EQ(ss_trace_open(&r.trace, trace_buf, trace_len), (int16_t)SS_OK);
+    src = ss_trace_source(&r.trace);
+    SSSceneHooks hooks = { replay_wait_vsync, replay_should_stop, &r, &src };
+
+    ss_gfx_profile_reset();
+    ss_scene_run(&hooks, &out->stats);
+    ss_gfx_profile_snapshot(&out->prof);
+    out->hash = frame_hash();
+    out->mouse_x = ss_win_get_x(3);
+    out->mouse_y = ss_win_get_y(3);
+
+    printf("SSPERF replay events=%lu frames=%lu rendered=%lu skipped=%lu\n",
+           (unsigned long)r.trace.events, (unsigned long)out->stats.frames,
+           (unsigned long)out->stats.rendered, (unsigned long)out->stats.skipped);
+    printf("SSPERF replay gvram read=%lu write=%lu text=%lu hash=%08lx\n",
+           (unsigned long)out->prof.gvram_words_read,
+           (unsigned long)out->prof.gvram_words_written,
+           (unsigned long)out->prof.text_calls, (unsigned long)out->hash);
+}
+
+TEST(trace_is_compact_and_rejects_foreign_data) {
+    SSInputTrace t;
+    record_session();
+    /* Header, six pointer events, two keys and one gap before the last
+     * key, which comes 260 vsyncs after the one before. */
+    ASSERT_EQ(trace_len, (uint32_t)(SS_TRACE_HEADER + 6 * 6 + 2 * 4 + 1));
+    trace_buf[4] = SS_TRACE_VERSION + 1;
+    ASSERT_EQ(ss_trace_open(&t, trace_buf, trace_len), (int16_t)SS_ERR_PARAM);
+    trace_buf[4] = SS_TRACE_VERSION;
+    ASSERT_EQ(ss_trace_open(&t, trace_buf, 3), (int16_t)SS_ERR_PARAM);
+}
+
+TEST(scene_replay_is_deterministic) {
+    ReplayResult a, b;
+    record_session();
+    replay(&a);
+    replay(&b);
+
+    /* The drag moved the window by the pointer's travel. */
+    ASSERT_EQ(a.mouse_x, 80 + 40);
+    ASSERT_EQ(a.mouse_y, 120 + 25);
+    ASSERT_EQ(ss_scene_last_key(), 0x3062);
+    ASSERT_EQ(a.stats.frames, 300u + SETTLE_FRAMES);
+    ASSERT_TRUE(a.stats.skipped > a.stats.rendered);
+
+    ASSERT_EQ(a.hash, b.hash);
+    ASSERT_EQ(a.stats.rendered, b.stats.rendered);
+    ASSERT_EQ(a.prof.gvram_words_written, b.prof.gvram_words_written);
+    ASSERT_EQ(a.prof.gvram_words_read, b.prof.gvram_words_read);
+}
+
+static int iocs_wait_vsync(void* ctx) {
+    uint32_t* n = ctx;
+    ss_vsync_counter++;
+    (*n)++;
+    if (*n == 2) ss_fake_mouse(100, 125, 0);
+    if (*n == 3) ss_fake_mouse(100, 125, SS_INPUT_LEFT);
+    if (*n == 5) ss_fake_mouse(140, 150, SS_INPUT_LEFT);
+    if (*n == 7) ss_fake_mouse(140, 150, 0);
+    if (*n == 8) ss_fake_key(0x1E61);
+    return 0;
+}
+
+static int iocs_should_stop(void* ctx) {
+    return *(uint32_t*)ctx >= 12;
+}
+
+TEST(scene_reads_the_iocs_mouse_and_keyboard) {
+    uint32_t n = 0;
+    SSSceneStats stats;
+    SSSceneHooks hooks = { iocs_wait_vsync, iocs_should_stop, &n, NULL };
+    ss_fake_iocs_reset();
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    ss_scene_run(&hooks, &stats);
+
+    ASSERT_EQ(ss_win_get_x(3), 80 + 40);
+    ASSERT_EQ(ss_win_get_y(3), 120 + 25);
+    ASSERT_EQ(ss_scene_last_key(), 0x1E61);
+    ASSERT_EQ(stats.vsyncs, n);
+}
+
+/* One drag of the Mouse window by (dx, dy), taken in a single step on
+ * frame 5; the window and outline are sampled on frame 7, mid-drag, and
+ * the button is released on frame 8.  miss makes the step's frame late. */
+typedef struct {
+    uint32_t n;
+    int dx, dy, miss;
+    int mid_x, mid_y, mid_outline;
+} DragRun;
+
+/* Overlay pixel (plane 0, leftmost pixel in bit 15). */
+static int tvram_px(int x, int y) {
+    uint16_t w = ss_overlay_test_tvram[(uint32_t)y * SS_TVRAM_WORDS_PER_LINE + (uint32_t)(x >> 4)];
+    return (w >> (15 - (x & 15))) & 1;
+}
+
+/* All four corners of a Mouse-window-sized frame at (x, y). */
+static int outline_at(int x, int y) {
+    int w = ss_win_get_w(3), h = ss_win_get_h(3);
+    return tvram_px(x, y) && tvram_px(x + w - 1, y) &&
+           tvram_px(x, y + h - 1) && tvram_px(x + w - 1, y + h - 1);
+}
+
+static int any_outline_at(int x, int y) {
+    int w = ss_win_get_w(3), h = ss_win_get_h(3);
+    return tvram_px(x, y) || tvram_px(x + w - 1, y) ||
+           tvram_px(x, y + h - 1) || tvram_px(x + w - 1, y + h - 1);
+}
+
+static int drag_wait_vsync(void* ctx) {
+    DragRun* r = ctx;
+    ss_vsync_counter++;
+    r->n++;
+    if (r->n == 2) ss_fake_mouse(100, 125, 0);
+    if (r->n == 3) ss_fake_mouse(100, 125, SS_INPUT_LEFT);
+    if (r->n == 5) {
+        if (r->miss) ss_vsync_counter++;
+        ss_fake_mouse(100 + r->dx, 125 + r->dy, SS_INPUT_LEFT);
+    }
+    if (r->n == 7) {
+        r->mid_x = ss_win_get_x(3);
+        r->mid_y = ss_win_get_y(3);
+        r->mid_outline = outline_at(80 + r->dx, 120 + r->dy);
+        ss_fake_mouse(100 + r->dx, 125 + r->dy, 0);
+    }
+    return 0;
+}
+
+static int drag_should_stop(void* ctx) {
+    return ((DragRun*)ctx)->n >= 10;
+}
+
+static void drag_run(DragRun* r) {
+    SSSceneStats stats;
+    SSSceneHooks hooks = { drag_wait_vsync, drag_should_stop, r, NULL };
+    ss_fake_iocs_reset();
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    ss_scene_run(&hooks, &stats);
+}
+
+TEST(drag_over_budget_falls_back_to_outline) {
+    DragRun r = { 0, 0, 60, 0, 0, 0, 0 };
+    /* 240x48 window: moving 60 rows costs 240*48 + 60*240 words. */
+    ASSERT_TRUE(240u * 48u + 60u * 240u > SS_SCENE_DRAG_BUDGET_WORDS);
+    drag_run(&r);
+
+    ASSERT_EQ(r.mid_x, 80);
+    ASSERT_EQ(r.mid_y, 120);
+    ASSERT_TRUE(r.mid_outline);
+    ASSERT_EQ(ss_win_get_x(3), 80);
+    ASSERT_EQ(ss_win_get_y(3), 120 + 60);
+    ASSERT_FALSE(any_outline_at(80, 120 + 60));
+}
+
+TEST(drag_on_missed_frame_falls_back_to_outline) {
+    DragRun r = { 0, 10, 5, 1, 0, 0, 0 };
+    /* Cheap enough for an opaque move, but its frame came late. */
+    ASSERT_TRUE(240u * 48u + 10u * 48u + 5u * 240u <= SS_SCENE_DRAG_BUDGET_WORDS);
+    drag_run(&r);
+
+    ASSERT_EQ(r.mid_x, 80);
+    ASSERT_EQ(r.mid_y, 120);
+    ASSERT_TRUE(r.mid_outline);
+    ASSERT_EQ(ss_win_get_x(3), 80 + 10);
+    ASSERT_EQ(ss_win_get_y(3), 120 + 5);
+    ASSERT_FALSE(any_outline_at(80 + 10, 120 + 5));
+}
+
+void run_scene_replay_tests(void) {
+    RUN_TEST(trace_is_compact_and_rejects_foreign_data);
+    RUN_TEST(scene_replay_is_deterministic);
+    RUN_TEST(scene_reads_the_iocs_mouse_and_keyboard);
+    RUN_TEST(drag_over_budget_falls_back_to_outline);
+    RUN_TEST(drag_on_missed_frame_falls_back_to_outline);
+}
@@ -235,6 +235,86 @@ TEST(task_sleep_wakes_across_tick_wrap) {
     ASSERT_EQ(sleeper->state, SS_TS_READY);
 }
 
+/* ---- signal / wait ---- */
+
+TEST(task_wait_blocks_until_signalled) {
+    ss_sched_init();
+    uint16_t a = make_task(1);
+    uint16_t b = make_task(1);
+    ss_task_start(a);
+    ss_task_start(b);
+    SSTask* t = &tcb_table[a - 1];
+
+    /* Nothing signalled: blocks (the stub yield returns at once, with
+     * nothing taken). */
+    ASSERT_EQ(ss_task_wait(100), 0);
+    ASSERT_EQ(t->state, SS_TS_WAIT);
+    ASSERT_EQ(ss_curr_task, &tcb_table[b - 1]);
+    ADVANCE_TICK(1);
+    ss_do_wakeups();
+    ASSERT_EQ(t->state, SS_TS_WAIT);
+
+    /* A signal makes it due long before the timeout, and the bits wait
+     * for it to resume. */
+    ss_task_signal(t, SS_SIG_INPUT);
+    ss_do_wakeups();
+    ASSERT_EQ(t->state, SS_TS_READY);
+    ASSERT_EQ(t->sig_wait, 0);
+    ASSERT_EQ(t->signals, SS_SIG_INPUT);
+}
+
+TEST(task_wait_takes_pending_signals_without_blocking) {
+    ss_sched_init();
+    uint16_t a = make_task(1);
+    uint16_t b = make_task(1);
+    ss_task_start(a);
+    ss_task_start(b);
+    SSTask* t = &tcb_table[a - 1];
+
+    ss_task_signal(t, SS_SIG_MSG);
+    ss_task_signal(t, SS_SIG_DAMAGE);
+    uint16_t got = ss_task_wait(100);
+    ASSERT_EQ(got, SS_SIG_MSG | SS_SIG_DAMAGE);
+    ASSERT_EQ(t->state, SS_TS_READY);
+    ASSERT_EQ(t->signals, 0);
+    ASSERT_EQ(ss_curr_task, t);
+}
+
+TEST(task_wait_times_out) {
+    ss_sched_init();
+    uint16_t a = make_task(1);
+    uint16_t b = make_task(1);
+    ss_task_start(a);
+    ss_task_start(b);
+    SSTask* t = &tcb_table[a - 1];
+
+    ss_task_wait(6);
+    ADVANCE_TICK(5);
+    ss_do_wakeups();
+    ASSERT_EQ(t->state, SS_TS_WAIT);
+    ADVANCE_TICK(1);
+    ss_do_wakeups();
+    ASSERT_EQ(t->state, SS_TS_READY);
+    ASSERT_EQ(t->signals, 0);
+}
+
+TEST(task_signal_leaves_plain_sleep_alone) {
+    ss_sched_init();
+    uint16_t a = make_task(1);
+    uint16_t b = make_task(1);
+    ss_task_start(a);
+    ss_task_start(b);
+    SSTask* t = &tcb_table[a - 1];
+    uint32_t due = ss_tick_counter + 10;
+
+    ASSERT_EQ(ss_task_sleep(10), (uint16_t)SS_OK);
+    ss_task_signal(t, SS_SIG_MSG);
+    ss_task_signal(NULL, SS_SIG_MSG);
+    ss_do_wakeups();
+    ASSERT_EQ(t->state, SS_TS_WAIT);
+    ASSERT_EQ(t->wait_until, due);
+}
+
 void run_scheduler_tests(void) {
     RUN_TEST(sched_init_clears_state);
     RUN_TEST(pick_empty_returns_null);
@@ -255,4 +335,8 @@ void run_scheduler_tests(void) {
     RUN_TEST(task_sleep_without_runnable_peer_fails);
     RUN_TEST(task_sleep_rejects_ambiguous_long_delay);
     RUN_TEST(task_sleep_wakes_across_tick_wrap);
+    RUN_TEST(task_wait_blocks_until_signalled);
+    RUN_TEST(task_wait_takes_pending_signals_without_blocking);
+    RUN_TEST(task_wait_times_out);
+    RUN_TEST(task_signal_leaves_plain_sleep_alone);
 }
@@ -0,0 +1,66 @@
+/* test_textgrid.c - character grid of text windows.
+ *
+ * Only cells whose character changes may be marked, wherever they are in
+ * the line, and the runs handed to renderers must cover exactly the
+ * marked cells. */
+
+#include "ssos_test.h"
+#include "textgrid.h"
+
+static SSTextGrid g;
+
+TEST(tgrid_set_line_marks_only_changed_cells) {
+    uint32_t mask;
+    ss_tgrid_init(&g);
+    ASSERT_EQ(g.dirty[0], 0u);
+    ASSERT_EQ(g.cell[0][SS_TGRID_COLS], '\0');
+
+    /* The space after the colon matches the blank row. */
+    ss_tgrid_set_line(&g, 0, "Tick: 12345");
+    mask = ss_tgrid_take(&g, 0);
+    ASSERT_EQ(mask, 0x7DFu);
+    ASSERT_EQ(g.dirty[0], 0u);
+
+    /* A change at the end and one at the start each mark one cell. */
+    ss_tgrid_set_line(&g, 0, "Tick: 12346");
+    mask = ss_tgrid_take(&g, 0);
+    ASSERT_EQ(mask, 1u << 10);
+    ss_tgrid_set_line(&g, 0, "Tock: 12346");
+    mask = ss_tgrid_take(&g, 0);
+    ASSERT_EQ(mask, 1u << 1);
+
+    /* Shrinking marks the cells it vacates; they become spaces. */
+    ss_tgrid_set_line(&g, 0, "Tock: 9");
+    mask = ss_tgrid_take(&g, 0);
+    ASSERT_EQ(mask, 0x7C0u);
+    ASSERT_EQ(g.cell[0][8], ' ');
+
+    /* Marks accumulate until taken; long lines are cut at the grid. */
+    ss_tgrid_set_line(&g, 1, "abcdefghijklmnopqrstuvwxyz0123456789");
+    ss_tgrid_set_line(&g, 1, "abcdefghijklmnopqrstuvwxyz0123456789");
+    mask = ss_tgrid_take(&g, 1);
+    ASSERT_EQ(mask, 0xFFFFFFFFu >> (32 - SS_TGRID_COLS));
+    ASSERT_EQ(g.cell[1][27], '1');
+    ss_tgrid_set_line(&g, 5, "ignored");
+
+    ss_tgrid_mark_all(&g);
+    ASSERT_EQ(g.dirty[2], 0xFFFFFFFFu >> (32 - SS_TGRID_COLS));
+}
+
+TEST(tgrid_runs_coalesce_adjacent_cells) {
+    int first = -1;
+    uint32_t mask = (1u << 2) | (1u << 3) | (1u << 4) | (1u << 9) | (1u << 27);
+    ASSERT_EQ(ss_tgrid_run(mask, 0, &first), 3);
+    ASSERT_EQ(first, 2);
+    ASSERT_EQ(ss_tgrid_run(mask, 5, &first), 1);
+    ASSERT_EQ(first, 9);
+    ASSERT_EQ(ss_tgrid_run(mask, 10, &first), 1);
+    ASSERT_EQ(first, 27);
+    ASSERT_EQ(ss_tgrid_run(mask, 28, &first), 0);
+    ASSERT_EQ(ss_tgrid_run(0, 0, &first), 0);
+}
+
+void run_textgrid_tests(void) {
+    RUN_TEST(tgrid_set_line_marks_only_changed_cells);
+    RUN_TEST(tgrid_runs_coalesce_adjacent_cells);
+}
@@ -8,6 +8,10 @@
 #include "ssos_test.h"
 #include "win.h"
 #include "gfx.h"
+#include "profile.h"
+#include "palette.h"
+#include "kernel.h"
+#include "scheduler.h"
 
 static int render_callback_calls;
 static int render_callback_saw_null;
@@ -65,9 +69,8 @@ TEST(win_destroy_then_reuse_id) {
     ss_win_init();
     uint16_t id = ss_win_create(0, 0, 40, 40, 0);
     ss_win_destroy(id);
-    /* Slot freed: the id field is cleared (get_ptr still returns the slot,
-     * it doesn't check aliveness). */
-    ASSERT_EQ(ss_win_get_ptr(id)->id, 0);
+    /* Slot freed: it belongs to the slab now, so get_ptr refuses it. */
+    ASSERT_NULL(ss_win_get_ptr(id));
     /* Next create reuses the freed slot (lowest free id). */
     uint16_t id2 = ss_win_create(0, 0, 40, 40, 0);
     ASSERT_EQ(id2, id);
@@ -85,6 +88,9 @@ TEST(win_hide_clears_visible) {
 }
 
 TEST(win_move_updates_position_and_dirty) {
+    /* A visible move flushes pending damage and blits, so it draws. */
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
     ss_win_init();
     uint16_t id = ss_win_create(10, 10, 40, 40, 0);
     ss_win_move(id, 100, 200);
@@ -113,6 +119,60 @@ TEST(win_set_z_updates) {
     ASSERT_EQ(ss_win_get_z(id), 7);
 }
 
+TEST(zlist_walks_visible_windows_in_paint_order) {
+    ss_win_init();
+    uint16_t a = ss_win_create(0, 0, 40, 40, 5);
+    uint16_t b = ss_win_create(0, 0, 40, 40, 2);
+    uint16_t c = ss_win_create(0, 0, 40, 40, 5);   /* ties with a, paints later */
+    ASSERT_EQ(ss_win_bottom(), b);
+    ASSERT_EQ(ss_win_above(b), a);
+    ASSERT_EQ(ss_win_above(a), c);
+    ASSERT_EQ(ss_win_above(c), 0);
+    ASSERT_EQ(ss_win_top(), c);
+    ASSERT_EQ(ss_win_hit_test(10, 10), c);
+
+    ss_win_hide(a);
+    ASSERT_EQ(ss_win_above(b), c);
+    ASSERT_EQ(ss_win_below(c), b);
+    ss_win_set_z(b, 9);
+    ASSERT_EQ(ss_win_top(), b);
+    ASSERT_EQ(ss_win_bottom(), c);
+    ss_win_show(a);
+    ss_win_destroy(c);
+    ASSERT_EQ(ss_win_bottom(), a);
+    ASSERT_EQ(ss_win_above(a), b);
+    ASSERT_EQ(ss_win_below(a), 0);
+}
+
+TEST(raise_and_lower_renumber_when_z_runs_out) {
+    ss_win_init();
+    uint16_t a = ss_win_create(0, 0, 40, 40, 1);
+    uint16_t b = ss_win_create(0, 0, 40, 40, 2);
+    uint16_t c = ss_win_create(0, 0, 40, 40, SS_WIN_Z_MAX);
+    ss_win_raise(a);
+    ASSERT_EQ(ss_win_top(), a);
+    ASSERT_TRUE(ss_win_get_z(a) <= SS_WIN_Z_MAX);
+    ASSERT_TRUE(ss_win_get_z(c) < ss_win_get_z(a));
+    ASSERT_TRUE(ss_win_get_z(b) < ss_win_get_z(c));
+    ASSERT_EQ(ss_win_hit_test(10, 10), a);
+
+    ss_win_lower(a);
+    ss_win_lower(c);
+    ASSERT_EQ(ss_win_bottom(), c);
+    ASSERT_EQ(ss_win_above(c), a);
+    ASSERT_EQ(ss_win_top(), b);
+    ASSERT_TRUE(ss_win_get_z(c) >= 1);
+    ASSERT_TRUE(ss_win_get_z(c) < ss_win_get_z(a));
+    ASSERT_TRUE(ss_win_get_z(a) < ss_win_get_z(b));
+    ASSERT_EQ(ss_win_hit_test(10, 10), b);
+
+    /* Raising the top window changes nothing and queues nothing. */
+    SSGfxRect pending[SS_DAMAGE_MAX];
+    ss_win_flush_damage();
+    ss_win_raise(b);
+    ASSERT_EQ(ss_win_pending_damage(pending, SS_DAMAGE_MAX), 0);
+}
+
 /* ---- title / content ---- */
 
 TEST(win_set_title_truncates_to_19) {
@@ -121,8 +181,9 @@ TEST(win_set_title_truncates_to_19) {
     ss_win_set_title(id, "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789");
     SSWindow* w = ss_win_get_ptr(id);
     /* title[20], strncpy(...,19) + NUL. */
-    ASSERT_EQ(w->title[19], '\0');
-    ASSERT_EQ(w->title[0], 'A');
+    ASSERT_NOT_NULL(w->text);
+    ASSERT_EQ(w->text->title[19], '\0');
+    ASSERT_EQ(w->text->title[0], 'A');
 }
 
 TEST(win_set_content_line_pads_to_width) {
@@ -130,20 +191,109 @@ TEST(win_set_content_line_pads_to_width) {
     uint16_t id = ss_win_create(0, 0, 40, 40, 0);
     ss_win_set_content_line(id, 0, "hi");
     SSWindow* w = ss_win_get_ptr(id);
-    ASSERT_EQ(w->content[0][0], 'h');
-    ASSERT_EQ(w->content[0][1], 'i');
-    /* remainder is space-padded up to cap-1 (29). */
-    ASSERT_EQ(w->content[0][29], '\0');
-    ASSERT_EQ(w->content[0][3], ' ');
+    ASSERT_EQ(w->text->content.cell[0][0], 'h');
+    ASSERT_EQ(w->text->content.cell[0][1], 'i');
+    /* remainder is space-padded up to the grid width. */
+    ASSERT_EQ(w->text->content.cell[0][SS_TGRID_COLS], '\0');
+    ASSERT_EQ(w->text->content.cell[0][3], ' ');
+    /* Only the two written cells changed from the blank row. */
+    ASSERT_EQ(w->text->content.dirty[0], 0x3u);
 }
 
 TEST(win_set_content_line_ignores_out_of_range) {
     ss_win_init();
     uint16_t id = ss_win_create(0, 0, 40, 40, 0);
     /* line 5 is out of [0,3) — must be a safe no-op. */
-    ss_win_set_content_line(id, 5, "ignored");
-    /* No crash; content untouched (still zeroed from create). */
-    ASSERT_EQ(ss_win_get_ptr(id)->content[0][0], '\0');
+    int16_t rc = ss_win_set_content_line(id, 5, "ignored");
+    ASSERT_EQ(rc, (int16_t)SS_ERR_PARAM);
+    /* No crash; no text block taken. */
+    ASSERT_NULL(ss_win_get_ptr(id)->text);
+}
+
+TEST(win_text_pool_covers_every_slot_and_is_returned_on_destroy) {
+    int16_t rc;
+    ss_win_init();
+    uint16_t ids[SS_MAX_WINDOWS];
+    for (int i = 0; i < SS_MAX_WINDOWS; i++) {
+        ids[i] = ss_win_create(0, 0, 8, 8, 1);
+        rc = ss_win_set_title(ids[i], "t");
+        ASSERT_EQ(rc, (int16_t)SS_OK);
+    }
+    rc = ss_win_set_content_line(ids[SS_MAX_WINDOWS - 1], 2, "last");
+    ASSERT_EQ(rc, (int16_t)SS_OK);
+    ss_win_destroy(ids[0]);
+    /* A free slot takes no text; the block went back for the next window. */
+    rc = ss_win_set_title(ids[0], "gone");
+    ASSERT_EQ(rc, (int16_t)SS_ERR_PARAM);
+    uint16_t id = ss_win_create(0, 0, 8, 8, 1);
+    ASSERT_NULL(ss_win_get_ptr(id)->text);
+    rc = ss_win_set_title(id, "back");
+    ASSERT_EQ(rc, (int16_t)SS_OK);
+    ASSERT_EQ(ss_win_get_ptr(id)->text->title[0], 'b');
+}
+
+/* A destroyed slot holds the slab's free-list link: calls through its
+ * stale id must not touch it, or the next create hands out garbage. */
+TEST(win_stale_id_leaves_free_slot_alone) {
+    ss_win_init();
+    uint16_t keep = ss_win_create(0, 0, 16, 16, 1);
+    uint16_t gone = ss_win_create(40, 40, 16, 16, 2);
+    ss_win_destroy(gone);
+    ss_win_move(gone, 300, 200);
+    ss_win_show(gone);
+    ss_win_damage(gone, 0, 0, 4, 4);
+    ss_win_mark_dirty(gone);
+    int16_t rc = ss_win_set_title(gone, "stale");
+    ASSERT_EQ(rc, (int16_t)SS_ERR_PARAM);
+    ASSERT_NULL(ss_win_get_ptr(gone));
+    ASSERT_EQ(ss_win_get_x(gone), 0);
+
+    uint16_t a = ss_win_create(100, 10, 16, 16, 3);
+    uint16_t b = ss_win_create(200, 10, 16, 16, 4);
+    ASSERT_TRUE(a != 0 && a <= SS_MAX_WINDOWS);
+    ASSERT_TRUE(b != 0 && b <= SS_MAX_WINDOWS);
+    ASSERT_NEQ(a, b);
+    ASSERT_NEQ(a, keep);
+    ASSERT_NEQ(b, keep);
+    ASSERT_EQ(ss_win_get_x(a), 100);
+    ASSERT_EQ(ss_win_get_x(b), 200);
+    ASSERT_EQ(ss_win_hit_test(205, 15), b);
+    ASSERT_EQ(ss_win_hit_test(105, 15), a);
+}
+
+/* A caller-supplied table holds more windows than the built-in one, and
+ * the z walks, hit test and repaint only visit live windows. */
+TEST(win_storage_scales_past_builtin_table) {
+    static _Alignas(SSWindow) uint8_t big[SS_WIN_STORAGE_SIZE(300)];
+    int16_t rc;
+    SSGfxProfile p;
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_set_storage(big, sizeof(big));
+    ss_win_init();
+    for (int i = 0; i < 300; i++) {
+        ASSERT_EQ(ss_win_create((i % 30) * 24, (i / 30) * 24, 16, 16, 1),
+                  (uint16_t)(i + 1));
+    }
+    ASSERT_EQ(ss_win_create(0, 0, 8, 8, 1), 0);
+    rc = ss_win_set_title(300, "last");
+    ASSERT_EQ(rc, (int16_t)SS_OK);
+    ASSERT_EQ(ss_win_hit_test(29 * 24 + 3, 9 * 24 + 3), 300);
+    ASSERT_EQ(ss_win_hit_test(20, 3), -1);
+    ss_win_raise(1);
+    ASSERT_EQ(ss_win_top(), 1);
+    ASSERT_EQ(ss_win_below(1), 300);
+
+    ss_win_render_all();
+    ss_gfx_profile_reset();
+    ss_win_render_region(24, 24, 16, 16);           /* window 32 only */
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.windows_considered, 30u);           /* its band of rows */
+    ASSERT_EQ(p.windows_rendered, 1u);
+
+    ss_win_set_storage(NULL, 0);
+    ss_win_init();
+    ASSERT_NULL(ss_win_get_ptr(SS_MAX_WINDOWS + 1));
 }
 
 /* ---- hit testing ---- */
@@ -168,6 +318,61 @@ TEST(hit_test_skips_hidden) {
     ASSERT_EQ(ss_win_hit_test(50, 50), (int)a);
 }
 
+/* Reference: the highest z containing the point; on a tie the later slot,
+ * which is the one painted last. */
+static int hit_reference(int mx, int my) {
+    int best_z = -1, best_id = -1;
+    for (int id = 1; id <= SS_MAX_WINDOWS; id++) {
+        SSWindow* w = ss_win_get_ptr((uint16_t)id);
+        if (w == NULL || !(w->flags & SS_WIN_VISIBLE)) continue;
+        if (mx >= w->x && mx < w->x + (int)w->w &&
+            my >= w->y && my < w->y + (int)w->h && (int)w->z >= best_z) {
+            best_z = w->z;
+            best_id = w->id;
+        }
+    }
+    return best_id;
+}
+
+TEST(hit_test_matches_reference_across_block_edges) {
+    ss_gfx_set_mode(SS_CRTMOD_16);     /* the move below repaints */
+    ss_gfx_init();
+    ss_win_init();
+    /* Edges off the 8-pixel grid, overlaps, a z tie and a thin window. */
+    ss_win_create(13, 5, 50, 30, 1);
+    ss_win_create(40, 21, 37, 19, 3);
+    ss_win_create(60, 0, 3, 60, 2);
+    ss_win_create(20, 30, 30, 9, 3);
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 96; x++) ASSERT_EQ(ss_win_hit_test(x, y), hit_reference(x, y));
+    }
+
+    /* The index follows z, geometry and visibility changes. */
+    ss_win_set_z(1, 9);
+    ss_win_move(2, 5, 3);
+    ss_win_hide(3);
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 96; x++) ASSERT_EQ(ss_win_hit_test(x, y), hit_reference(x, y));
+    }
+    ASSERT_EQ(ss_win_hit_test(-1, 10), -1);
+}
+
+TEST(region_repaint_considers_only_windows_on_its_rows) {
+    SSGfxProfile p;
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    ss_win_create(10, 10, 100, 40, 1);
+    ss_win_create(10, 200, 100, 40, 2);
+    ss_win_create(300, 400, 100, 40, 3);
+    ss_win_render_all();
+    ss_gfx_profile_reset();
+    ss_win_render_region(200, 20, 50, 10);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.windows_considered, 1u);        /* rows 16..31: window 1 only */
+    ASSERT_EQ(p.windows_skipped_no_overlap, 1u);
+}
+
 /* ---- rendering (stub call counts) ---- */
 
 TEST(render_all_paints_visible_window) {
@@ -246,8 +451,286 @@ TEST(render_callback_receives_explicit_region_clip) {
     ASSERT_EQ(render_callback_clip.h, 6);
 }
 
+/* ---- exact visible regions ---- */
+
+TEST(render_all_writes_each_screen_pixel_once) {
+    SSGfxProfile p;
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    ss_win_create(10, 10, 200, 120, 1);
+    ss_win_create(60, 40, 200, 120, 2);
+    ss_win_create(100, 20, 80, 200, 3);
+    ss_gfx_profile_reset();
+    ss_win_render_all();
+    ss_gfx_profile_snapshot(&p);
+    /* Only the frame's four border corners are written twice per window. */
+    uint32_t area = (uint32_t)ss_current_mode->display_w * (uint32_t)ss_current_mode->display_h;
+    ASSERT_TRUE(p.gvram_words_written >= area);
+    ASSERT_TRUE(p.gvram_words_written <= area + 3 * 4);
+
+    /* Stacking is unchanged: the top window's border shows where it crosses
+     * the others, and the lowest window's border survives outside them. */
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    ASSERT_EQ(ss_draw_page[60 * stride + 100], 0);        /* win 3 left border */
+    ASSERT_EQ(ss_draw_page[60 * stride + 101], ss_palette_index(SS_PALETTE_WHITE));
+    ASSERT_EQ(ss_draw_page[10 * stride + 10], 0);         /* win 1 corner */
+    ASSERT_EQ(ss_draw_page[9 * stride + 10] == 0, 0);     /* desktop stipple */
+}
+
+TEST(render_skips_fully_occluded_window) {
+    SSGfxProfile p;
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    render_callback_calls = 0;
+    uint16_t lower = ss_win_create(20, 20, 30, 30, 1);
+    ss_win_create(10, 10, 60, 60, 2);
+    ss_win_set_render(lower, record_render_clip);
+    ss_gfx_profile_reset();
+    ss_win_render_all();
+    ss_win_render_region(25, 25, 10, 10);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(render_callback_calls, 0);
+    ASSERT_EQ(p.windows_skipped_occluded, 2u);
+
+    /* Raising it recomputes the regions; now it paints with a NULL clip. */
+    ss_win_set_z(lower, 3);
+    render_callback_saw_null = 0;
+    ss_win_render_all();
+    ASSERT_EQ(render_callback_calls, 1);
+    ASSERT_EQ(render_callback_saw_null, 1);
+}
+
+TEST(render_partly_covered_window_gets_visible_boxes_only) {
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    render_callback_calls = 0;
+    render_callback_saw_null = 0;
+    uint16_t lower = ss_win_create(0, 0, 40, 40, 1);
+    ss_win_create(0, 0, 40, 10, 2);          /* covers the top band */
+    ss_win_set_render(lower, record_render_clip);
+    ss_win_render_all();
+    ASSERT_EQ(render_callback_calls, 1);
+    ASSERT_EQ(render_callback_saw_null, 0);
+    ASSERT_EQ(render_callback_clip.x, 0);
+    ASSERT_EQ(render_callback_clip.y, 10);
+    ASSERT_EQ(render_callback_clip.w, 40);
+    ASSERT_EQ(render_callback_clip.h, 30);
+}
+
+/* ---- frame damage ---- */
+
+TEST(damage_merges_overlapping_and_keeps_distant_rects) {
+    SSGfxRect r[SS_DAMAGE_MAX];
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_win_init();
+    ss_win_add_damage(10, 10, 20, 20);
+    ss_win_add_damage(25, 10, 20, 20);      /* overlaps: merged */
+    ss_win_add_damage(300, 300, 10, 10);    /* far away: separate */
+    ASSERT_EQ(ss_win_pending_damage(r, SS_DAMAGE_MAX), 2);
+    ASSERT_EQ(r[0].x, 10);
+    ASSERT_EQ(r[0].w, 35);
+    ASSERT_EQ(r[0].h, 20);
+
+    /* Touching an L corner only would waste too much: kept apart. */
+    ss_win_add_damage(45, 30, 40, 40);
+    ASSERT_EQ(ss_win_pending_damage(r, SS_DAMAGE_MAX), 3);
+    /* Contained rects vanish into their container. */
+    ss_win_add_damage(12, 12, 4, 4);
+    ASSERT_EQ(ss_win_pending_damage(r, SS_DAMAGE_MAX), 3);
+}
+
+TEST(damage_signals_notified_task) {
+    static SSTask task;
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_win_init();
+    ss_win_notify(&task);
+    ss_win_add_damage(10, 10, 0, 20);       /* empty: nothing queued */
+    ASSERT_EQ(task.signals, 0);
+    ss_win_add_damage(10, 10, 20, 20);
+    ASSERT_EQ(task.signals, SS_SIG_DAMAGE);
+    ss_win_notify(NULL);
+}
+
+TEST(damage_list_full_forces_cheapest_merge) {
+    SSGfxRect r[SS_DAMAGE_MAX];
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_win_init();
+    for (int i = 0; i < SS_DAMAGE_MAX; i++) ss_win_add_damage(i * 60, 0, 10, 10);
+    ASSERT_EQ(ss_win_pending_damage(r, SS_DAMAGE_MAX), SS_DAMAGE_MAX);
+    ss_win_add_damage(62, 20, 10, 10);      /* nearest to the rect at x=60 */
+    ASSERT_EQ(ss_win_pending_damage(r, SS_DAMAGE_MAX), SS_DAMAGE_MAX);
+    int found = 0;
+    for (int i = 0; i < SS_DAMAGE_MAX; i++) {
+        if (r[i].x == 60 && r[i].y == 0 && r[i].w == 12 && r[i].h == 30) found = 1;
+    }
+    ASSERT_TRUE(found);
+}
+
+TEST(damage_flush_repaints_once_and_empties) {
+    SSGfxRect r[SS_DAMAGE_MAX];
+    SSGfxProfile p;
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    uint16_t a = ss_win_create(10, 10, 40, 40, 1);
+    uint16_t b = ss_win_create(200, 10, 40, 40, 2);
+    ss_win_render_all();
+    ASSERT_EQ(ss_win_pending_damage(r, SS_DAMAGE_MAX), 0);
+
+    /* A nearby move blits and queues the exposed strip; marking the window
+     * dirty adds its rect, and they merge so the frame repaints one rect. */
+    ss_win_move(a, 14, 12);
+    ss_win_mark_dirty(a);
+    ss_gfx_profile_reset();
+    ASSERT_EQ(ss_win_flush_damage(), 1);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.render_region_calls, 1u);
+    ASSERT_EQ(p.damage_flushes, 1u);
+    ASSERT_EQ(ss_win_pending_damage(r, SS_DAMAGE_MAX), 0);
+    ASSERT_EQ(ss_win_flush_damage(), 0);
+
+    /* Hiding exposes the desktop under the window at the next flush. */
+    ss_win_hide(b);
+    ss_win_flush_damage();
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    ASSERT_NEQ(ss_draw_page[10 * stride + 200], 0);
+}
+
 /* ---- invalid ids ---- */
 
+TEST(move_blits_and_repaints_only_exposed_strip) {
+    static uint16_t after_move[120][200];
+    SSGfxProfile p;
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    uint16_t a = ss_win_create(40, 40, 120, 60, 1);
+    ss_win_create(300, 300, 40, 40, 2);
+    ss_win_set_content_line(a, 0, "moved");
+    ss_win_render_all();
+
+    ss_gfx_profile_reset();
+    ss_win_move(a, 46, 43);
+    ss_win_flush_damage();
+    ss_gfx_profile_snapshot(&p);
+    /* The window's pixels are copied once; only old-minus-new (6 columns
+     * by 60 rows plus 3 rows by 114 columns) is recomposited. */
+    uint32_t exposed = 6u * 60u + 3u * 114u;
+    ASSERT_EQ(p.render_region_calls, 2u);
+    ASSERT_TRUE(p.gvram_words_written <= 120u * 60u + exposed + 16u);
+
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    for (int y = 0; y < 120; y++) {
+        for (int x = 0; x < 200; x++) {
+            after_move[y][x] = ss_draw_page[(uint32_t)(20 + y) * stride + 20 + x];
+        }
+    }
+    ss_win_render_all();
+    for (int y = 0; y < 120; y++) {
+        for (int x = 0; x < 200; x++) {
+            ASSERT_EQ(after_move[y][x], ss_draw_page[(uint32_t)(20 + y) * stride + 20 + x]);
+        }
+    }
+}
+
+TEST(move_of_covered_window_repaints_old_and_new_rects) {
+    SSGfxProfile p;
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    uint16_t a = ss_win_create(40, 40, 120, 60, 1);
+    ss_win_create(100, 50, 40, 40, 2);       /* overlaps a: no blit */
+    ss_win_render_all();
+
+    ss_gfx_profile_reset();
+    ss_win_move(a, 46, 43);
+    ss_gfx_profile_snapshot(&p);
+    ASSERT_EQ(p.gvram_words_written, 0u);
+    ss_win_flush_damage();
+    ASSERT_EQ(ss_draw_page[43 * (ss_current_mode->bytes_per_line / 2) + 46], 0);
+}
+
+/* ---- double-buffered presentation ---- */
+
+static int pages_match_on_screen(void) {
+    uint32_t stride = (uint32_t)ss_current_mode->bytes_per_line / 2;
+    for (int y = 0; y < ss_current_mode->display_h; y++) {
+        for (int x = 0; x < ss_current_mode->display_w; x++) {
+            uint32_t i = (uint32_t)y * stride + (uint32_t)x;
+            if (ss_current_mode->page0[i] != ss_current_mode->page1[i]) return 0;
+        }
+    }
+    return 1;
+}
+
+TEST(double_buffer_needs_two_pages) {
+    ss_gfx_set_mode(SS_CRTMOD_16);
+    ss_gfx_init();
+    ss_win_init();
+    ASSERT_EQ(ss_win_set_double_buffer(1), 0);
+    ASSERT_EQ(ss_win_present(), 0);
+    ASSERT_TRUE(ss_draw_page == ss_display_page);
+}
+
+TEST(double_buffer_keeps_both_pages_identical_to_full_render) {
+    ss_gfx_set_mode(SS_CRTMOD_8);
+    ss_gfx_init();
+    ss_win_init();
+    uint16_t a = ss_win_create(20, 20, 120, 60, 1);
+    uint16_t b = ss_win_create(200, 100, 120, 60, 2);
+    ss_win_render_all();
+    ASSERT_EQ(ss_win_set_double_buffer(1), 1);
+    ASSERT_TRUE(ss_display_page == ss_current_mode->page0);
+    ASSERT_TRUE(ss_draw_page == ss_current_mode->page1);
+
+    /* Drawing never lands on the displayed page; each frame flips. */
+    ss_win_present();
+    ss_win_move(a, 30, 26);
+    ASSERT_EQ(ss_win_present(), 1);
+    ASSERT_TRUE(ss_display_page == ss_current_mode->page1);
+    ss_win_set_z(a, 3);
+    ss_win_move(b, 180, 90);
+    ASSERT_EQ(ss_win_present(), 1);
+    ss_win_hide(b);
+    ASSERT_EQ(ss_win_present(), 1);
+    /* A frame without damage only catches the back page up. */
+    ASSERT_EQ(ss_win_present(), 0);
+    ASSERT_TRUE(pages_match_on_screen());
+
+    /* Both pages equal a fresh full render. */
+    ss_win_render_all();
+    ASSERT_TRUE(pages_match_on_screen());
+    ASSERT_EQ(ss_win_set_double_buffer(0), 0);
+    ASSERT_TRUE(ss_draw_page == ss_display_page);
+}
+
+TEST(double_buffer_repaints_union_of_two_frames_only) {
+    SSGfxProfile p;
+    ss_gfx_set_mode(SS_CRTMOD_8);
+    ss_gfx_init();
+    ss_win_init();
+    uint16_t a = ss_win_create(20, 20, 120, 60, 1);
+    ss_win_render_all();
+    ss_win_set_double_buffer(1);
+    ss_win_present();
+
+    ss_win_damage(a, 4, 20, 40, 10);
+    ss_gfx_profile_reset();
+    ASSERT_EQ(ss_win_present(), 1);
+    ss_win_damage(a, 60, 40, 30, 10);
+    ASSERT_EQ(ss_win_present(), 1);
+    ss_gfx_profile_snapshot(&p);
+    /* Frame 2 repaints its own rect plus frame 1's on the other page. */
+    ASSERT_EQ(p.render_all_calls, 0u);
+    ASSERT_EQ(p.render_region_calls, 3u);
+    ASSERT_TRUE(p.gvram_words_written < 3u * 40u * 10u + 64u);
+    ASSERT_EQ(ss_win_present(), 0);
+    ASSERT_TRUE(pages_match_on_screen());
+}
+
 TEST(getters_return_zero_for_invalid_id) {
     ss_win_init();
     ASSERT_EQ(ss_win_get_x(0), 0);
@@ -266,15 +749,34 @@ void run_window_tests(void) {
     RUN_TEST(win_move_updates_position_and_dirty);
     RUN_TEST(win_damage_sets_region);
     RUN_TEST(win_set_z_updates);
+    RUN_TEST(zlist_walks_visible_windows_in_paint_order);
+    RUN_TEST(raise_and_lower_renumber_when_z_runs_out);
     RUN_TEST(win_set_title_truncates_to_19);
     RUN_TEST(win_set_content_line_pads_to_width);
     RUN_TEST(win_set_content_line_ignores_out_of_range);
+    RUN_TEST(win_text_pool_covers_every_slot_and_is_returned_on_destroy);
+    RUN_TEST(win_stale_id_leaves_free_slot_alone);
+    RUN_TEST(win_storage_scales_past_builtin_table);
     RUN_TEST(hit_test_picks_topmost_at_point);
     RUN_TEST(hit_test_skips_hidden);
+    RUN_TEST(hit_test_matches_reference_across_block_edges);
+    RUN_TEST(region_repaint_considers_only_windows_on_its_rows);
     RUN_TEST(render_all_paints_visible_window);
     RUN_TEST(render_all_skips_hidden);
     RUN_TEST(render_region_clips_standard_frame_only);
     RUN_TEST(render_region_keeps_exposed_part_of_same_zmap_block);
     RUN_TEST(render_callback_receives_explicit_region_clip);
+    RUN_TEST(render_all_writes_each_screen_pixel_once);
+    RUN_TEST(render_skips_fully_occluded_window);
+    RUN_TEST(render_partly_covered_window_gets_visible_boxes_only);
+    RUN_TEST(damage_merges_overlapping_and_keeps_distant_rects);
+    RUN_TEST(damage_signals_notified_task);
+    RUN_TEST(damage_list_full_forces_cheapest_merge);
+    RUN_TEST(damage_flush_repaints_once_and_empties);
+    RUN_TEST(move_blits_and_repaints_only_exposed_strip);
+    RUN_TEST(move_of_covered_window_repaints_old_and_new_rects);
+    RUN_TEST(double_buffer_needs_two_pages);
+    RUN_TEST(double_buffer_keeps_both_pages_identical_to_full_render);
+    RUN_TEST(double_buffer_repaints_union_of_two_frames_only);
     RUN_TEST(getters_return_zero_for_invalid_id);
 }
@@ -144,6 +144,12 @@ classify() {
             printf 'covered\tpre\tx xdf\t\n' ;;
         ssos/os/win/window.c|ssos/os/win/win.h)
             printf 'covered\tcop pre\tx xdf\t\n' ;;
+        ssos/os/win/console.c|ssos/os/win/console.h)
+            printf 'covered\tcop pre\tx xdf\t\n' ;;
+        ssos/os/win/textgrid.c|ssos/os/win/textgrid.h)
+            printf 'covered\tcop pre\tx xdf\t\n' ;;
+        ssos/os/win/compositor.c|ssos/os/win/compositor.h)
+            printf 'covered\tcop pre\txdf\t\n' ;;
         ssos/os/kernel/cooperative/interrupts.s|ssos/os/kernel/preemptive/interrupts.s)
             local ir sched
             case "$f" in *cooperative*) sched="cop";; *) sched="pre";; esac
@@ -153,7 +159,23 @@ classify() {
             printf 'partial\tcop pre\tx xdf\t構造体レイアウト変更等は asm と整合要。変更内容によって実機必要\n' ;;
         ssos/os/kernel/work_queue.c|ssos/os/kernel/work_queue.h)
             printf 'covered\tcop pre\txdf\t\n' ;;
-        ssos/os/gfx/vram.c|ssos/os/gfx/gfx.h)
+        ssos/os/kernel/input.c|ssos/os/kernel/input.h)
+            printf 'covered\tcop pre\tx xdf\t\n' ;;
+        ssos/os/kernel/input_trace.c|ssos/os/kernel/input_trace.h)
+            printf 'covered\tcop pre\tx xdf\t\n' ;;
+        ssos/os/gfx/region.c|ssos/os/gfx/region.h)
+            printf 'covered\tcop pre\tx xdf\t\n' ;;
+        ssos/os/gfx/cursor.c|ssos/os/gfx/cursor.h)
+            printf 'partial\tcop pre\tx xdf\tスプライト/PCG レジスタ書込みは Native RAM でカバー。実スプライト表示は未検証\n' ;;
+        ssos/os/gfx/overlay.c|ssos/os/gfx/overlay.h)
+            printf 'partial\tcop pre\tx xdf\tテキストプレーン描画は Native RAM でカバー。実テキスト VRAM/ビデオコントローラは未検証\n' ;;
+        ssos/os/gfx/dlist.c|ssos/os/gfx/dlist.h)
+            printf 'covered\tcop pre\tx xdf\t\n' ;;
+        ssos/os/gfx/sprite.c)
+            printf 'uncovered\tcop pre\tx xdf\tIOCS スプライト初期化（SP_INIT/SP_ON/SP_OFF）\n' ;;
+        ssos/os/gfx/burst.s)
+            printf 'covered\tcop pre\tx xdf\t\n' ;;
+        ssos/os/gfx/vram.c|ssos/os/gfx/vram_kernels.h|ssos/os/gfx/gfx.h)
             printf 'partial\tcop pre\tx xdf\t描画画素は Native RAM framebuffer でカバー。実VRAM/CRTC/DMAC MMIOは未検証\n' ;;
         ssos/os/kernel/premain.c|ssos/os/kernel/cooperative/premain.c|ssos/os/kernel/preemptive/premain.c)
             printf 'uncovered\tcop pre\txdf\tIOCS/HW 初期化。.x(standalone)は独自経路\n' ;;
@@ -161,6 +183,8 @@ classify() {
             printf 'uncovered\tcop pre\txdf\tOS エントリ/リンカ（.xdf 専用）\n' ;;
         ssos/os/ipc/message.c|ssos/os/ipc/ipc.h)
             printf 'covered\tcop pre\txdf\t\n' ;;
+        ssos/os/app/scene.c|ssos/os/app/scene.h)
+            printf 'partial\tcop pre\tx xdf\tscene ループ/描画/ドラッグと IOCS 入力源は Native の fake IOCS とトレース再生でカバー。実 IOCS と V-DISP 待ちは未検証\n' ;;
         ssos/os/app/main.c)
             printf 'uncovered\tcop pre\txdf\tアプリ本体（.xdf 専用）\n' ;;
         ssos/boot/*)